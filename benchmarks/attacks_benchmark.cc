@@ -1,4 +1,10 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
 #include "benchmark/benchmark.h"
+#include "engine/attack_map.h"
 #include "engine/attacks.h"
 #include "engine/types.h"
 
@@ -74,6 +80,103 @@ BENCHMARK(BM_LookupAttacks<kBishop>);
 BENCHMARK(BM_LookupAttacks<kRook>);
 BENCHMARK(BM_LookupAttacks<kQueen>);
 
+// The sliders of one side on a board.
+struct Sliders {
+  Bitboard rooks;
+  Bitboard bishops;
+  Bitboard queens;
+  Bitboard occupied;
+};
+
+// Returns boards with two rooks, two bishops and a queen among 24 occupied
+// squares, as in a typical middlegame. The boards are the same from run to
+// run.
+const std::vector<Sliders>& GetSliders() {
+  static const std::vector<Sliders> kSliders = [] {
+    std::mt19937 engine(0);
+    std::uniform_int_distribution<int> dist(A8, H1);
+    const auto place = [&](Bitboard& pieces, Bitboard& occupied, int count) {
+      while (count > 0) {
+        const auto square = static_cast<Square>(dist(engine));
+        if (!occupied.Get(square)) {
+          pieces.Set(square);
+          occupied.Set(square);
+          --count;
+        }
+      }
+    };
+
+    std::vector<Sliders> sliders(1024);
+    for (Sliders& board : sliders) {
+      Bitboard others;
+      place(board.rooks, board.occupied, 2);
+      place(board.bishops, board.occupied, 2);
+      place(board.queens, board.occupied, 1);
+      place(others, board.occupied, 19);
+    }
+    return sliders;
+  }();
+  return kSliders;
+}
+
+void SetBoardsCounter(benchmark::State& state) {
+  state.counters["boards_per_second"] = benchmark::Counter(
+      static_cast<double>(GetSliders().size()),
+      benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// Looks up the attacks of each slider and combines them.
+void BM_SlidingAttackMapLookups(benchmark::State& state) {
+  for (auto _ : state) {
+    for (const Sliders& board : GetSliders()) {
+      Bitboard attacks;
+      for (Bitboard rooks = board.rooks; rooks;) {
+        attacks |= GenerateAttacks<kRook>(rooks.PopLeastSignificantBit(),
+                                          board.occupied);
+      }
+      for (Bitboard bishops = board.bishops; bishops;) {
+        attacks |= GenerateAttacks<kBishop>(bishops.PopLeastSignificantBit(),
+                                            board.occupied);
+      }
+      for (Bitboard queens = board.queens; queens;) {
+        attacks |= GenerateAttacks<kQueen>(queens.PopLeastSignificantBit(),
+                                           board.occupied);
+      }
+      benchmark::DoNotOptimize(attacks);
+    }
+  }
+  SetBoardsCounter(state);
+}
+
+// Fills all directions at once with Kogge-Stone fills.
+void BM_SlidingAttackMapFills(benchmark::State& state) {
+  for (auto _ : state) {
+    for (const Sliders& board : GetSliders()) {
+      benchmark::DoNotOptimize(GenerateSlidingAttackMap(
+          board.rooks | board.queens, board.bishops | board.queens,
+          board.occupied));
+    }
+  }
+  SetBoardsCounter(state);
+  state.SetLabel(std::string(internal::GetAttackMapSimdName()));
+}
+
+void BM_SlidingAttackMapFillsScalar(benchmark::State& state) {
+  for (auto _ : state) {
+    for (const Sliders& board : GetSliders()) {
+      benchmark::DoNotOptimize(internal::GenerateSlidingAttackMapScalar(
+          board.rooks | board.queens, board.bishops | board.queens,
+          board.occupied));
+    }
+  }
+  SetBoardsCounter(state);
+}
+
+// The attacks of all sliders of one side, one piece at a time and all at once:
+BENCHMARK(BM_SlidingAttackMapLookups);
+BENCHMARK(BM_SlidingAttackMapFills);
+BENCHMARK(BM_SlidingAttackMapFillsScalar);
+
 }  // namespace
 }  // namespace follychess
 
@@ -0,0 +1,119 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "engine/game.h"
+#include "engine/move_generator.h"
+#include "engine/position.h"
+#include "engine/scoped_move.h"
+#include "search/bench.h"
+#include "search/search.h"
+
+namespace follychess {
+namespace {
+
+constexpr std::size_t kNumPositions = 1'000;
+
+[[nodiscard]] std::vector<Move> GenerateLegalMoves(Position position) {
+  std::vector<Move> legal_moves;
+  for (Move move : GenerateMoves(position)) {
+    ScopedMove scoped_move(move, position);
+    if (!position.GetCheckers(~position.SideToMove())) {
+      legal_moves.push_back(move);
+    }
+  }
+  return legal_moves;
+}
+
+// Returns a batch of positions to analyze. They are derived from the bench
+// positions by short random playouts with a fixed seed, so that the batch is
+// the same from run to run.
+const std::vector<Game>& GetBatch() {
+  static const std::vector<Game> kBatch = [] {
+    std::mt19937 engine(0);
+    std::vector<Game> batch;
+    batch.reserve(kNumPositions);
+
+    const auto fens = GetBenchPositions();
+    for (std::size_t i = 0; i < kNumPositions; ++i) {
+      Game game(Position::FromFen(fens[i % fens.size()]).value());
+
+      const int plies = std::uniform_int_distribution<int>(1, 8)(engine);
+      for (int ply = 0; ply < plies; ++ply) {
+        const std::vector<Move> moves =
+            GenerateLegalMoves(game.GetPosition());
+        game.Do(moves[std::uniform_int_distribution<std::size_t>(
+            0, moves.size() - 1)(engine)]);
+
+        if (GenerateLegalMoves(game.GetPosition()).empty()) {
+          // Terminal positions cannot be analyzed, so step back to the
+          // previous one.
+          game.Undo();
+          break;
+        }
+      }
+      batch.push_back(game);
+    }
+    return batch;
+  }();
+  return kBatch;
+}
+
+void SetPositionsCounter(benchmark::State& state, std::int64_t nodes) {
+  state.counters["positions_per_second"] =
+      benchmark::Counter(static_cast<double>(kNumPositions),
+                         benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["nodes"] = static_cast<double>(nodes);
+}
+
+// Analyzes the batch with the one-shot Search(), which allocates and
+// initializes new tables for every position.
+void BM_AnalyzeBatchWithSearch(benchmark::State& state) {
+  const std::vector<Game>& batch = GetBatch();
+  const SearchOptions options = SearchOptions().SetDepth(state.range(0));
+
+  std::int64_t nodes = 0;
+  for (auto _ : state) {
+    nodes = 0;
+    for (const Game& game : batch) {
+      nodes += Search(game, options).stats.GetNodes();
+    }
+  }
+  SetPositionsCounter(state, nodes);
+}
+
+BENCHMARK(BM_AnalyzeBatchWithSearch)
+    ->DenseRange(/* start = */ 1, /* limit = */ 3, /* step = */ 1)
+    ->Unit(benchmark::kMillisecond);
+
+// Analyzes the batch with a single Searcher, whose tables stay allocated, and
+// partially filled, across positions.
+void BM_AnalyzeBatchWithSearcher(benchmark::State& state) {
+  const std::vector<Game>& batch = GetBatch();
+  const SearchOptions options = SearchOptions().SetDepth(state.range(0));
+  Searcher searcher;
+
+  std::int64_t nodes = 0;
+  for (auto _ : state) {
+    nodes = 0;
+    searcher.Clear();
+    for (const Game& game : batch) {
+      const SearchResult result = searcher.Search(game, options);
+      benchmark::DoNotOptimize(result.score);
+      nodes += result.stats.GetNodes();
+    }
+  }
+  SetPositionsCounter(state, nodes);
+}
+
+BENCHMARK(BM_AnalyzeBatchWithSearcher)
+    ->DenseRange(/* start = */ 1, /* limit = */ 3, /* step = */ 1)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace follychess
+
+BENCHMARK_MAIN();
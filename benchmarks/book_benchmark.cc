@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <random>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "engine/move_generator.h"
+#include "engine/position.h"
+#include "engine/scoped_move.h"
+#include "search/bench.h"
+#include "search/opening_book.h"
+
+namespace follychess {
+namespace {
+
+constexpr int kNumGames = 20'000;
+constexpr int kBookPlies = 16;
+
+[[nodiscard]] std::vector<Move> GenerateLegalMoves(Position position) {
+  std::vector<Move> legal_moves;
+  for (Move move : GenerateMoves(position)) {
+    ScopedMove scoped_move(move, position);
+    if (!position.GetCheckers(~position.SideToMove())) {
+      legal_moves.push_back(move);
+    }
+  }
+  return legal_moves;
+}
+
+struct Book {
+  std::unique_ptr<OpeningBook> book;
+
+  // The positions that have book moves.
+  std::vector<Position> positions;
+};
+
+// Returns a book of random games from the starting position. The games are
+// played with a fixed seed, so that the book is the same from run to run.
+// Like in real books, each move appears once per position, weighted by how
+// often it was played.
+const Book &GetBook() {
+  static const Book kBook = [] {
+    std::mt19937 engine(0);
+    std::map<std::pair<std::uint64_t, Move>, std::uint16_t> weights;
+    std::map<std::uint64_t, Position> positions;
+
+    for (int game = 0; game < kNumGames; ++game) {
+      Position position =
+          Position::FromFen(
+              "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1")
+              .value();
+      for (int ply = 0; ply < kBookPlies; ++ply) {
+        const std::vector<Move> moves = GenerateLegalMoves(position);
+        if (moves.empty()) {
+          break;
+        }
+        const Move move = moves[std::uniform_int_distribution<std::size_t>(
+            0, moves.size() - 1)(engine)];
+        const std::uint64_t key = GetPolyglotKey(position);
+        std::uint16_t &weight = weights[{key, move}];
+        weight = std::min<int>(weight + 1, UINT16_MAX);
+        positions.emplace(key, position);
+        position.Do(move);
+      }
+    }
+
+    std::vector<BookEntry> entries;
+    for (const auto &[key_and_move, weight] : weights) {
+      entries.push_back({
+          .key = key_and_move.first,
+          .move = key_and_move.second,
+          .weight = weight,
+      });
+    }
+
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "book_benchmark.bin")
+            .string();
+    std::ofstream(path, std::ios::binary) << SerializeBook(std::move(entries));
+    return Book{
+        .book = std::move(OpeningBook::Open(path).value()),
+        .positions = std::views::values(positions) |
+                     std::ranges::to<std::vector<Position>>(),
+    };
+  }();
+  return kBook;
+}
+
+void SetLookupsCounter(benchmark::State &state, std::size_t num_lookups) {
+  state.counters["entries"] =
+      static_cast<double>(GetBook().book->GetNumEntries());
+  state.counters["lookups_per_second"] =
+      benchmark::Counter(static_cast<double>(num_lookups),
+                         benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void BM_PolyglotKey(benchmark::State &state) {
+  const std::vector<Position> &positions = GetBook().positions;
+  for (auto _ : state) {
+    for (const Position &position : positions) {
+      benchmark::DoNotOptimize(GetPolyglotKey(position));
+    }
+  }
+  SetLookupsCounter(state, positions.size());
+}
+
+BENCHMARK(BM_PolyglotKey)->Unit(benchmark::kMillisecond);
+
+// Looks up positions from the games in the book, which all have moves.
+void BM_BookLookupHit(benchmark::State &state) {
+  const Book &book = GetBook();
+  std::uint64_t random = 0;
+  for (auto _ : state) {
+    for (const Position &position : book.positions) {
+      benchmark::DoNotOptimize(book.book->ChooseMove(position, random++));
+    }
+  }
+  SetLookupsCounter(state, book.positions.size());
+}
+
+BENCHMARK(BM_BookLookupHit)->Unit(benchmark::kMillisecond);
+
+// Looks up the bench positions, which are mostly past the opening and not in
+// the book, so that mainly the binary search is measured.
+void BM_BookLookupMiss(benchmark::State &state) {
+  const Book &book = GetBook();
+  std::vector<Position> positions;
+  for (std::string_view fen : GetBenchPositions()) {
+    positions.push_back(Position::FromFen(fen).value());
+  }
+
+  std::uint64_t random = 0;
+  for (auto _ : state) {
+    for (const Position &position : positions) {
+      benchmark::DoNotOptimize(book.book->ChooseMove(position, random++));
+    }
+  }
+  SetLookupsCounter(state, positions.size());
+}
+
+BENCHMARK(BM_BookLookupMiss)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace follychess
+
+BENCHMARK_MAIN();
@@ -0,0 +1,348 @@
+#include <array>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "engine/game.h"
+#include "engine/move_generator.h"
+#include "engine/position.h"
+#include "engine/scoped_move.h"
+#include "search/eval_cache.h"
+#include "search/evaluation.h"
+#include "search/nnue.h"
+#include "search/pawn_structure.h"
+
+namespace follychess {
+namespace {
+
+// Collects the leaves of the game tree up to `depth` plies in the order a
+// fixed-depth search would visit them.
+void CollectLeaves(std::size_t depth, Position& position,
+                   std::vector<Position>& leaves) {
+  if (depth == 0) {
+    leaves.push_back(position);
+    return;
+  }
+
+  for (const Move& move : GenerateMoves(position)) {
+    ScopedMove scoped_move(move, position);
+    if (position.GetCheckers(~position.SideToMove())) {
+      continue;
+    }
+    CollectLeaves(depth - 1, position, leaves);
+  }
+}
+
+std::vector<Position> CollectLeaves(std::string_view fen, std::size_t depth) {
+  auto position = Position::FromFen(fen);
+  CHECK_EQ(position.error_or(""), "");
+
+  std::vector<Position> leaves;
+  CollectLeaves(depth, position.value(), leaves);
+  return leaves;
+}
+
+void SetEvalCounter(benchmark::State& state, std::size_t evaluations) {
+  // Reports the time per evaluation and the evaluations per second.
+  state.counters["eval"] = benchmark::Counter(
+      static_cast<double>(evaluations),
+      benchmark::Counter::kIsIterationInvariantRate |
+          benchmark::Counter::kInvert);
+  state.counters["evals_per_second"] =
+      benchmark::Counter(static_cast<double>(evaluations),
+                         benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// The inference cost does not depend on the weights, so a random network is
+// as good as a trained one for benchmarking.
+const nnue::Network& GetNetwork() {
+  static const std::unique_ptr<nnue::Network> kNetwork =
+      nnue::Network::Random(1);
+  return *kNetwork;
+}
+
+// Walks the legal move tree and evaluates every leaf, the way a fixed-depth
+// search would. If `evaluator` is set, the NNUE accumulators are updated
+// along the way; otherwise the handcrafted evaluation is used. If
+// `eval_cache` is set, leaves that were already evaluated are served from it.
+// Returns the number of evaluations.
+std::size_t EvaluateTree(std::size_t depth, Game& game, PawnTable& pawn_table,
+                         nnue::Evaluator* evaluator,
+                         EvalCache* eval_cache = nullptr) {
+  const Position& position = game.GetPosition();
+  if (depth == 0) {
+    if (eval_cache) {
+      if (std::optional<int> score = eval_cache->Probe(position.GetKey())) {
+        benchmark::DoNotOptimize(*score);
+        return 1;
+      }
+    }
+
+    const int score = evaluator ? evaluator->Evaluate(position)
+                                : Evaluate(position, pawn_table);
+    if (eval_cache) {
+      eval_cache->Store(position.GetKey(), score);
+    }
+    benchmark::DoNotOptimize(score);
+    return 1;
+  }
+
+  std::size_t evaluations = 0;
+  for (const Move& move : GenerateMoves(position)) {
+    if (evaluator) {
+      evaluator->Push(position, move);
+    }
+    game.Do(move);
+    if (!position.GetCheckers(~position.SideToMove())) {
+      evaluations +=
+          EvaluateTree(depth - 1, game, pawn_table, evaluator, eval_cache);
+    }
+    game.Undo();
+    if (evaluator) {
+      evaluator->Pop();
+    }
+  }
+  return evaluations;
+}
+
+// A mix of opening, middlegame, and endgame positions.
+constexpr auto kPositions = std::to_array<std::string_view>({
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "2r3k1/pp3ppp/2n1b3/3p4/3P4/2N1BN2/PP3PPP/2R3K1 b - - 4 22",
+    "8/8/7r/K7/1R6/7k/8/N7 w - - 0 1",
+});
+
+std::vector<Position> GetPositions() {
+  std::vector<Position> positions;
+  for (std::string_view fen : kPositions) {
+    auto position = Position::FromFen(fen);
+    CHECK_EQ(position.error_or(""), "");
+    positions.push_back(position.value());
+  }
+  return positions;
+}
+
+void BM_EvaluatePositions(benchmark::State& state) {
+  const std::vector<Position> positions = GetPositions();
+  PawnTable pawn_table;
+  for (auto _ : state) {
+    for (const Position& position : positions) {
+      benchmark::DoNotOptimize(Evaluate(position, pawn_table));
+    }
+  }
+  SetEvalCounter(state, positions.size());
+}
+
+void BM_GetActivityScore(benchmark::State& state) {
+  const std::vector<Position> positions = GetPositions();
+  for (auto _ : state) {
+    for (const Position& position : positions) {
+      benchmark::DoNotOptimize(GetActivityScore(position));
+    }
+  }
+  SetEvalCounter(state, positions.size());
+}
+
+template <class... Args>
+void BM_Evaluate(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  const std::vector<Position> leaves =
+      CollectLeaves(std::get<0>(args_tuple), state.range(0));
+
+  // Measures the hit rate of a cold pawn table over one pass of the tree.
+  PawnTable pawn_table;
+  for (const Position& leaf : leaves) {
+    benchmark::DoNotOptimize(Evaluate(leaf, pawn_table));
+  }
+  state.counters["pawn_hit_rate"] =
+      static_cast<double>(pawn_table.GetHits()) / pawn_table.GetProbes();
+
+  for (auto _ : state) {
+    for (const Position& leaf : leaves) {
+      benchmark::DoNotOptimize(Evaluate(leaf, pawn_table));
+    }
+  }
+  SetEvalCounter(state, leaves.size());
+}
+
+template <class... Args>
+void BM_EvaluatePawnStructure(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  const std::vector<Position> leaves =
+      CollectLeaves(std::get<0>(args_tuple), state.range(0));
+
+  for (auto _ : state) {
+    for (const Position& leaf : leaves) {
+      benchmark::DoNotOptimize(EvaluatePawnStructure(leaf));
+    }
+  }
+  SetEvalCounter(state, leaves.size());
+}
+
+template <class... Args>
+void BM_ProbePawnTable(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  const std::vector<Position> leaves =
+      CollectLeaves(std::get<0>(args_tuple), state.range(0));
+
+  PawnTable pawn_table;
+  for (auto _ : state) {
+    for (const Position& leaf : leaves) {
+      benchmark::DoNotOptimize(pawn_table.Probe(leaf));
+    }
+  }
+  SetEvalCounter(state, leaves.size());
+}
+
+template <class... Args>
+void BM_EvaluateNnue(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  const std::vector<Position> leaves =
+      CollectLeaves(std::get<0>(args_tuple), state.range(0));
+
+  const nnue::Network& network = GetNetwork();
+  for (auto _ : state) {
+    for (const Position& leaf : leaves) {
+      benchmark::DoNotOptimize(nnue::Evaluate(network, leaf));
+    }
+  }
+  SetEvalCounter(state, leaves.size());
+  state.SetLabel(std::string(nnue::internal::GetSimdName()));
+}
+
+template <class... Args>
+void BM_EvaluateTree(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  auto position = Position::FromFen(std::get<0>(args_tuple));
+  CHECK_EQ(position.error_or(""), "");
+
+  Game game(position.value());
+  PawnTable pawn_table;
+  std::size_t evaluations = 0;
+  for (auto _ : state) {
+    evaluations =
+        EvaluateTree(state.range(0), game, pawn_table, /*evaluator=*/nullptr);
+  }
+  SetEvalCounter(state, evaluations);
+}
+
+template <class... Args>
+void BM_EvaluateTreeCached(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  auto position = Position::FromFen(std::get<0>(args_tuple));
+  CHECK_EQ(position.error_or(""), "");
+
+  Game game(position.value());
+  PawnTable pawn_table;
+  std::size_t evaluations = 0;
+  std::int64_t probes = 0;
+  std::int64_t hits = 0;
+  for (auto _ : state) {
+    // Starts every iteration with a cold cache, as a new search would.
+    state.PauseTiming();
+    EvalCache eval_cache;
+    state.ResumeTiming();
+
+    evaluations = EvaluateTree(state.range(0), game, pawn_table,
+                               /*evaluator=*/nullptr, &eval_cache);
+    probes += eval_cache.GetProbes();
+    hits += eval_cache.GetHits();
+  }
+  SetEvalCounter(state, evaluations);
+  state.counters["eval_cache_hit_rate"] = static_cast<double>(hits) / probes;
+}
+
+template <class... Args>
+void BM_EvaluateTreeNnue(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  auto position = Position::FromFen(std::get<0>(args_tuple));
+  CHECK_EQ(position.error_or(""), "");
+
+  Game game(position.value());
+  PawnTable pawn_table;
+  nnue::Evaluator evaluator(GetNetwork());
+  evaluator.Reset(position.value());
+  std::size_t evaluations = 0;
+  for (auto _ : state) {
+    evaluations = EvaluateTree(state.range(0), game, pawn_table, &evaluator);
+  }
+  SetEvalCounter(state, evaluations);
+  state.SetLabel(std::string(nnue::internal::GetSimdName()));
+}
+
+// The cost per evaluation over a fixed set of positions, and the share of it
+// spent on the mobility and king safety terms:
+BENCHMARK(BM_EvaluatePositions);
+BENCHMARK(BM_GetActivityScore);
+
+// Full evaluation, with pawn-structure terms served from the pawn table:
+BENCHMARK_CAPTURE(  //
+    BM_Evaluate, Starting,
+    R"(rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1)")
+    ->DenseRange(/* start = */ 1, /* limit = */ 4, /* step = */ 1);
+
+BENCHMARK_CAPTURE(
+    BM_Evaluate, Position2,
+    R"(r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1)")
+    ->DenseRange(/* start = */ 1, /* limit = */ 3, /* step = */ 1);
+
+BENCHMARK_CAPTURE(BM_Evaluate, Position3,
+                  R"(8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1)")
+    ->DenseRange(/* start = */ 1, /* limit = */ 5, /* step = */ 1);
+
+// Pawn-structure terms computed from scratch at every leaf:
+BENCHMARK_CAPTURE(
+    BM_EvaluatePawnStructure, Position2,
+    R"(r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1)")
+    ->Arg(3);
+
+// Pawn-structure terms served from the pawn table:
+BENCHMARK_CAPTURE(
+    BM_ProbePawnTable, Position2,
+    R"(r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1)")
+    ->Arg(3);
+
+// NNUE evaluation, refreshing the accumulators from scratch at every leaf:
+BENCHMARK_CAPTURE(
+    BM_EvaluateNnue, Position2,
+    R"(r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1)")
+    ->Arg(3);
+
+// Evaluation of every leaf of the tree, including the cost of walking it. For
+// NNUE, the accumulators are updated incrementally along the way:
+BENCHMARK_CAPTURE(
+    BM_EvaluateTree, Position2,
+    R"(r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1)")
+    ->Arg(3);
+
+BENCHMARK_CAPTURE(
+    BM_EvaluateTreeNnue, Position2,
+    R"(r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1)")
+    ->Arg(3);
+
+// Leaves served from the eval cache where possible. The HighTransposition
+// position from search_benchmark reaches the same leaves through many move
+// orders:
+BENCHMARK_CAPTURE(BM_EvaluateTree, HighTransposition,
+                  R"(8/8/7r/K7/1R6/7k/8/N7 w - - 0 1)")
+    ->DenseRange(/* start = */ 2, /* limit = */ 5, /* step = */ 1);
+
+BENCHMARK_CAPTURE(BM_EvaluateTreeCached, HighTransposition,
+                  R"(8/8/7r/K7/1R6/7k/8/N7 w - - 0 1)")
+    ->DenseRange(/* start = */ 2, /* limit = */ 5, /* step = */ 1);
+
+BENCHMARK_CAPTURE(
+    BM_EvaluateTreeCached, Position2,
+    R"(r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1)")
+    ->Arg(3);
+
+}  // namespace
+}  // namespace follychess
+
+BENCHMARK_MAIN();
@@ -1,9 +1,19 @@
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
 #include "benchmark/benchmark.h"
 #include "engine/attacks.h"
+#include "engine/move.h"
 #include "engine/move_generator.h"
+#include "engine/move_list.h"
+#include "engine/packed_position.h"
+#include "engine/perft.h"
 #include "engine/position.h"
 #include "engine/scoped_move.h"
 #include "engine/types.h"
+#include "search/move_ordering.h"
 
 namespace follychess {
 namespace {
@@ -50,6 +60,380 @@ BENCHMARK_CAPTURE(
     R"(rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8)")
     ->DenseRange(/* start = */ 1, /* limit = */ 5, /* step = */ 1);
 
+// Counts the leaf nodes below `position` by make/unmake, with the same move
+// list and legality test as the copy-make perft.
+template <Side Side>
+std::size_t CountLeafNodes(std::size_t depth, Position& position) {
+  MoveList moves;
+  GenerateMoves(position, moves);
+
+  std::size_t count = 0;
+  for (Move move : moves) {
+    const UndoInfo undo_info =
+        position.Do<Side>(move, position.GetPiece(move.GetFrom()));
+    if (!position.GetCheckers(Side)) {
+      count += depth == 1 ? 1 : CountLeafNodes<~Side>(depth - 1, position);
+    }
+    position.Undo<Side>(undo_info);
+  }
+  return count;
+}
+
+void SetNodesCounter(benchmark::State& state, std::size_t nodes) {
+  state.counters["nodes_per_second"] =
+      benchmark::Counter(static_cast<double>(nodes),
+                         benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template <class... Args>
+void BM_PerftMakeUnmake(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  Position position = Position::FromFen(std::get<0>(args_tuple)).value();
+  const std::size_t depth = state.range(0);
+
+  std::size_t nodes = 0;
+  for (auto _ : state) {
+    nodes = position.SideToMove() == kWhite
+                ? CountLeafNodes<kWhite>(depth, position)
+                : CountLeafNodes<kBlack>(depth, position);
+    benchmark::DoNotOptimize(nodes);
+  }
+  SetNodesCounter(state, nodes);
+}
+
+template <class... Args>
+void BM_PerftCopyMake(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  const Position position = Position::FromFen(std::get<0>(args_tuple)).value();
+  const std::size_t depth = state.range(0);
+
+  std::size_t nodes = 0;
+  for (auto _ : state) {
+    nodes = RunCopyMakePerft(depth, position);
+    benchmark::DoNotOptimize(nodes);
+  }
+  SetNodesCounter(state, nodes);
+}
+
+BENCHMARK_CAPTURE(
+    BM_PerftMakeUnmake, Starting,
+    R"(rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1)")
+    ->DenseRange(/* start = */ 3, /* limit = */ 5, /* step = */ 1);
+
+BENCHMARK_CAPTURE(
+    BM_PerftCopyMake, Starting,
+    R"(rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1)")
+    ->DenseRange(/* start = */ 3, /* limit = */ 5, /* step = */ 1);
+
+BENCHMARK_CAPTURE(
+    BM_PerftMakeUnmake, Position2,
+    R"(r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1)")
+    ->DenseRange(/* start = */ 2, /* limit = */ 4, /* step = */ 1);
+
+BENCHMARK_CAPTURE(
+    BM_PerftCopyMake, Position2,
+    R"(r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1)")
+    ->DenseRange(/* start = */ 2, /* limit = */ 4, /* step = */ 1);
+
+// Returns the positions of the tree below Position2, together with their
+// moves, for the benchmarks of single moves.
+const std::vector<std::pair<Position, std::vector<Move>>>& GetTreePositions() {
+  static const auto kPositions = [] {
+    std::vector<std::pair<Position, std::vector<Move>>> positions;
+    Position root =
+        Position::FromFen(
+            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - "
+            "0 1")
+            .value();
+    for (Move move : GenerateMoves(root)) {
+      ScopedMove scoped_move(move, root);
+      if (!root.GetCheckers(~root.SideToMove())) {
+        positions.emplace_back(root, GenerateMoves(root));
+      }
+    }
+    return positions;
+  }();
+  return kPositions;
+}
+
+void SetMovesCounter(benchmark::State& state) {
+  std::size_t num_moves = 0;
+  for (const auto& [position, moves] : GetTreePositions()) {
+    num_moves += moves.size();
+  }
+  state.counters["moves_per_second"] =
+      benchmark::Counter(static_cast<double>(num_moves),
+                         benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void BM_GivesCheck(benchmark::State& state) {
+  for (auto _ : state) {
+    for (const auto& [position, moves] : GetTreePositions()) {
+      for (Move move : moves) {
+        benchmark::DoNotOptimize(position.GivesCheck(move));
+      }
+    }
+  }
+  SetMovesCounter(state);
+}
+
+BENCHMARK(BM_GivesCheck);
+
+// The same test by making each move, which is what GivesCheck() replaces.
+void BM_MakeAndTestCheck(benchmark::State& state) {
+  std::vector<std::pair<Position, std::vector<Move>>> positions =
+      GetTreePositions();
+  for (auto _ : state) {
+    for (auto& [position, moves] : positions) {
+      for (Move move : moves) {
+        ScopedMove scoped_move(move, position);
+        benchmark::DoNotOptimize(position.GetCheckers(position.SideToMove()));
+      }
+    }
+  }
+  SetMovesCounter(state);
+}
+
+BENCHMARK(BM_MakeAndTestCheck);
+
+// Validates the moves of each position, as for a move from the transposition
+// table.
+void BM_IsPseudoLegal(benchmark::State& state) {
+  for (auto _ : state) {
+    for (const auto& [position, moves] : GetTreePositions()) {
+      for (Move move : moves) {
+        benchmark::DoNotOptimize(position.IsPseudoLegal(move));
+      }
+    }
+  }
+  SetMovesCounter(state);
+}
+
+BENCHMARK(BM_IsPseudoLegal);
+
+// The same validation by generating all moves, which is what IsPseudoLegal()
+// replaces.
+void BM_FindInGeneratedMoves(benchmark::State& state) {
+  for (auto _ : state) {
+    for (const auto& [position, moves] : GetTreePositions()) {
+      for (Move move : moves) {
+        MoveList generated;
+        GenerateMoves(position, generated);
+        benchmark::DoNotOptimize(std::ranges::find(generated, move));
+      }
+    }
+  }
+  SetMovesCounter(state);
+}
+
+BENCHMARK(BM_FindInGeneratedMoves);
+
+void BM_IsLegal(benchmark::State& state) {
+  for (auto _ : state) {
+    for (const auto& [position, moves] : GetTreePositions()) {
+      for (Move move : moves) {
+        benchmark::DoNotOptimize(position.IsLegal(move));
+      }
+    }
+  }
+  SetMovesCounter(state);
+}
+
+BENCHMARK(BM_IsLegal);
+
+// The same test by making each move, which is what IsLegal() replaces.
+void BM_MakeAndTestLegal(benchmark::State& state) {
+  std::vector<std::pair<Position, std::vector<Move>>> positions =
+      GetTreePositions();
+  for (auto _ : state) {
+    for (auto& [position, moves] : positions) {
+      for (Move move : moves) {
+        ScopedMove scoped_move(move, position);
+        benchmark::DoNotOptimize(
+            position.GetCheckers(~position.SideToMove()));
+      }
+    }
+  }
+  SetMovesCounter(state);
+}
+
+BENCHMARK(BM_MakeAndTestLegal);
+
+// Generates the quiet moves below Position2, where both sides can castle on
+// either side. Each position is copied, so that its cached attack map is
+// recomputed.
+void BM_GenerateQuietMoves(benchmark::State& state) {
+  MoveList moves;
+  for (auto _ : state) {
+    for (const auto& [tree_position, tree_moves] : GetTreePositions()) {
+      const Position position = tree_position;
+      moves.clear();
+      GenerateMoves<kQuiet>(position, moves);
+      benchmark::DoNotOptimize(moves.size());
+    }
+  }
+  SetMovesCounter(state);
+}
+
+BENCHMARK(BM_GenerateQuietMoves);
+
+void BM_GetAttackedSquares(benchmark::State& state) {
+  for (auto _ : state) {
+    for (const auto& [position, moves] : GetTreePositions()) {
+      // The side to move's attacks are not cached.
+      benchmark::DoNotOptimize(
+          position.GetAttackedSquares(position.SideToMove()));
+    }
+  }
+  state.counters["positions_per_second"] = benchmark::Counter(
+      static_cast<double>(GetTreePositions().size()),
+      benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK(BM_GetAttackedSquares);
+
+// Reports the time of one make and unmake of the moves below Position2.
+void SetTimePerMoveCounter(benchmark::State& state) {
+  std::size_t num_moves = 0;
+  for (const auto& [position, moves] : GetTreePositions()) {
+    num_moves += moves.size();
+  }
+  state.counters["time_per_move"] = benchmark::Counter(
+      static_cast<double>(num_moves),
+      benchmark::Counter::kIsIterationInvariantRate |
+          benchmark::Counter::kInvert);
+}
+
+void BM_DoUndo(benchmark::State& state) {
+  std::vector<std::pair<Position, std::vector<Move>>> positions =
+      GetTreePositions();
+  for (auto _ : state) {
+    for (auto& [position, moves] : positions) {
+      for (Move move : moves) {
+        const UndoInfo undo_info = position.Do(move);
+        benchmark::DoNotOptimize(position);
+        position.Undo(undo_info);
+      }
+    }
+  }
+  SetTimePerMoveCounter(state);
+}
+
+BENCHMARK(BM_DoUndo);
+
+// The same moves through Do<Side>() and Undo<Side>(), with the moving pieces
+// looked up ahead of time, as a caller that knows them would.
+template <Side Side>
+void DoUndoAll(Position& position, const std::vector<Move>& moves,
+               const std::vector<Piece>& pieces) {
+  for (std::size_t i = 0; i < moves.size(); ++i) {
+    const UndoInfo undo_info = position.Do<Side>(moves[i], pieces[i]);
+    benchmark::DoNotOptimize(position);
+    position.Undo<Side>(undo_info);
+  }
+}
+
+void BM_DoUndoSide(benchmark::State& state) {
+  std::vector<std::pair<Position, std::vector<Move>>> positions =
+      GetTreePositions();
+  std::vector<std::vector<Piece>> pieces;
+  for (const auto& [position, moves] : positions) {
+    pieces.emplace_back();
+    for (Move move : moves) {
+      pieces.back().push_back(position.GetPiece(move.GetFrom()));
+    }
+  }
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+      auto& [position, moves] = positions[i];
+      if (position.SideToMove() == kWhite) {
+        DoUndoAll<kWhite>(position, moves, pieces[i]);
+      } else {
+        DoUndoAll<kBlack>(position, moves, pieces[i]);
+      }
+    }
+  }
+  SetTimePerMoveCounter(state);
+}
+
+BENCHMARK(BM_DoUndoSide);
+
+// The same moves as extended moves, which carry the pieces that Do() would
+// otherwise look up.
+void BM_DoUndoExtended(benchmark::State& state) {
+  std::vector<std::pair<Position, std::vector<ExtendedMove>>> positions;
+  for (const auto& [position, moves] : GetTreePositions()) {
+    positions.emplace_back(position, std::vector<ExtendedMove>());
+    for (Move move : moves) {
+      positions.back().second.push_back(position.ExtendMove(move));
+    }
+  }
+
+  for (auto _ : state) {
+    for (auto& [position, moves] : positions) {
+      for (ExtendedMove move : moves) {
+        const UndoInfo undo_info = position.Do(move);
+        benchmark::DoNotOptimize(position);
+        position.Undo(undo_info);
+      }
+    }
+  }
+  SetTimePerMoveCounter(state);
+}
+
+BENCHMARK(BM_DoUndoExtended);
+
+// Copy-make of the same moves on packed positions.
+void BM_CopyMake(benchmark::State& state) {
+  std::vector<std::pair<PackedPosition, std::vector<Move>>> positions;
+  for (const auto& [position, moves] : GetTreePositions()) {
+    positions.emplace_back(PackedPosition(position), moves);
+  }
+
+  for (auto _ : state) {
+    for (const auto& [position, moves] : positions) {
+      for (Move move : moves) {
+        benchmark::DoNotOptimize(position.Do(move));
+      }
+    }
+  }
+  SetTimePerMoveCounter(state);
+}
+
+BENCHMARK(BM_CopyMake);
+
+// Generates and orders the moves below Position2, as the search does.
+void BM_GenerateAndOrderMoves(benchmark::State& state) {
+  MoveList moves;
+  for (auto _ : state) {
+    for (const auto& [position, tree_moves] : GetTreePositions()) {
+      moves.clear();
+      GenerateMoves(position, moves);
+      OrderMoves(position, moves);
+      benchmark::DoNotOptimize(moves.begin());
+    }
+  }
+  SetMovesCounter(state);
+}
+
+BENCHMARK(BM_GenerateAndOrderMoves);
+
+void BM_GenerateAndOrderExtendedMoves(benchmark::State& state) {
+  ExtendedMoveList moves;
+  for (auto _ : state) {
+    for (const auto& [position, tree_moves] : GetTreePositions()) {
+      moves.clear();
+      GenerateMoves(position, moves);
+      OrderMoves(moves);
+      benchmark::DoNotOptimize(moves.begin());
+    }
+  }
+  SetMovesCounter(state);
+}
+
+BENCHMARK(BM_GenerateAndOrderExtendedMoves);
+
 }  // namespace
 }  // namespace follychess
 
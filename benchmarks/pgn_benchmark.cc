@@ -0,0 +1,126 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "engine/move.h"
+#include "engine/move_generator.h"
+#include "engine/position.h"
+#include "engine/san.h"
+#include "tools/pgn.h"
+
+namespace follychess {
+namespace {
+
+constexpr int kNumGames = 2'000;
+constexpr int kMaxPlies = 120;
+
+struct PgnFile {
+  std::string path;
+  std::int64_t games = 0;
+  std::int64_t plies = 0;
+};
+
+// Returns a PGN file of random games from the starting position. The games
+// are played with a fixed seed, so that the file is the same from run to run.
+// Like in real databases, the games have tags, and some moves carry comments,
+// NAGs and variations, which the reader must skip.
+const PgnFile &GetPgnFile() {
+  static const PgnFile kFile = [] {
+    std::mt19937 engine(0);
+    PgnFile file{
+        .path = (std::filesystem::temp_directory_path() / "pgn_benchmark.pgn")
+                    .string(),
+    };
+    std::ofstream output(file.path);
+
+    for (int game = 0; game < kNumGames; ++game) {
+      output << std::format(
+          "[Event \"Benchmark\"]\n[Site \"?\"]\n[Date \"????.??.??\"]\n"
+          "[Round \"{}\"]\n[White \"White\"]\n[Black \"Black\"]\n"
+          "[Result \"*\"]\n\n",
+          game + 1);
+
+      Position position = Position::Starting();
+      for (int ply = 0; ply < kMaxPlies; ++ply) {
+        std::vector<Move> moves;
+        for (Move move : GenerateMoves(position)) {
+          if (position.IsLegal(move)) {
+            moves.push_back(move);
+          }
+        }
+        if (moves.empty()) {
+          break;
+        }
+        const Move move = moves[std::uniform_int_distribution<std::size_t>(
+            0, moves.size() - 1)(engine)];
+
+        if (ply % 2 == 0) {
+          output << std::format("{}. ", ply / 2 + 1);
+        }
+        output << ToSan(position, move) << ' ';
+        switch (ply % 16) {
+          case 5:
+            output << "{A comment.} ";
+            break;
+          case 9:
+            output << "$1 ";
+            break;
+          case 13:
+            output << std::format("({}{} {}) ", ply / 2 + 1,
+                                  ply % 2 == 0 ? "." : "...",
+                                  ToSan(position, moves.front()));
+            break;
+        }
+        position.Do(move);
+        ++file.plies;
+      }
+      output << "*\n\n";
+      ++file.games;
+    }
+    return file;
+  }();
+  return kFile;
+}
+
+// Reads the file on state.range(0) threads.
+void BM_ReadPgnFile(benchmark::State &state) {
+  const PgnFile &file = GetPgnFile();
+  const int threads = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    PgnStats stats = ReadPgnFile(file.path, threads).value();
+    if (stats.games != file.games || stats.plies != file.plies) {
+      state.SkipWithError(stats.error.c_str());
+      return;
+    }
+    benchmark::DoNotOptimize(stats);
+  }
+
+  state.SetBytesProcessed(
+      state.iterations() *
+      static_cast<std::int64_t>(std::filesystem::file_size(file.path)));
+  state.counters["games_per_second"] =
+      benchmark::Counter(static_cast<double>(file.games),
+                         benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["plies_per_second"] =
+      benchmark::Counter(static_cast<double>(file.plies),
+                         benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK(BM_ReadPgnFile)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace follychess
+
+BENCHMARK_MAIN();
@@ -14,9 +14,11 @@ void BM_Search(benchmark::State& state, Args&&... args) {
   CHECK_EQ(position.error_or(""), "");
   Game game(position.value());
 
+  std::int64_t nodes = 0;
   for (auto _ : state) {
-    Search(game, SearchOptions().SetDepth(depth));
+    nodes = Search(game, SearchOptions().SetDepth(depth)).stats.GetNodes();
   }
+  state.counters["nodes"] = static_cast<double>(nodes);
 }
 
 BENCHMARK_CAPTURE(  //
@@ -32,6 +34,44 @@ BENCHMARK_CAPTURE(BM_Search, HighTransposition,
                   R"(8/8/7r/K7/1R6/7k/8/N7 w - - 0 1)")
     ->DenseRange(/* start = */ 1, /* limit = */ 8, /* step = */ 1);
 
+// Measures the overhead of reporting the best `state.range(0)` lines compared
+// to a single line, at a fixed depth.
+template <class... Args>
+void BM_SearchMultiPv(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+
+  int multi_pv = state.range(0);
+  auto position = Position::FromFen(std::get<0>(args_tuple));
+  CHECK_EQ(position.error_or(""), "");
+  Game game(position.value());
+
+  std::int64_t nodes = 0;
+  for (auto _ : state) {
+    nodes = Search(game, SearchOptions().SetDepth(4).SetMultiPv(multi_pv))
+                .stats.GetNodes();
+  }
+  state.counters["nodes"] = static_cast<double>(nodes);
+}
+
+BENCHMARK_CAPTURE(  //
+    BM_SearchMultiPv, Starting,
+    R"(rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1)")
+    ->Arg(1)
+    ->Arg(3)
+    ->Arg(5);
+
+BENCHMARK_CAPTURE(BM_SearchMultiPv, Position3,
+                  R"(8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1)")
+    ->Arg(1)
+    ->Arg(3)
+    ->Arg(5);
+
+BENCHMARK_CAPTURE(BM_SearchMultiPv, HighTransposition,
+                  R"(8/8/7r/K7/1R6/7k/8/N7 w - - 0 1)")
+    ->Arg(1)
+    ->Arg(3)
+    ->Arg(5);
+
 }  // namespace
 }  // namespace follychess
 
@@ -2,10 +2,12 @@
 
 #include "absl/strings/str_join.h"
 #include "command.h"
+#include "commands/bench_command.h"
 #include "commands/display.h"
 #include "commands/isready_command.h"
 #include "commands/perft_command.h"
 #include "commands/position_command.h"
+#include "commands/setoption_command.h"
 #include "commands/uci_command.h"
 #include "engine/move_generator.h"
 #include "engine/position.h"
@@ -23,12 +25,18 @@ CommandDispatcher MakeCommandDispatcher(CommandState& state) {
   dispatcher.Add("position", std::move(position_commands));
 
   dispatcher.Add("perft", std::make_unique<PerftCommand>(game));
+  dispatcher.Add("bench", std::make_unique<BenchCommand>());
 
   dispatcher.Add("d", std::make_unique<Display>(game));
   dispatcher.Add("isready", std::make_unique<IsReady>());
   dispatcher.Add("uci", std::make_unique<Uci>());
-  dispatcher.Add("go", std::make_unique<Go>(game));
-  dispatcher.Add("quit", std::make_unique<Quit>());
+  dispatcher.Add("setoption",
+                 std::make_unique<SetOption>(state.options, state.search));
+  dispatcher.Add("go",
+                 std::make_unique<Go>(game, state.options, state.search));
+  dispatcher.Add("stop", std::make_unique<Stop>(state.search));
+  dispatcher.Add("ponderhit", std::make_unique<PonderHit>(state.search));
+  dispatcher.Add("quit", std::make_unique<Quit>(state.search));
 
   return dispatcher;
 }
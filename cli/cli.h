@@ -4,11 +4,18 @@
 #include "command.h"
 #include "engine/game.h"
 #include "engine/position.h"
+#include "engine_options.h"
+#include "search_thread.h"
 
 namespace follychess {
 
 struct CommandState {
   Game game;
+  EngineOptions options;
+
+  // Runs the searches started by `go`. It is destroyed first, so that a
+  // running search never outlives the game and the options.
+  SearchThread search;
 };
 
 CommandDispatcher MakeCommandDispatcher(CommandState& state);
@@ -3,12 +3,23 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+#include "engine/move.h"
+#include "engine/position.h"
+#include "search/nnue.h"
+#include "search/opening_book.h"
+
 namespace follychess {
 namespace {
 
 using ::testing::Eq;
 using ::testing::HasSubstr;
 using ::testing::IsEmpty;
+using ::testing::Lt;
+using ::testing::Not;
 using ::testing::StartsWith;
 
 std::size_t CountLeadingSpaces(std::string_view input) {
@@ -62,13 +73,25 @@ class CliTest : public ::testing::Test {
     std::cout.rdbuf(stream_.rdbuf());
   }
 
-  ~CliTest() override { std::cout.rdbuf(old_stdout_buffer_); }
+  ~CliTest() override {
+    state_.search.Stop();
+    state_.search.Wait();
+    std::cout.rdbuf(old_stdout_buffer_);
+  }
 
   std::string GetOutput() const { return stream_.str(); }
 
+  // Runs `command`. Searches run in the background, so unless a search runs
+  // until it is told otherwise, it is waited for.
   std::expected<void, std::string> Run(
       const std::vector<std::string_view>& command) {
-    return command_dispatcher_.Run(command);
+    auto result = command_dispatcher_.Run(command);
+    if (!command.empty() && command.front() == "go" &&
+        std::ranges::find(command, "ponder") == command.end() &&
+        std::ranges::find(command, "infinite") == command.end()) {
+      state_.search.Wait();
+    }
+    return result;
   }
 
  protected:
@@ -79,6 +102,16 @@ class CliTest : public ::testing::Test {
   std::streambuf* old_stdout_buffer_;
 };
 
+TEST_F(CliTest, Bench) {
+  ASSERT_THAT(Run({"bench", "1"}).error_or(""), IsEmpty());
+
+  EXPECT_THAT(GetOutput(), HasSubstr("Nodes searched  : "));
+  EXPECT_THAT(GetOutput(), HasSubstr("Nodes/second    : "));
+
+  EXPECT_THAT(Run({"bench", "1", "1", "16", "1"}).error_or(""),
+              StartsWith("Invalid bench command:"));
+}
+
 TEST_F(CliTest, Display) {
   ASSERT_THAT(Run({"d"}).error_or(""), IsEmpty());
 
@@ -103,11 +136,300 @@ TEST_F(CliTest, IsReady) {
   EXPECT_THAT(GetOutput(), Eq("readyok\n"));
 }
 
+TEST_F(CliTest, PositionMoves) {
+  ASSERT_THAT(Run({"position", "startpos", "moves", "e2e4", "e7e5", "g1f3"})
+                  .error_or(""),
+              IsEmpty());
+  EXPECT_THAT(state_.game.GetNumMoves(), Eq(3));
+  EXPECT_THAT(state_.game.GetMove(0),
+              Eq(Move(E2, E4, Move::kDoublePawnPush)));
+
+  // The game is extended.
+  ASSERT_THAT(Run({"position", "startpos", "moves", "e2e4", "e7e5", "g1f3",
+                   "b8c6", "f1c4", "g8f6", "e1g1"})
+                  .error_or(""),
+              IsEmpty());
+  EXPECT_THAT(state_.game.GetNumMoves(), Eq(7));
+  EXPECT_THAT(state_.game.GetMove(6), Eq(Move(E1, G1, Move::kKingCastle)));
+  EXPECT_THAT(
+      state_.game.GetPosition().GetKey(),
+      Eq(Position::FromFen("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/"
+                           "RNBQ1RK1 b kq - 5 4")
+             ->GetKey()));
+
+  // The game diverges after the first move.
+  ASSERT_THAT(Run({"position", "startpos", "moves", "e2e4", "c7c5"})
+                  .error_or(""),
+              IsEmpty());
+  EXPECT_THAT(
+      state_.game.GetPosition().GetKey(),
+      Eq(Position::FromFen(
+             "rnbqkbnr/pp1ppppp/8/2p5/4P3/8/PPPP1PPP/RNBQKBNR w KQkq c6 0 2")
+             ->GetKey()));
+
+  // A different starting position starts a new game.
+  ASSERT_THAT(Run({"position", "fen", "8/4P3/8/8/8/8/k7/4K3", "w", "-", "-",
+                   "0", "1", "moves", "e7e8n"})
+                  .error_or(""),
+              IsEmpty());
+  EXPECT_THAT(state_.game.GetNumMoves(), Eq(1));
+  EXPECT_THAT(state_.game.GetMove(0),
+              Eq(Move(E7, E8, Move::kKnightPromotion)));
+}
+
+TEST_F(CliTest, PositionErrors) {
+  EXPECT_THAT(Run({"position", "startpos", "moves", "e2e5"}).error_or(""),
+              Eq("Illegal move: e2e5"));
+  EXPECT_THAT(Run({"position", "startpos", "moves", "x"}).error_or(""),
+              Eq("Illegal move: x"));
+  EXPECT_THAT(Run({"position", "startpos", "e2e4"}).error_or(""),
+              StartsWith("Invalid remainder for position command:"));
+  EXPECT_THAT(Run({"position", "fen", "4k3/8/8/8/8/8/4r3/4K3", "w", "-", "-",
+                   "0", "1", "moves", "e1e2", "e8d8"})
+                  .error_or(""),
+              IsEmpty());
+  EXPECT_THAT(Run({"position", "fen", "4k3/8/8/8/8/8/3r4/4K3", "w", "-", "-",
+                   "0", "1", "moves", "e1e2"})
+                  .error_or(""),
+              StartsWith("Illegal move (cannot place own king in check):"));
+}
+
 TEST_F(CliTest, Go) {
   ASSERT_THAT(Run({"go", "depth", "5"}).error_or(""), IsEmpty());
 
   EXPECT_THAT(GetOutput(), HasSubstr("bestmove d2d4"));
 }
 
+TEST_F(CliTest, GoNodes) {
+  ASSERT_THAT(Run({"go", "nodes", "5000"}).error_or(""), IsEmpty());
+
+  EXPECT_THAT(GetOutput(), HasSubstr("info depth 1 multipv 1 score cp "));
+  EXPECT_THAT(GetOutput(), HasSubstr("bestmove "));
+}
+
+TEST_F(CliTest, GoMate) {
+  ASSERT_THAT(Run({"position", "fen", "6k1/5ppp/8/8/8/8/8/R5K1", "w", "-", "-",
+                   "0", "1"})
+                  .error_or(""),
+              IsEmpty());
+  ASSERT_THAT(Run({"go", "mate", "1"}).error_or(""), IsEmpty());
+
+  EXPECT_THAT(GetOutput(), HasSubstr("score mate 1 "));
+  EXPECT_THAT(GetOutput(), HasSubstr("bestmove a1a8"));
+}
+
+TEST_F(CliTest, GoCheckmated) {
+  ASSERT_THAT(Run({"position", "fen", "R5k1/5ppp/8/8/8/8/8/6K1", "b", "-", "-",
+                   "0", "1"})
+                  .error_or(""),
+              IsEmpty());
+  ASSERT_THAT(Run({"go", "depth", "3"}).error_or(""), IsEmpty());
+  state_.search.Wait();
+
+  EXPECT_THAT(GetOutput(), HasSubstr("bestmove 0000"));
+}
+
+TEST_F(CliTest, GoErrors) {
+  EXPECT_THAT(Run({"go", "depth"}).error_or(""),
+              StartsWith("Invalid go command:"));
+  EXPECT_THAT(Run({"go", "nodes", "x"}).error_or(""),
+              StartsWith("Invalid go command:"));
+  EXPECT_THAT(Run({"go", "mate", "0"}).error_or(""),
+              StartsWith("Invalid go command:"));
+}
+
+TEST_F(CliTest, GoMoveTime) {
+  const auto start = std::chrono::steady_clock::now();
+  ASSERT_THAT(Run({"go", "movetime", "100"}).error_or(""), IsEmpty());
+  EXPECT_THAT(std::chrono::steady_clock::now() - start,
+              Lt(std::chrono::seconds(5)));
+  EXPECT_THAT(GetOutput(), HasSubstr("bestmove "));
+
+  EXPECT_THAT(Run({"go", "movetime", "0"}).error_or(""),
+              StartsWith("Invalid go command:"));
+}
+
+TEST_F(CliTest, GoClock) {
+  ASSERT_THAT(Run({"go", "wtime", "3000", "btime", "3000", "winc", "0",
+                   "binc", "0"})
+                  .error_or(""),
+              IsEmpty());
+  EXPECT_THAT(GetOutput(), HasSubstr("bestmove "));
+}
+
+TEST_F(CliTest, GoInfinite) {
+  ASSERT_THAT(Run({"go", "infinite"}).error_or(""), IsEmpty());
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  ASSERT_THAT(Run({"stop"}).error_or(""), IsEmpty());
+  state_.search.Wait();
+  EXPECT_THAT(GetOutput(), HasSubstr("bestmove "));
+}
+
+TEST_F(CliTest, GoInfiniteHoldsBackTheBestMove) {
+  ASSERT_THAT(Run({"go", "infinite", "depth", "1"}).error_or(""), IsEmpty());
+
+  // The search completes right away, but waits for `stop`.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_THAT(GetOutput(), HasSubstr("info depth 1 "));
+  EXPECT_THAT(GetOutput(), Not(HasSubstr("bestmove ")));
+
+  ASSERT_THAT(Run({"stop"}).error_or(""), IsEmpty());
+  state_.search.Wait();
+  EXPECT_THAT(GetOutput(), HasSubstr("bestmove "));
+}
+
+TEST_F(CliTest, GoPonder) {
+  ASSERT_THAT(Run({"position", "startpos", "moves", "e2e4", "e7e5"})
+                  .error_or(""),
+              IsEmpty());
+  ASSERT_THAT(Run({"go", "ponder", "movetime", "100"}).error_or(""),
+              IsEmpty());
+
+  // The time limit only starts counting down on `ponderhit`.
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  const auto start = std::chrono::steady_clock::now();
+  ASSERT_THAT(Run({"ponderhit"}).error_or(""), IsEmpty());
+  state_.search.Wait();
+  EXPECT_THAT(std::chrono::steady_clock::now() - start,
+              Lt(std::chrono::seconds(5)));
+  EXPECT_THAT(GetOutput(), HasSubstr("bestmove "));
+  EXPECT_THAT(GetOutput(), HasSubstr(" ponder "));
+}
+
+TEST_F(CliTest, GoPonderHoldsBackTheBestMove) {
+  ASSERT_THAT(Run({"go", "ponder", "depth", "1"}).error_or(""), IsEmpty());
+
+  // The search completes right away, but waits for `stop` or `ponderhit`.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_THAT(GetOutput(), HasSubstr("info depth 1 "));
+  EXPECT_THAT(GetOutput(), Not(HasSubstr("bestmove ")));
+
+  ASSERT_THAT(Run({"stop"}).error_or(""), IsEmpty());
+  state_.search.Wait();
+  EXPECT_THAT(GetOutput(), HasSubstr("bestmove "));
+}
+
+TEST_F(CliTest, SetOptionEvalFile) {
+  const std::string path = ::testing::TempDir() + "/network.nnue";
+  std::ofstream(path, std::ios::binary)
+      << nnue::Network::Random(1)->Serialize();
+
+  ASSERT_THAT(
+      Run({"setoption", "name", "EvalFile", "value", path}).error_or(""),
+      IsEmpty());
+  ASSERT_THAT(state_.options.network, testing::NotNull());
+
+  ASSERT_THAT(Run({"go", "depth", "2"}).error_or(""), IsEmpty());
+  EXPECT_THAT(GetOutput(), HasSubstr("bestmove"));
+
+  ASSERT_THAT(
+      Run({"setoption", "name", "EvalFile", "value", "<empty>"}).error_or(""),
+      IsEmpty());
+  EXPECT_THAT(state_.options.network, testing::IsNull());
+}
+
+TEST_F(CliTest, SetOptionErrors) {
+  EXPECT_THAT(Run({"setoption"}).error_or(""),
+              Eq("Invalid setoption command: []"));
+  EXPECT_THAT(
+      Run({"setoption", "name", "Foo", "Bar", "value", "1"}).error_or(""),
+      Eq("Unknown option: Foo Bar"));
+  EXPECT_THAT(
+      Run({"setoption", "name", "evalfile", "value", "/does/not/exist"})
+          .error_or(""),
+      Eq("Unable to open network file: /does/not/exist"));
+}
+
+TEST_F(CliTest, SetOptionHash) {
+  ASSERT_THAT(Run({"setoption", "name", "Hash", "value", "1"}).error_or(""),
+              IsEmpty());
+  EXPECT_THAT(state_.options.hash_size_mb, Eq(1));
+
+  EXPECT_THAT(Run({"setoption", "name", "Hash", "value", "0"}).error_or(""),
+              Eq("Invalid Hash value: 0"));
+  EXPECT_THAT(Run({"setoption", "name", "Hash", "value", "x"}).error_or(""),
+              Eq("Invalid Hash value: x"));
+  EXPECT_THAT(state_.options.hash_size_mb, Eq(1));
+}
+
+TEST_F(CliTest, MultiPv) {
+  ASSERT_THAT(Run({"setoption", "name", "MultiPV", "value", "3"}).error_or(""),
+              IsEmpty());
+  ASSERT_THAT(Run({"go", "depth", "2"}).error_or(""), IsEmpty());
+
+  EXPECT_THAT(GetOutput(), HasSubstr("info depth 2 multipv 1 "));
+  EXPECT_THAT(GetOutput(), HasSubstr("info depth 2 multipv 2 "));
+  EXPECT_THAT(GetOutput(), HasSubstr("info depth 2 multipv 3 "));
+  EXPECT_THAT(GetOutput(), Not(HasSubstr("multipv 4")));
+
+  EXPECT_THAT(Run({"setoption", "name", "MultiPV", "value", "0"}).error_or(""),
+              Eq("Invalid MultiPV value: 0"));
+}
+
+TEST_F(CliTest, SetOptionSearchStats) {
+  ASSERT_THAT(
+      Run({"setoption", "name", "SearchStats", "value", "true"}).error_or(""),
+      IsEmpty());
+  ASSERT_THAT(Run({"go", "depth", "1"}).error_or(""), IsEmpty());
+
+  EXPECT_THAT(GetOutput(), HasSubstr("info string nodes "));
+  EXPECT_THAT(GetOutput(), HasSubstr("info string ply 1 nodes 20\n"));
+  EXPECT_THAT(GetOutput(), HasSubstr("info string depth 1 nodes 21 ebf "));
+  EXPECT_THAT(GetOutput(), HasSubstr(" hashfull "));
+
+  EXPECT_THAT(
+      Run({"setoption", "name", "SearchStats", "value", "maybe"}).error_or(""),
+      Eq("Invalid check option value: maybe"));
+}
+
+TEST_F(CliTest, SetOptionOwnBook) {
+  const std::string path = ::testing::TempDir() + "/cli_book.bin";
+  const Position start =
+      Position::FromFen(
+          "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1")
+          .value();
+  std::ofstream(path, std::ios::binary) << SerializeBook({
+      {.key = GetPolyglotKey(start), .move = Move(E2, E4), .weight = 1},
+  });
+
+  ASSERT_THAT(
+      Run({"setoption", "name", "BookFile", "value", path}).error_or(""),
+      IsEmpty());
+  ASSERT_THAT(state_.options.book, testing::NotNull());
+
+  // The book is only used once OwnBook is set.
+  ASSERT_THAT(Run({"go", "depth", "1"}).error_or(""), IsEmpty());
+  EXPECT_THAT(GetOutput(), HasSubstr("info depth 1 "));
+
+  ASSERT_THAT(
+      Run({"setoption", "name", "OwnBook", "value", "true"}).error_or(""),
+      IsEmpty());
+  stream_.str("");
+  ASSERT_THAT(Run({"go", "depth", "1"}).error_or(""), IsEmpty());
+  EXPECT_THAT(GetOutput(), Eq("bestmove e2e4\n"));
+
+  // Positions that are not in the book are searched.
+  ASSERT_THAT(Run({"position", "startpos", "moves", "d2d4"}).error_or(""),
+              IsEmpty());
+  stream_.str("");
+  ASSERT_THAT(Run({"go", "depth", "1"}).error_or(""), IsEmpty());
+  EXPECT_THAT(GetOutput(), HasSubstr("info depth 1 "));
+
+  EXPECT_THAT(
+      Run({"setoption", "name", "BookFile", "value", "/does/not/exist"})
+          .error_or(""),
+      HasSubstr("Unable to open file: "));
+
+  // A running search is stopped before the book is closed.
+  stream_.str("");
+  ASSERT_THAT(Run({"go", "infinite"}).error_or(""), IsEmpty());
+  ASSERT_THAT(
+      Run({"setoption", "name", "BookFile", "value", "<empty>"}).error_or(""),
+      IsEmpty());
+  EXPECT_THAT(GetOutput(), HasSubstr("bestmove "));
+  EXPECT_THAT(state_.options.book, testing::IsNull());
+}
+
 }  // namespace
 }  // namespace follychess
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef FOLLYCHESS_CLI_COMMANDS_BENCH_COMMAND_H_
+#define FOLLYCHESS_CLI_COMMANDS_BENCH_COMMAND_H_
+
+#include <format>
+#include <iostream>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cli/command.h"
+#include "search/bench.h"
+
+namespace follychess {
+
+// Handles `bench [depth] [threads] [hash]`, which searches a fixed set of
+// positions and reports the total node count, time and speed.
+class BenchCommand : public Command {
+ public:
+  ~BenchCommand() override = default;
+
+  std::expected<void, std::string> Run(
+      std::vector<std::string_view> args) override {
+    if (args.size() > 3) {
+      return std::unexpected(std::format("Invalid bench command: {}", args));
+    }
+
+    BenchOptions options;
+    if (args.size() > 0) {
+      options.depth = std::stoi(std::string(args[0]));
+    }
+    if (args.size() > 1) {
+      options.threads = std::stoi(std::string(args[1]));
+    }
+    if (args.size() > 2) {
+      options.hash_size_mb = std::stoul(std::string(args[2]));
+    }
+
+    std::println(std::cout, "{}", RunBench(options));
+    return {};
+  }
+};
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_CLI_COMMANDS_BENCH_COMMAND_H_
@@ -1,6 +1,10 @@
 #include "position_command.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <format>
+#include <optional>
+#include <vector>
 
 #include "engine/move.h"
 #include "engine/move_generator.h"
@@ -8,36 +12,70 @@
 namespace follychess {
 namespace {
 
-std::optional<Move> FindMove(std::string_view uci_move,
-                             const std::vector<Move> &moves) {
+// Returns true if `move` has the squares and promotion of `uci_move`. UCI moves
+// carry no flags, so they are matched on these alone.
+bool Matches(Move move, Move uci_move) {
+  return move.GetFrom() == uci_move.GetFrom() &&
+         move.GetTo() == uci_move.GetTo() &&
+         move.IsPromotion() == uci_move.IsPromotion() &&
+         (!move.IsPromotion() ||
+          move.GetPromotedPiece() == uci_move.GetPromotedPiece());
+}
+
+std::optional<Move> FindMove(Move uci_move, const std::vector<Move> &moves) {
   for (const Move &move : moves) {
-    if (std::format("{}", move) == uci_move) {
+    if (Matches(move, uci_move)) {
       return move;
     }
   }
   return std::nullopt;
 }
 
-std::expected<void, std::string> ApplyMoves(
-    const std::vector<std::string_view> &uci_moves, Game &game) {
-  if (uci_moves.empty()) {
-    return {};
-  }
-  if (uci_moves.front() != "moves") {
+// Sets `game` to `position` followed by `args`, which are either empty or
+// "moves" followed by UCI moves. GUIs resend the whole game before every
+// search, so the moves that `game` shares with the new move list are kept, and
+// only the remaining ones are made.
+std::expected<void, std::string> SetPosition(
+    const Position &position, const std::vector<std::string_view> &args,
+    Game &game) {
+  if (!args.empty() && args.front() != "moves") {
     return std::unexpected(
-        std::format("Invalid remainder for position command: {}", uci_moves));
+        std::format("Invalid remainder for position command: {}", args));
   }
 
-  for (int i = 1; i < uci_moves.size(); ++i) {
-    std::vector<Move> moves = GenerateMoves(game.GetPosition());
+  std::vector<Move> uci_moves;
+  for (std::size_t i = 1; i < args.size(); ++i) {
+    auto move = Move::FromUCI(args[i]);
+    if (!move.has_value()) {
+      return std::unexpected(std::format("Illegal move: {}", args[i]));
+    }
+    uci_moves.push_back(*move);
+  }
+
+  std::size_t num_shared = 0;
+  if (game.GetStartingPosition() == position) {
+    const std::size_t limit = std::min(game.GetNumMoves(), uci_moves.size());
+    while (num_shared < limit &&
+           Matches(game.GetMove(num_shared), uci_moves[num_shared])) {
+      ++num_shared;
+    }
+    while (game.GetNumMoves() > num_shared) {
+      game.Undo();
+    }
+  } else {
+    game = Game(position);
+  }
 
-    std::optional<Move> move = FindMove(uci_moves[i], moves);
+  for (std::size_t i = num_shared; i < uci_moves.size(); ++i) {
+    std::optional<Move> move =
+        FindMove(uci_moves[i], GenerateMoves(game.GetPosition()));
     if (!move) {
-      return std::unexpected(std::format("Illegal move: {}", uci_moves[i]));
+      return std::unexpected(std::format("Illegal move: {}", args[i + 1]));
     }
 
     game.Do(*move);
     if (game.GetPosition().GetCheckers(~game.GetPosition().SideToMove())) {
+      game.Undo();
       return std::unexpected(std::format(
           "Illegal move (cannot place own king in check): {}", *move));
     }
@@ -50,8 +88,7 @@ std::expected<void, std::string> ApplyMoves(
 
 std::expected<void, std::string> StartPos::Run(
     std::vector<std::string_view> args) {
-  game_ = Game(Position::Starting());
-  return ApplyMoves(args, game_);
+  return SetPosition(Position::Starting(), args, game_);
 }
 
 std::expected<void, std::string> FenPos::Run(
@@ -64,8 +101,11 @@ std::expected<void, std::string> FenPos::Run(
     return std::unexpected(result.error());
   }
 
-  game_ = Game(result.value());
-  return ApplyMoves({args.begin() + 6, args.end()}, game_);
+  return SetPosition(
+      result.value(),
+      {args.begin() + std::min(static_cast<std::size_t>(6), args.size()),
+       args.end()},
+      game_);
 }
 
 }  // namespace follychess
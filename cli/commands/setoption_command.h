@@ -0,0 +1,151 @@
+#ifndef FOLLYCHESS_CLI_COMMANDS_SETOPTION_COMMAND_H_
+#define FOLLYCHESS_CLI_COMMANDS_SETOPTION_COMMAND_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_join.h"
+#include "cli/command.h"
+#include "cli/engine_options.h"
+#include "cli/search_thread.h"
+#include "search/nnue.h"
+#include "search/opening_book.h"
+
+namespace follychess {
+
+// Handles `setoption name <id> [value <x>]`. Option names are
+// case-insensitive, as required by the UCI protocol.
+class SetOption : public Command {
+ public:
+  SetOption(EngineOptions &options, SearchThread &search)
+      : options_(options), search_(search) {}
+
+  ~SetOption() override = default;
+
+  std::expected<void, std::string> Run(
+      std::vector<std::string_view> args) override {
+    if (args.size() < 2 || args.front() != "name") {
+      return std::unexpected(
+          std::format("Invalid setoption command: {}", args));
+    }
+
+    auto value_it = std::ranges::find(args, "value");
+    const std::string name = absl::StrJoin(args.begin() + 1, value_it, " ");
+    const std::string value =
+        value_it == args.end() ? ""
+                               : absl::StrJoin(value_it + 1, args.end(), " ");
+
+    if (absl::EqualsIgnoreCase(name, "EvalFile")) {
+      return SetEvalFile(value);
+    }
+    if (absl::EqualsIgnoreCase(name, "Hash")) {
+      return SetHash(value);
+    }
+    if (absl::EqualsIgnoreCase(name, "MultiPV")) {
+      return SetMultiPv(value);
+    }
+    if (absl::EqualsIgnoreCase(name, "SearchStats")) {
+      return SetBool(value, options_.dump_stats);
+    }
+    if (absl::EqualsIgnoreCase(name, "Ponder")) {
+      // The GUI decides when to ponder with `go ponder`, so the value is only
+      // validated.
+      bool ponder;
+      return SetBool(value, ponder);
+    }
+    if (absl::EqualsIgnoreCase(name, "OwnBook")) {
+      return SetBool(value, options_.own_book);
+    }
+    if (absl::EqualsIgnoreCase(name, "BookFile")) {
+      return SetBookFile(value);
+    }
+    return std::unexpected(std::format("Unknown option: {}", name));
+  }
+
+ private:
+  // Loads the NNUE network from `path`. An empty path switches back to the
+  // handcrafted evaluation. The searcher is cleared first, so that none of its
+  // cached evaluations outlive the network that they came from.
+  std::expected<void, std::string> SetEvalFile(const std::string &path) {
+    if (path.empty() || path == "<empty>") {
+      search_.Clear();
+      options_.network.reset();
+      return {};
+    }
+
+    auto network = nnue::Network::FromFile(path);
+    if (!network.has_value()) {
+      return std::unexpected(network.error());
+    }
+    search_.Clear();
+    options_.network = std::move(network.value());
+    return {};
+  }
+
+  // Opens the Polyglot book at `path`. An empty path closes the book. As with
+  // the network, a running search is stopped before the book that it may use
+  // is destroyed.
+  std::expected<void, std::string> SetBookFile(const std::string &path) {
+    if (path.empty() || path == "<empty>") {
+      search_.Stop();
+      search_.Wait();
+      options_.book.reset();
+      return {};
+    }
+
+    auto book = OpeningBook::Open(path);
+    if (!book.has_value()) {
+      return std::unexpected(book.error());
+    }
+    search_.Stop();
+    search_.Wait();
+    options_.book = std::move(book.value());
+    return {};
+  }
+
+  std::expected<void, std::string> SetHash(const std::string &value) {
+    std::size_t hash_size_mb;
+    if (!absl::SimpleAtoi(value, &hash_size_mb) || hash_size_mb < 1 ||
+        hash_size_mb > kMaxHashSizeMb) {
+      return std::unexpected(std::format("Invalid Hash value: {}", value));
+    }
+    options_.hash_size_mb = hash_size_mb;
+    return {};
+  }
+
+  std::expected<void, std::string> SetMultiPv(const std::string &value) {
+    int multi_pv;
+    if (!absl::SimpleAtoi(value, &multi_pv) || multi_pv < 1 ||
+        multi_pv > kMaxMultiPv) {
+      return std::unexpected(std::format("Invalid MultiPV value: {}", value));
+    }
+    options_.multi_pv = multi_pv;
+    return {};
+  }
+
+  static std::expected<void, std::string> SetBool(const std::string &value,
+                                                  bool &option) {
+    if (absl::EqualsIgnoreCase(value, "true")) {
+      option = true;
+    } else if (absl::EqualsIgnoreCase(value, "false")) {
+      option = false;
+    } else {
+      return std::unexpected(
+          std::format("Invalid check option value: {}", value));
+    }
+    return {};
+  }
+
+  EngineOptions &options_;
+  SearchThread &search_;
+};
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_CLI_COMMANDS_SETOPTION_COMMAND_H_
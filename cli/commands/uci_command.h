@@ -1,11 +1,23 @@
 #ifndef FOLLYCHESS_CLI_COMMANDS_UCI_COMMAND_H_
 #define FOLLYCHESS_CLI_COMMANDS_UCI_COMMAND_H_
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <optional>
 #include <print>
+#include <random>
 
+#include "absl/strings/numbers.h"
 #include "cli/command.h"
+#include "cli/engine_options.h"
+#include "cli/search_thread.h"
+#include "engine/move.h"
+#include "engine/types.h"
 #include "search/search.h"
+#include "search/transposition.h"
 
 namespace follychess {
 
@@ -15,45 +27,207 @@ class Uci : public Command {
       std::vector<std::string_view> args) override {
     std::println(std::cout, "id name chessengine");
     std::println(std::cout, "id author Aryan Naraghi");
+    std::println(std::cout, "option name EvalFile type string default <empty>");
+    std::println(std::cout,
+                 "option name Hash type spin default {} min 1 max {}",
+                 TranspositionTable::kDefaultSizeMb, kMaxHashSizeMb);
+    std::println(std::cout,
+                 "option name MultiPV type spin default 1 min 1 max {}",
+                 kMaxMultiPv);
+    std::println(std::cout,
+                 "option name SearchStats type check default false");
+    std::println(std::cout, "option name Ponder type check default false");
+    std::println(std::cout, "option name OwnBook type check default false");
+    std::println(std::cout, "option name BookFile type string default <empty>");
     std::println(std::cout, "uciok");
     return {};
   }
 };
 
 class Quit : public Command {
+ public:
+  explicit Quit(SearchThread& search) : search_(search) {}
+
   std::expected<void, std::string> Run(
       std::vector<std::string_view> args) override {
+    search_.Stop();
+    search_.Wait();
     std::exit(0);
   }
+
+ private:
+  SearchThread& search_;
 };
 
 class Go : public Command {
  public:
-  explicit Go(Game& game) : game_(game) {}
+  Go(Game& game, const EngineOptions& options, SearchThread& search)
+      : game_(game), options_(options), search_(search) {}
 
   std::expected<void, std::string> Run(
       std::vector<std::string_view> args) override {
     constexpr static int kDefaultSearchDepth = 6;
-    int depth = kDefaultSearchDepth;
 
-    if (!args.empty()) {
-      if (args.front() == "depth") {
-        if (args.size() != 2) {
-          return std::unexpected(std::format("Invalid go command: {}", args));
-        }
+    SearchOptions options = SearchOptions()
+                                .SetDepth(kDefaultSearchDepth)
+                                .SetLogEveryN(1 << 10)
+                                .SetNetwork(options_.network.get())
+                                .SetMultiPv(options_.multi_pv)
+                                .SetHashSizeMb(options_.hash_size_mb)
+                                .SetDumpStats(options_.dump_stats);
+
+    // Without an explicit depth, node, mate and time limits are searched as
+    // deep as needed. So are searches that run until they are stopped.
+    std::optional<int> depth;
+    bool ponder = false;
+    bool unlimited = false;
+    std::optional<std::int64_t> move_time;
+    std::array<std::optional<std::int64_t>, kNumSides> times;
+    std::array<std::int64_t, kNumSides> increments = {0, 0};
+    std::int64_t moves_to_go = 0;
+
+    for (std::size_t i = 0; i < args.size(); ++i) {
+      const std::string_view arg = args[i];
+      if (arg == "ponder") {
+        ponder = true;
+        continue;
+      }
+      if (arg == "infinite") {
+        unlimited = true;
+        continue;
+      }
+      if (std::ranges::find(kValueParameters, arg) == kValueParameters.end()) {
+        // Other parameters, such as `searchmoves`, are not supported yet.
+        continue;
+      }
+
+      // The clock times can run out, but the limits must be positive.
+      const bool is_clock = arg == "wtime" || arg == "btime" ||
+                            arg == "winc" || arg == "binc";
+      std::int64_t value;
+      if (i + 1 == args.size() || !absl::SimpleAtoi(args[i + 1], &value) ||
+          (!is_clock && value <= 0)) {
+        return std::unexpected(std::format("Invalid go command: {}", args));
+      }
+      ++i;
+
+      if (arg == "depth") {
+        depth = static_cast<int>(
+            std::min<std::int64_t>(value, kMaxSearchDepth));
+      } else if (arg == "nodes") {
+        options.SetNodes(value).SetDepth(kMaxSearchDepth);
+      } else if (arg == "mate") {
+        const int mate = static_cast<int>(
+            std::min<std::int64_t>(value, kMaxSearchDepth / 2));
+        // A mate in N moves is detected at a depth of 2N plies, where the
+        // mated side is found to have no legal moves.
+        options.SetMate(mate).SetDepth(2 * mate);
+      } else if (arg == "movetime") {
+        move_time = value;
+      } else if (arg == "wtime" || arg == "btime") {
+        times[arg == "wtime" ? kWhite : kBlack] = value;
+      } else if (arg == "winc" || arg == "binc") {
+        increments[arg == "winc" ? kWhite : kBlack] = value;
+      } else {
+        moves_to_go = value;
+      }
+    }
 
-        depth = std::stoi(std::string(args.back()));
+    const Side side = game_.GetPosition().SideToMove();
+    if (!move_time && times[side]) {
+      move_time = AllocateTime(*times[side], increments[side], moves_to_go);
+    }
+    if (move_time) {
+      options.SetMoveTime(std::chrono::milliseconds(*move_time))
+          .SetDepth(kMaxSearchDepth);
+    }
+    if (ponder || unlimited) {
+      options.SetDepth(kMaxSearchDepth);
+    }
+    if (depth) {
+      options.SetDepth(*depth);
+    }
+
+    // A pondered move is the opponent's guess, so the book is only used on
+    // the engine's own turn. Infinite searches are analyses, which the book
+    // would end right away.
+    if (!ponder && !unlimited && options_.own_book && options_.book) {
+      if (std::optional<Move> move =
+              options_.book->ChooseMove(game_.GetPosition(), random_())) {
+        search_.Wait();
+        std::println(std::cout, "bestmove {}", *move);
+        return {};
       }
     }
 
-    Move move =
-        Search(game_, SearchOptions().SetDepth(depth).SetLogEveryN(1 << 10));
-    std::println(std::cout, "bestmove {}", move);
+    // UCI forbids reporting the best move of an infinite search before
+    // `stop`, even if it reaches its depth limit, just like when pondering.
+    search_.Start(game_, options, ponder || unlimited);
     return {};
   }
 
  private:
+  constexpr static std::array kValueParameters = {
+      std::string_view("depth"),     std::string_view("nodes"),
+      std::string_view("mate"),      std::string_view("movetime"),
+      std::string_view("wtime"),     std::string_view("btime"),
+      std::string_view("winc"),      std::string_view("binc"),
+      std::string_view("movestogo"),
+  };
+
+  // Returns the time to spend on the next move: an even share of the remaining
+  // time over the moves to go, plus most of the increment. A margin is kept
+  // for the communication with the GUI.
+  static std::int64_t AllocateTime(std::int64_t time, std::int64_t increment,
+                                   std::int64_t moves_to_go) {
+    constexpr static std::int64_t kDefaultMovesToGo = 30;
+    constexpr static std::int64_t kMoveOverheadMs = 50;
+
+    const std::int64_t moves =
+        moves_to_go > 0 ? moves_to_go : kDefaultMovesToGo;
+    const std::int64_t budget = time / moves + increment * 3 / 4;
+    return std::max<std::int64_t>(
+        1, std::min(budget, time - kMoveOverheadMs));
+  }
+
   Game& game_;
+  const EngineOptions& options_;
+  SearchThread& search_;
+
+  // Picks between the weighted book moves.
+  std::mt19937_64 random_{std::random_device{}()};
+};
+
+// Handles `stop`, which ends the running search. The search prints its best
+// move.
+class Stop : public Command {
+ public:
+  explicit Stop(SearchThread& search) : search_(search) {}
+
+  std::expected<void, std::string> Run(
+      std::vector<std::string_view> args) override {
+    search_.Stop();
+    return {};
+  }
+
+ private:
+  SearchThread& search_;
+};
+
+// Handles `ponderhit`, which tells a pondering search that the opponent played
+// the expected move. The search goes on, now under its time limit.
+class PonderHit : public Command {
+ public:
+  explicit PonderHit(SearchThread& search) : search_(search) {}
+
+  std::expected<void, std::string> Run(
+      std::vector<std::string_view> args) override {
+    search_.PonderHit();
+    return {};
+  }
+
+ private:
+  SearchThread& search_;
 };
 
 }  // namespace follychess
@@ -0,0 +1,44 @@
+#ifndef FOLLYCHESS_CLI_ENGINE_OPTIONS_H_
+#define FOLLYCHESS_CLI_ENGINE_OPTIONS_H_
+
+#include <cstddef>
+#include <memory>
+
+#include "search/nnue.h"
+#include "search/opening_book.h"
+#include "search/transposition.h"
+
+namespace follychess {
+
+// The largest transposition table size accepted by the Hash option.
+inline constexpr std::size_t kMaxHashSizeMb = 1 << 16;
+
+// The largest number of lines accepted by the MultiPV option.
+inline constexpr int kMaxMultiPv = 256;
+
+// The engine options that can be changed with `setoption`.
+struct EngineOptions {
+  // The network set by the EvalFile option, if any.
+  std::unique_ptr<nnue::Network> network;
+
+  // The transposition table size set by the Hash option, in megabytes.
+  std::size_t hash_size_mb = TranspositionTable::kDefaultSizeMb;
+
+  // Set by the SearchStats option. If true, `go` prints the search statistics
+  // when the search completes.
+  bool dump_stats = false;
+
+  // The number of best lines reported by `go`, set by the MultiPV option.
+  int multi_pv = 1;
+
+  // Set by the OwnBook option. If true, `go` plays moves from `book` without
+  // searching.
+  bool own_book = false;
+
+  // The opening book set by the BookFile option, if any.
+  std::unique_ptr<OpeningBook> book;
+};
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_CLI_ENGINE_OPTIONS_H_
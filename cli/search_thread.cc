@@ -0,0 +1,56 @@
+#include "cli/search_thread.h"
+
+#include <iostream>
+#include <print>
+
+#include "engine/game.h"
+#include "engine/move.h"
+#include "search/search.h"
+
+namespace follychess {
+
+SearchThread::~SearchThread() {
+  Stop();
+  Wait();
+}
+
+void SearchThread::Start(const Game &game, SearchOptions options,
+                         bool ponder) {
+  Wait();
+
+  searcher_.SetHashSizeMb(options.hash_size_mb);
+  control_.Reset(ponder);
+  options.SetControl(&control_);
+
+  thread_ = std::thread([this, game, options] {
+    const SearchResult result = searcher_.Search(game, options);
+    control_.WaitWhilePondering();
+
+    // The second move of the principal variation is the reply that the engine
+    // expects, and the one that the GUI asks it to ponder on. Without a legal
+    // move, UCI expects the null move.
+    if (result.best_move == Move()) {
+      std::println(std::cout, "bestmove 0000");
+    } else if (result.pv.size() >= 2) {
+      std::println(std::cout, "bestmove {} ponder {}", result.best_move,
+                   result.pv[1]);
+    } else {
+      std::println(std::cout, "bestmove {}", result.best_move);
+    }
+    std::cout.flush();
+  });
+}
+
+void SearchThread::Wait() {
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void SearchThread::Clear() {
+  Stop();
+  Wait();
+  searcher_.Clear();
+}
+
+}  // namespace follychess
@@ -0,0 +1,49 @@
+#ifndef FOLLYCHESS_CLI_SEARCH_THREAD_H_
+#define FOLLYCHESS_CLI_SEARCH_THREAD_H_
+
+#include <thread>
+
+#include "engine/game.h"
+#include "search/search.h"
+
+namespace follychess {
+
+// Runs searches in the background, so that the command loop keeps reading
+// commands such as `stop` and `ponderhit` while the engine thinks. The
+// searcher, and therefore its transposition table, is shared by all searches.
+class SearchThread {
+ public:
+  SearchThread() = default;
+
+  SearchThread(const SearchThread &) = delete;
+
+  SearchThread &operator=(const SearchThread &) = delete;
+
+  ~SearchThread();
+
+  // Searches `game` and prints the best move when the search completes. If
+  // `ponder` is true, the best move is held back until PonderHit() or Stop()
+  // is called, which is also how `go infinite` waits for `stop`. A running
+  // search is waited for first.
+  void Start(const Game &game, SearchOptions options, bool ponder);
+
+  void Stop() { control_.Stop(); }
+
+  void PonderHit() { control_.PonderHit(); }
+
+  // Blocks until the running search, if any, prints its best move.
+  void Wait();
+
+  // Stops the running search, if any, and clears the searcher's tables. This
+  // must be called before the network of an earlier search is destroyed.
+  void Clear();
+
+ private:
+  Searcher searcher_;
+  SearchControl control_;
+  std::thread thread_;
+};
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_CLI_SEARCH_THREAD_H_
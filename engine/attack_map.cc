@@ -0,0 +1,155 @@
+#include "engine/attack_map.h"
+
+#include <cstdint>
+#include <string_view>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "engine/bitboard.h"
+#include "engine/types.h"
+
+namespace follychess {
+namespace {
+
+// Shifts `board` by `steps` steps in direction D without masking the files,
+// which the fills below take care of.
+template <Direction D>
+constexpr Bitboard ShiftUnmasked(Bitboard board, int steps) {
+  if constexpr (D > 0) {
+    return board << D * steps;
+  } else {
+    return board >> -D * steps;
+  }
+}
+
+// Returns the squares that a step in direction D may land on without wrapping
+// around the board.
+template <Direction D>
+constexpr Bitboard GetNoWrapMask() {
+  if constexpr (D == kEast || D == kNorthEast || D == kSouthEast) {
+    return ~file::kA;
+  } else if constexpr (D == kWest || D == kNorthWest || D == kSouthWest) {
+    return ~file::kH;
+  } else {
+    return ~kEmptyBoard;
+  }
+}
+
+// Returns the squares that `sliders` attack in direction D. The generator set
+// grows by one, two and then four steps, each time only through squares that
+// are empty and do not wrap. The last step extends the fill onto the first
+// blocker.
+template <Direction D>
+constexpr Bitboard FillOccluded(Bitboard sliders, Bitboard empty) {
+  constexpr Bitboard kMask = GetNoWrapMask<D>();
+  empty &= kMask;
+  sliders |= empty & ShiftUnmasked<D>(sliders, 1);
+  empty &= ShiftUnmasked<D>(empty, 1);
+  sliders |= empty & ShiftUnmasked<D>(sliders, 2);
+  empty &= ShiftUnmasked<D>(empty, 2);
+  sliders |= empty & ShiftUnmasked<D>(sliders, 4);
+  return ShiftUnmasked<D>(sliders, 1) & kMask;
+}
+
+#if defined(__AVX2__)
+
+// Fills four directions at once. Each lane holds the sliders, the shift and
+// the no-wrap mask of one direction. `Left` selects whether the lanes shift
+// towards H1 or towards A8.
+template <bool Left>
+__m256i FillOccluded(__m256i sliders, __m256i empty, __m256i shift,
+                     __m256i mask) {
+  const auto shift_by = [](__m256i board, __m256i amount) {
+    return Left ? _mm256_sllv_epi64(board, amount)
+                : _mm256_srlv_epi64(board, amount);
+  };
+
+  empty = _mm256_and_si256(empty, mask);
+  sliders = _mm256_or_si256(sliders,
+                            _mm256_and_si256(empty, shift_by(sliders, shift)));
+  empty = _mm256_and_si256(empty, shift_by(empty, shift));
+
+  const __m256i shift2 = _mm256_add_epi64(shift, shift);
+  sliders = _mm256_or_si256(sliders,
+                            _mm256_and_si256(empty, shift_by(sliders, shift2)));
+  empty = _mm256_and_si256(empty, shift_by(empty, shift2));
+
+  const __m256i shift4 = _mm256_add_epi64(shift2, shift2);
+  sliders = _mm256_or_si256(sliders,
+                            _mm256_and_si256(empty, shift_by(sliders, shift4)));
+  return _mm256_and_si256(shift_by(sliders, shift), mask);
+}
+
+Bitboard GenerateSlidingAttackMapAvx2(Bitboard rooks, Bitboard bishops,
+                                      Bitboard occupied) {
+  constexpr auto kNotFileA = static_cast<long long>((~file::kA).Data());
+  constexpr auto kNotFileH = static_cast<long long>((~file::kH).Data());
+
+  const auto rooks_data = static_cast<long long>(rooks.Data());
+  const auto bishops_data = static_cast<long long>(bishops.Data());
+  const __m256i sliders =
+      _mm256_setr_epi64x(rooks_data, rooks_data, bishops_data, bishops_data);
+  const __m256i empty =
+      _mm256_set1_epi64x(static_cast<long long>((~occupied).Data()));
+
+  // South, east, south-east and south-west shift towards H1.
+  const __m256i left = FillOccluded</*Left=*/true>(
+      sliders, empty,
+      _mm256_setr_epi64x(kSouth, kEast, kSouthEast, kSouthWest),
+      _mm256_setr_epi64x(-1, kNotFileA, kNotFileA, kNotFileH));
+
+  // North, west, north-west and north-east shift towards A8.
+  const __m256i right = FillOccluded</*Left=*/false>(
+      sliders, empty,
+      _mm256_setr_epi64x(-kNorth, -kWest, -kNorthWest, -kNorthEast),
+      _mm256_setr_epi64x(-1, kNotFileH, kNotFileH, kNotFileA));
+
+  const __m256i attacks = _mm256_or_si256(left, right);
+  const __m128i half = _mm_or_si128(_mm256_castsi256_si128(attacks),
+                                    _mm256_extracti128_si256(attacks, 1));
+  return Bitboard(
+      static_cast<std::uint64_t>(_mm_cvtsi128_si64(half)) |
+      static_cast<std::uint64_t>(_mm_extract_epi64(half, 1)));
+}
+
+#endif
+
+}  // namespace
+
+Bitboard GenerateSlidingAttackMap(Bitboard rooks, Bitboard bishops,
+                                  Bitboard occupied) {
+#if defined(__AVX2__)
+  return GenerateSlidingAttackMapAvx2(rooks, bishops, occupied);
+#else
+  return internal::GenerateSlidingAttackMapScalar(rooks, bishops, occupied);
+#endif
+}
+
+namespace internal {
+
+Bitboard GenerateSlidingAttackMapScalar(Bitboard rooks, Bitboard bishops,
+                                        Bitboard occupied) {
+  const Bitboard empty = ~occupied;
+  return FillOccluded<kNorth>(rooks, empty) |
+         FillOccluded<kSouth>(rooks, empty) |
+         FillOccluded<kEast>(rooks, empty) |
+         FillOccluded<kWest>(rooks, empty) |
+         FillOccluded<kNorthEast>(bishops, empty) |
+         FillOccluded<kNorthWest>(bishops, empty) |
+         FillOccluded<kSouthEast>(bishops, empty) |
+         FillOccluded<kSouthWest>(bishops, empty);
+}
+
+std::string_view GetAttackMapSimdName() {
+#if defined(__AVX2__)
+  return "AVX2";
+#else
+  return "scalar";
+#endif
+}
+
+}  // namespace internal
+
+}  // namespace follychess
@@ -0,0 +1,37 @@
+#ifndef FOLLYCHESS_ENGINE_ATTACK_MAP_H_
+#define FOLLYCHESS_ENGINE_ATTACK_MAP_H_
+
+#include <string_view>
+
+#include "engine/bitboard.h"
+
+namespace follychess {
+
+// Returns the squares attacked by all of `rooks` and `bishops` at once, given
+// the `occupied` squares. Queens belong in both sets. Instead of looking up
+// each piece, the attacks are computed with Kogge-Stone occluded fills, which
+// flood every direction in three shift steps regardless of how many pieces
+// there are.
+//
+// With AVX2, the eight directions are filled four at a time, one per 64-bit
+// lane.
+[[nodiscard]] Bitboard GenerateSlidingAttackMap(Bitboard rooks,
+                                                Bitboard bishops,
+                                                Bitboard occupied);
+
+namespace internal {
+
+// The scalar version, which is always available so that it can be checked
+// against the SIMD version.
+[[nodiscard]] Bitboard GenerateSlidingAttackMapScalar(Bitboard rooks,
+                                                      Bitboard bishops,
+                                                      Bitboard occupied);
+
+// Returns the name of the instruction set used by GenerateSlidingAttackMap().
+[[nodiscard]] std::string_view GetAttackMapSimdName();
+
+}  // namespace internal
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_ENGINE_ATTACK_MAP_H_
@@ -0,0 +1,94 @@
+#include "engine/attack_map.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "engine/attacks.h"
+#include "engine/bitboard.h"
+#include "engine/testing.h"
+
+namespace follychess {
+namespace {
+
+using testing::Eq;
+
+// Returns the attacks of `rooks` and `bishops` by looking up each piece.
+Bitboard LookUpAttacks(Bitboard rooks, Bitboard bishops, Bitboard occupied) {
+  Bitboard attacks;
+  while (rooks) {
+    attacks |= GenerateAttacks<kRook>(rooks.PopLeastSignificantBit(), occupied);
+  }
+  while (bishops) {
+    attacks |=
+        GenerateAttacks<kBishop>(bishops.PopLeastSignificantBit(), occupied);
+  }
+  return attacks;
+}
+
+TEST(GenerateSlidingAttackMap, StopsAtBlockers) {
+  const Bitboard rooks("8: . . . . . . . ."
+                       "7: . . . . . . . ."
+                       "6: . . . . . . . ."
+                       "5: . . . . . . . ."
+                       "4: . . . . . . . ."
+                       "3: . . . . . . . ."
+                       "2: . . . . . . . ."
+                       "1: X . . . . . . ."
+                       "   a b c d e f g h");
+  const Bitboard bishops("8: . . . . . . . ."
+                         "7: . . . . . . . ."
+                         "6: . . . . . . . ."
+                         "5: . . . . . . . ."
+                         "4: . . . . X . . ."
+                         "3: . . . . . . . ."
+                         "2: . . . . . . . ."
+                         "1: . . . . . . . ."
+                         "   a b c d e f g h");
+  const Bitboard blockers("8: . . . . . . . ."
+                          "7: . . . . . . . ."
+                          "6: . . . . . . X ."
+                          "5: X . . . . . . ."
+                          "4: . . . . . . . ."
+                          "3: . . . . . . . ."
+                          "2: . . . . . . . ."
+                          "1: . . . X . . . ."
+                          "   a b c d e f g h");
+  const Bitboard occupied = rooks | bishops | blockers;
+
+  EXPECT_THAT(GenerateSlidingAttackMap(rooks, bishops, occupied),
+              EqualsBitboard("8: X . . . . . . ."
+                             "7: . X . . . . . ."
+                             "6: . . X . . . X ."
+                             "5: X . . X . X . ."
+                             "4: X . . . . . . ."
+                             "3: X . . X . X . ."
+                             "2: X . X . . . X ."
+                             "1: . X X X . . . X"
+                             "   a b c d e f g h"));
+}
+
+TEST(GenerateSlidingAttackMap, MatchesLookups) {
+  std::mt19937_64 engine(0);
+  for (int i = 0; i < 10'000; ++i) {
+    const Bitboard occupied(engine() & engine());
+    const Bitboard rooks(occupied.Data() & engine() & engine());
+    const Bitboard bishops(occupied.Data() & engine() & engine());
+
+    const Bitboard expected = LookUpAttacks(rooks, bishops, occupied);
+    ASSERT_THAT(GenerateSlidingAttackMap(rooks, bishops, occupied),
+                EqualsBitboard(expected));
+    ASSERT_THAT(
+        internal::GenerateSlidingAttackMapScalar(rooks, bishops, occupied),
+        EqualsBitboard(expected));
+  }
+}
+
+TEST(GenerateSlidingAttackMap, EmptyBoard) {
+  EXPECT_THAT(GenerateSlidingAttackMap(kEmptyBoard, kEmptyBoard, kEmptyBoard),
+              Eq(kEmptyBoard));
+}
+
+}  // namespace
+}  // namespace follychess
@@ -0,0 +1,78 @@
+#ifndef FOLLYCHESS_ENGINE_ATTACKERS_H_
+#define FOLLYCHESS_ENGINE_ATTACKERS_H_
+
+#include "engine/attack_map.h"
+#include "engine/attacks.h"
+#include "engine/bitboard.h"
+#include "engine/types.h"
+
+namespace follychess {
+
+// Attack queries over the pieces of a board, which may be any type with a
+// `GetPieces(Side, Piece)` method. Position and PackedPosition share them.
+
+// Returns the pieces of `by` that would attack `to` if `occupied` were the
+// occupied squares. Pieces off `occupied` are ignored.
+template <typename Board>
+[[nodiscard]] Bitboard FindAttackers(const Board &board, Square to, Side by,
+                                     Bitboard occupied) {
+  const Bitboard queens = board.GetPieces(by, kQueen);
+  Bitboard attackers = GetPawnAttacks(to, ~by) & board.GetPieces(by, kPawn);
+  attackers |=
+      GenerateAttacks<kKnight>(to, occupied) & board.GetPieces(by, kKnight);
+  attackers |=
+      GenerateAttacks<kKing>(to, occupied) & board.GetPieces(by, kKing);
+  attackers |= GenerateAttacks<kRook>(to, occupied) &
+               (board.GetPieces(by, kRook) | queens);
+  attackers |= GenerateAttacks<kBishop>(to, occupied) &
+               (board.GetPieces(by, kBishop) | queens);
+  return attackers & occupied;
+}
+
+// Returns the squares that the pieces of `by` attack in one pass over the
+// pieces. The enemy king does not block sliders, so that the squares behind
+// it on a checking line count as attacked.
+template <typename Board>
+[[nodiscard]] Bitboard FindAttackedSquares(const Board &board, Side by) {
+  const Bitboard occupied = board.GetPieces() & ~board.GetPieces(~by, kKing);
+
+  // All pawns attack at once by shifting the pawn bitboard.
+  const Bitboard pawns = board.GetPieces(by, kPawn);
+  Bitboard attacked =
+      by == kWhite ? pawns.Shift<kNorthEast>() | pawns.Shift<kNorthWest>()
+                   : pawns.Shift<kSouthEast>() | pawns.Shift<kSouthWest>();
+
+  Bitboard knights = board.GetPieces(by, kKnight);
+  while (knights) {
+    attacked |=
+        GenerateAttacks<kKnight>(knights.PopLeastSignificantBit(), occupied);
+  }
+
+  const Bitboard queens = board.GetPieces(by, kQueen);
+  const Bitboard diagonal = board.GetPieces(by, kBishop) | queens;
+  const Bitboard straight = board.GetPieces(by, kRook) | queens;
+#if defined(__AVX2__)
+  // With AVX2, filling all directions at once beats the magic lookups. The
+  // scalar fills do not, so other builds look up one piece at a time.
+  attacked |= GenerateSlidingAttackMap(straight, diagonal, occupied);
+#else
+  for (Bitboard sliders = diagonal; sliders;) {
+    attacked |=
+        GenerateAttacks<kBishop>(sliders.PopLeastSignificantBit(), occupied);
+  }
+  for (Bitboard sliders = straight; sliders;) {
+    attacked |=
+        GenerateAttacks<kRook>(sliders.PopLeastSignificantBit(), occupied);
+  }
+#endif
+
+  Bitboard king = board.GetPieces(by, kKing);
+  while (king) {
+    attacked |= GenerateAttacks<kKing>(king.PopLeastSignificantBit(), occupied);
+  }
+  return attacked;
+}
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_ENGINE_ATTACKERS_H_
@@ -0,0 +1,69 @@
+#include "engine/cuckoo.h"
+
+#include <cstdint>
+#include <utility>
+
+#include "absl/log/check.h"
+#include "engine/attacks.h"
+#include "engine/bitboard.h"
+#include "engine/move.h"
+#include "engine/types.h"
+#include "engine/zobrist.h"
+
+namespace follychess {
+namespace {
+
+template <Piece Piece>
+void InsertMoves(std::size_t &count, auto insert) {
+  for (int side = kWhite; side <= kBlack; ++side) {
+    for (int from = 0; from < kNumSquares; ++from) {
+      Bitboard targets =
+          GenerateAttacks<Piece>(static_cast<Square>(from), kEmptyBoard);
+      while (targets) {
+        const Square to = targets.PopLeastSignificantBit();
+        if (to <= from) {
+          continue;
+        }
+        const std::uint64_t key = kZobristKeys.elements[from][Piece][side] ^
+                                  kZobristKeys.elements[to][Piece][side] ^
+                                  kZobristKeys.black_to_move;
+        insert(key, Move(static_cast<Square>(from), to));
+        ++count;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+CuckooTable::CuckooTable() {
+  std::size_t count = 0;
+  auto insert = [this](std::uint64_t key, Move move) { Insert(key, move); };
+  InsertMoves<kKnight>(count, insert);
+  InsertMoves<kBishop>(count, insert);
+  InsertMoves<kRook>(count, insert);
+  InsertMoves<kQueen>(count, insert);
+  InsertMoves<kKing>(count, insert);
+  CHECK_EQ(count, kNumMoves);
+}
+
+void CuckooTable::Insert(std::uint64_t key, Move move) {
+  // Each entry is either at its first or its second index. An entry that is
+  // displaced moves to its other index, possibly displacing another one.
+  std::size_t i = GetFirstIndex(key);
+  while (true) {
+    std::swap(keys_[i], key);
+    std::swap(moves_[i], move);
+    if (move == Move()) {
+      return;
+    }
+    i = i == GetFirstIndex(key) ? GetSecondIndex(key) : GetFirstIndex(key);
+  }
+}
+
+const CuckooTable &GetCuckooTable() {
+  static const CuckooTable kTable;
+  return kTable;
+}
+
+}  // namespace follychess
@@ -0,0 +1,61 @@
+#ifndef FOLLYCHESS_ENGINE_CUCKOO_H_
+#define FOLLYCHESS_ENGINE_CUCKOO_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "engine/move.h"
+
+namespace follychess {
+
+// Cuckoo hash tables of the reversible moves, i.e., the moves of every
+// non-pawn piece between two squares, keyed by the Zobrist key difference
+// that the move makes. They detect in constant time whether two positions are
+// one reversible move apart. See Marcel van Kervinck's "The cuckoo algorithm
+// for repetition detection".
+class CuckooTable {
+ public:
+  static constexpr std::size_t kSize = 1 << 13;
+
+  // The number of reversible moves, counting both sides.
+  static constexpr std::size_t kNumMoves = 3668;
+
+  // Returns the move whose key difference is `key`, if any. The move goes from
+  // the lower to the higher square, and can be played in either direction.
+  [[nodiscard]] std::optional<Move> Find(std::uint64_t key) const {
+    if (std::size_t i = GetFirstIndex(key); keys_[i] == key) {
+      return moves_[i];
+    }
+    if (std::size_t i = GetSecondIndex(key); keys_[i] == key) {
+      return moves_[i];
+    }
+    return std::nullopt;
+  }
+
+ private:
+  CuckooTable();
+
+  static constexpr std::size_t GetFirstIndex(std::uint64_t key) {
+    return key & (kSize - 1);
+  }
+
+  static constexpr std::size_t GetSecondIndex(std::uint64_t key) {
+    return (key >> 16) & (kSize - 1);
+  }
+
+  void Insert(std::uint64_t key, Move move);
+
+  std::array<std::uint64_t, kSize> keys_{};
+  std::array<Move, kSize> moves_{};
+
+  friend const CuckooTable& GetCuckooTable();
+};
+
+// Returns the table, which is built on first use from the Zobrist keys.
+const CuckooTable& GetCuckooTable();
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_ENGINE_CUCKOO_H_
@@ -0,0 +1,52 @@
+#include "engine/cuckoo.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <optional>
+
+#include "engine/testing.h"
+#include "engine/zobrist.h"
+
+namespace follychess {
+namespace {
+
+using ::testing::Eq;
+using ::testing::Optional;
+
+std::uint64_t GetMoveKey(Square from, Square to, Piece piece, Side side) {
+  return kZobristKeys.elements[from][piece][side] ^
+         kZobristKeys.elements[to][piece][side] ^ kZobristKeys.black_to_move;
+}
+
+TEST(CuckooTable, FindsReversibleMoves) {
+  const CuckooTable& table = GetCuckooTable();
+  // The moves go from the lower square, i.e., the one closer to A8.
+  EXPECT_THAT(table.Find(GetMoveKey(G1, F3, kKnight, kWhite)),
+              Optional(Move(F3, G1)));
+  EXPECT_THAT(table.Find(GetMoveKey(F6, G8, kKnight, kBlack)),
+              Optional(Move(G8, F6)));
+  EXPECT_THAT(table.Find(GetMoveKey(A8, H1, kQueen, kBlack)),
+              Optional(Move(A8, H1)));
+  EXPECT_THAT(table.Find(GetMoveKey(E1, E2, kKing, kWhite)),
+              Optional(Move(E2, E1)));
+}
+
+TEST(CuckooTable, IgnoresOtherKeys) {
+  const CuckooTable& table = GetCuckooTable();
+  // Pawn moves are irreversible.
+  EXPECT_THAT(table.Find(GetMoveKey(E2, E4, kPawn, kWhite)),
+              Eq(std::nullopt));
+  // Knights cannot move like bishops.
+  EXPECT_THAT(table.Find(GetMoveKey(A1, H8, kKnight, kWhite)),
+              Eq(std::nullopt));
+  // Without the side to move, the key is not a move.
+  EXPECT_THAT(table.Find(GetMoveKey(G1, F3, kKnight, kWhite) ^
+                         kZobristKeys.black_to_move),
+              Eq(std::nullopt));
+  EXPECT_THAT(table.Find(0), Eq(std::nullopt));
+}
+
+}  // namespace
+}  // namespace follychess
@@ -1,17 +1,27 @@
 #include "engine/game.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "engine/bitboard.h"
+#include "engine/cuckoo.h"
+#include "engine/line.h"
+#include "engine/move.h"
+#include "engine/types.h"
+
 namespace follychess {
 
 [[nodiscard]] int Game::GetRepetitionCount() const {
-  const std::size_t search_depth =
-      std::min<std::size_t>(history_.size(), position_.GetHalfMoves());
+  const std::size_t end = GetReversiblePlies();
 
   int repetitions = 0;
   const std::uint64_t current_key = position_.GetKey();
 
-  for (int i = 2; i < search_depth; i += 2) {
-    const State& previous_state = history_[history_.size() - 1 - i];
-    if (previous_state.key == current_key) {
+  // The position right after the last irreversible move is `end` plies back,
+  // so it is included.
+  for (std::size_t i = 2; i <= end; i += 2) {
+    if (GetKey(i) == current_key) {
       ++repetitions;
     }
   }
@@ -19,4 +29,54 @@ namespace follychess {
   return repetitions;
 }
 
+bool Game::HasUpcomingRepetition(int ply) const {
+  const std::size_t end = GetReversiblePlies();
+  if (end < 3) {
+    return false;
+  }
+
+  const std::uint64_t current_key = position_.GetKey();
+  const Bitboard occupied = position_.GetPieces();
+  const CuckooTable& table = GetCuckooTable();
+
+  // The positions an odd number of plies back have the other side to move,
+  // so a single move by the side to move can reach them.
+  for (std::size_t i = 3; i <= end; i += 2) {
+    const std::optional<Move> move = table.Find(current_key ^ GetKey(i));
+    if (!move) {
+      continue;
+    }
+
+    const Square from = move->GetFrom();
+    const Square to = move->GetTo();
+    if (GetLine(from, to) & ~Bitboard(from) & occupied) {
+      continue;
+    }
+    if (ply > static_cast<int>(i)) {
+      return true;
+    }
+
+    // Before the root, only a position that the side to move can return to
+    // counts, and only if it already repeated once.
+    const Square square = position_.GetPiece(from) == kEmptyPiece ? to : from;
+    if (position_.GetSide(square) == position_.SideToMove() &&
+        GetRepetition(i) != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int Game::FindRepetition() const {
+  const std::size_t end = GetReversiblePlies();
+  const std::uint64_t current_key = position_.GetKey();
+  for (std::size_t i = 4; i <= end; i += 2) {
+    if (GetKey(i) == current_key) {
+      const int distance = static_cast<int>(i);
+      return GetRepetition(i) != 0 ? -distance : distance;
+    }
+  }
+  return 0;
+}
+
 }  // namespace follychess
@@ -1,21 +1,27 @@
 #ifndef FOLLYCHESS_ENGINE_GAME_H_
 #define FOLLYCHESS_ENGINE_GAME_H_
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "engine/move.h"
 #include "engine/position.h"
 
 namespace follychess {
 
 class Game {
  public:
-  explicit Game(const Position& position) : position_(position) {}
+  explicit Game(const Position& position)
+      : starting_position_(position), position_(position) {}
 
-  Game() : position_(Position::Starting()) {}
+  Game() : Game(Position::Starting()) {}
 
-  void Do(Move move) {
-    history_.emplace_back();
-    history_.back().undo_info = position_.Do(move);
-    history_.back().key = position_.GetKey();
-  }
+  void Do(Move move) { Push(position_.Do(move)); }
+
+  // Like Do(Move), for moves that carry their pieces.
+  void Do(ExtendedMove move) { Push(position_.Do(move)); }
 
   void Undo() {
     DCHECK(!history_.empty());
@@ -25,14 +31,86 @@ class Game {
 
   [[nodiscard]] int GetRepetitionCount() const;
 
+  // Returns true if the current position is a draw by repetition for a search
+  // whose root is `ply` moves back. A position that repeats once after the
+  // root is scored as a draw, because the side that could avoid the
+  // repetition would not gain by playing it again. A repetition of a position
+  // from before the root must occur three times.
+  [[nodiscard]] bool IsRepetition(int ply) const {
+    const int repetition = history_.empty() ? 0 : history_.back().repetition;
+    return repetition != 0 && repetition < ply;
+  }
+
+  // Returns true if the side to move can play a reversible move that repeats
+  // an earlier position, which makes the current position at least a draw.
+  // The cuckoo tables find such moves without generating them.
+  [[nodiscard]] bool HasUpcomingRepetition(int ply) const;
+
+  // Reserves space for `num_moves` moves in total, so that doing that many
+  // moves does not allocate. Do() and Undo() only allocate if the game grows
+  // past the reserved space.
+  void Reserve(std::size_t num_moves) { history_.reserve(num_moves); }
+
   [[nodiscard]] const Position& GetPosition() const { return position_; }
 
+  // Returns the position that the game started from.
+  [[nodiscard]] const Position& GetStartingPosition() const {
+    return starting_position_;
+  }
+
+  // Returns the number of moves made since the starting position.
+  [[nodiscard]] std::size_t GetNumMoves() const { return history_.size(); }
+
+  // Returns the `i`-th move made since the starting position.
+  [[nodiscard]] Move GetMove(std::size_t i) const {
+    DCHECK_LT(i, history_.size());
+    return history_[i].undo_info.move;
+  }
+
  private:
   struct State {
     std::uint64_t key{0};
     UndoInfo undo_info;
+
+    // The distance in plies to the previous occurrence of the position, or
+    // zero if there is none. The distance is negative if the previous
+    // occurrence was itself a repetition.
+    int repetition{0};
   };
 
+  // Records the move that Position::Do() just made.
+  void Push(const UndoInfo &undo_info) {
+    history_.emplace_back();
+    history_.back().undo_info = undo_info;
+    history_.back().key = position_.GetKey();
+    history_.back().repetition = FindRepetition();
+  }
+
+  // Returns the key of the position `plies` moves back.
+  [[nodiscard]] std::uint64_t GetKey(std::size_t plies) const {
+    DCHECK_LE(plies, history_.size());
+    return plies == history_.size()
+               ? starting_position_.GetKey()
+               : history_[history_.size() - 1 - plies].key;
+  }
+
+  // Returns the repetition of the state `plies` moves back.
+  [[nodiscard]] int GetRepetition(std::size_t plies) const {
+    return plies == history_.size()
+               ? 0
+               : history_[history_.size() - 1 - plies].repetition;
+  }
+
+  // Returns the number of plies that may be searched for an earlier
+  // occurrence of the current position. Captures and pawn moves are
+  // irreversible, so the search stops at the last one.
+  [[nodiscard]] std::size_t GetReversiblePlies() const {
+    return std::min<std::size_t>(history_.size(), position_.GetHalfMoves());
+  }
+
+  [[nodiscard]] int FindRepetition() const;
+
+  Position starting_position_;
   Position position_;
   std::vector<State> history_;
 };
@@ -3,6 +3,8 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <utility>
+
 namespace follychess {
 namespace {
 
@@ -23,30 +25,107 @@ TEST(GetRepetitionCount, NoRepetition) {
   game.Do(Move(E7, E5));
   EXPECT_THAT(game.GetRepetitionCount(), Eq(0));
 
-  game.Do(Move(B2, C3));
+  game.Do(Move(B1, C3));
   EXPECT_THAT(game.GetRepetitionCount(), Eq(0));
 
   game.Do(Move(B8, C6));
   EXPECT_THAT(game.GetRepetitionCount(), Eq(0));
 
-  game.Do(Move(C3, B2));
+  game.Do(Move(C3, B1));
   EXPECT_THAT(game.GetRepetitionCount(), Eq(0));
 
   game.Do(Move(C6, B8));
   EXPECT_THAT(game.GetRepetitionCount(), Eq(1));
 
-  game.Do(Move(B2, C3));
+  game.Do(Move(B1, C3));
   EXPECT_THAT(game.GetRepetitionCount(), Eq(1));
 
   game.Do(Move(B8, C6));
   EXPECT_THAT(game.GetRepetitionCount(), Eq(1));
 
-  game.Do(Move(C3, B2));
+  game.Do(Move(C3, B1));
   EXPECT_THAT(game.GetRepetitionCount(), Eq(1));
 
   game.Do(Move(C6, B8));
   EXPECT_THAT(game.GetRepetitionCount(), Eq(2));
 }
 
+TEST(Game, IsRepetition) {
+  Game game;
+  game.Do(Move(G1, F3));
+  game.Do(Move(G8, F6));
+  game.Do(Move(F3, G1));
+  EXPECT_THAT(game.IsRepetition(1), IsFalse());
+  EXPECT_THAT(game.IsRepetition(100), IsFalse());
+
+  // The starting position repeats once, which is a draw if the search started
+  // at the starting position or before it.
+  game.Do(Move(F6, G8));
+  EXPECT_THAT(game.IsRepetition(4), IsFalse());
+  EXPECT_THAT(game.IsRepetition(5), IsTrue());
+
+  // The third occurrence is a draw for any search.
+  game.Do(Move(G1, F3));
+  game.Do(Move(G8, F6));
+  game.Do(Move(F3, G1));
+  EXPECT_THAT(game.IsRepetition(1), IsFalse());
+  game.Do(Move(F6, G8));
+  EXPECT_THAT(game.IsRepetition(1), IsTrue());
+
+  game.Undo();
+  EXPECT_THAT(game.IsRepetition(4), IsFalse());
+}
+
+TEST(Game, HasUpcomingRepetition) {
+  Game game;
+  EXPECT_THAT(game.HasUpcomingRepetition(10), IsFalse());
+
+  // Black can play Ng8 to repeat the starting position.
+  game.Do(Move(G1, F3));
+  game.Do(Move(G8, F6));
+  game.Do(Move(F3, G1));
+  EXPECT_THAT(game.HasUpcomingRepetition(4), IsTrue());
+
+  // If the starting position is before the root, it must have repeated
+  // already.
+  EXPECT_THAT(game.HasUpcomingRepetition(3), IsFalse());
+  game.Do(Move(F6, G8));
+  game.Do(Move(G1, F3));
+  game.Do(Move(G8, F6));
+  game.Do(Move(F3, G1));
+  EXPECT_THAT(game.HasUpcomingRepetition(1), IsTrue());
+}
+
+TEST(Game, HasUpcomingRepetitionRequiresAFreePath) {
+  for (const auto& [fen, expected] :
+       {std::pair("7r/8/8/8/8/8/8/K6k b - - 10 1", true),
+        std::pair("7r/7P/8/8/8/8/8/K6k b - - 10 1", false)}) {
+    Game game(Position::FromFen(fen).value());
+    game.Do(Move(H8, G8));
+    game.Do(Move(A1, B1));
+    game.Do(Move(G8, G6));
+    game.Do(Move(B1, A1));
+    game.Do(Move(G6, H6));
+    // Rh6-h8 repeats the starting position, unless h7 is blocked.
+    EXPECT_THAT(game.HasUpcomingRepetition(10), Eq(expected)) << fen;
+  }
+}
+
+TEST(Game, Moves) {
+  Game game;
+  EXPECT_THAT(game.GetNumMoves(), Eq(0));
+
+  game.Do(Move(E2, E4, Move::kDoublePawnPush));
+  game.Do(Move(E7, E5, Move::kDoublePawnPush));
+  EXPECT_THAT(game.GetNumMoves(), Eq(2));
+  EXPECT_THAT(game.GetMove(0), Eq(Move(E2, E4, Move::kDoublePawnPush)));
+  EXPECT_THAT(game.GetMove(1), Eq(Move(E7, E5, Move::kDoublePawnPush)));
+  EXPECT_THAT(game.GetStartingPosition(), Eq(Position::Starting()));
+  EXPECT_THAT(game.GetPosition(), Ne(Position::Starting()));
+
+  game.Undo();
+  EXPECT_THAT(game.GetNumMoves(), Eq(1));
+}
+
 }  // namespace
 }  // namespace follychess
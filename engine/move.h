@@ -139,10 +139,44 @@ class Move {
 
 std::ostream &operator<<(std::ostream &os, const Move &move);
 
+// A move together with the piece that makes it and the piece that it
+// captures, which the move generator knows when it generates the move. This
+// saves looking the pieces up again when the move is ordered and made. The
+// 16-bit Move remains the form that is stored, e.g., in the transposition
+// table.
+class ExtendedMove {
+ public:
+  constexpr ExtendedMove() : piece_(kEmptyPiece), captured_(kEmptyPiece) {}
+
+  // The captured piece is kEmptyPiece for moves that do not capture and kPawn
+  // for en passant captures.
+  constexpr ExtendedMove(Move move, Piece piece, Piece captured)
+      : move_(move), piece_(piece), captured_(captured) {}
+
+  [[nodiscard]] constexpr Move GetMove() const { return move_; }
+
+  [[nodiscard]] constexpr Piece GetPiece() const { return piece_; }
+
+  [[nodiscard]] constexpr Piece GetCapturedPiece() const { return captured_; }
+
+  constexpr bool operator==(const ExtendedMove &other) const = default;
+
+ private:
+  Move move_;
+  Piece piece_;
+  Piece captured_;
+};
+
+static_assert(sizeof(ExtendedMove) == 4,
+              "ExtendedMove size is not 4 bytes! "
+              "Check field ordering for padding or new members.");
+
 struct UndoInfo {
   Move move;
   std::optional<Square> en_passant_target;
   Piece captured_piece;
+  // The piece that made the move. For promotions, this is the pawn.
+  Piece piece;
   std::uint8_t half_moves;
   CastlingRights castling_rights;
 };
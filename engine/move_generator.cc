@@ -1,45 +1,73 @@
 #include "engine/move_generator.h"
 
+#include <type_traits>
 #include <vector>
 
 #include "absl/log/check.h"
 #include "engine/attacks.h"
+#include "engine/move_list.h"
 #include "engine/types.h"
 #include "line.h"
 
 namespace follychess {
 namespace {
 
-void AddPawnMoves(Bitboard destinations, int offset, Move::Flags flag,
-                  std::vector<Move> &moves) {
+// Appends `move`. Only lists of extended moves keep the pieces.
+void AddMove(MoveList &moves, Move move, Piece /*piece*/, Piece /*captured*/) {
+  moves.push_back(move);
+}
+
+void AddMove(ExtendedMoveList &moves, Move move, Piece piece, Piece captured) {
+  moves.emplace_back(move, piece, captured);
+}
+
+// Returns the piece that a pawn move to `to` with `flag` captures. Only lists
+// of extended moves need it, so plain move generation skips the lookup.
+template <typename List, typename Board>
+Piece GetCapturedByPawn(const Board &position, Square to, Move::Flags flag) {
+  if constexpr (std::is_same_v<List, ExtendedMoveList>) {
+    if (flag == Move::Flags::kEnPassantCapture) {
+      return kPawn;
+    }
+    if (flag & Move::Flags::kCapture) {
+      return position.GetPiece(to);
+    }
+  }
+  return kEmptyPiece;
+}
+
+template <typename Board, typename List>
+void AddPawnMoves(const Board &position, Bitboard destinations, int offset,
+                  Move::Flags flag, List &moves) {
   while (destinations) {
     Square to = destinations.PopLeastSignificantBit();
     const auto from = static_cast<Square>(to - offset);
-    moves.emplace_back(from, to, flag);
+    AddMove(moves, Move(from, to, flag), kPawn,
+            GetCapturedByPawn<List>(position, to, flag));
   }
 }
 
-void AddPawnPromotions(Bitboard promotions, int offset, Move::Flags flag,
-                       std::vector<Move> &moves) {
+template <typename Board, typename List>
+void AddPawnPromotions(const Board &position, Bitboard promotions, int offset,
+                       Move::Flags flag, List &moves) {
   using enum Move::Flags;
 
   while (promotions) {
     const Square to = promotions.PopLeastSignificantBit();
     const auto from = static_cast<Square>(to - offset);
+    const Piece captured = GetCapturedByPawn<List>(position, to, flag);
 
-    moves.emplace_back(from, to,
-                       static_cast<Move::Flags>(kKnightPromotion | flag));
-    moves.emplace_back(from, to,
-                       static_cast<Move::Flags>(kBishopPromotion | flag));
-    moves.emplace_back(from, to,
-                       static_cast<Move::Flags>(kRookPromotion | flag));
-    moves.emplace_back(from, to,
-                       static_cast<Move::Flags>(kQueenPromotion | flag));
+    for (Move::Flags promotion : {kKnightPromotion, kBishopPromotion,
+                                  kRookPromotion, kQueenPromotion}) {
+      AddMove(moves,
+              Move(from, to, static_cast<Move::Flags>(promotion | flag)),
+              kPawn, captured);
+    }
   }
 }
 
-template <Side Side, MoveType MoveType>
-void GeneratePawnMoves(const Position &position, std::vector<Move> &moves) {
+template <Side Side, MoveType MoveType, typename Board, typename List>
+void GeneratePawnMoves(const Board &position, List &moves) {
   static constexpr Direction forward = Side == kWhite ? kNorth : kSouth;
   static constexpr Bitboard promotion_rank =
       Side == kWhite ? rank::k8 : rank::k1;
@@ -50,17 +78,17 @@ void GeneratePawnMoves(const Position &position, std::vector<Move> &moves) {
 
     // Single pawn pushes:
     Bitboard single_moves = pawns.Shift<forward>() & empty;
-    AddPawnMoves(single_moves & ~promotion_rank, forward, Move::Flags::kNone,
-                 moves);
-    AddPawnPromotions(single_moves & promotion_rank, forward,
+    AddPawnMoves(position, single_moves & ~promotion_rank, forward,
+                 Move::Flags::kNone, moves);
+    AddPawnPromotions(position, single_moves & promotion_rank, forward,
                       Move::Flags::kNone, moves);
 
     // Double pawn pushes:
     Bitboard second_rank = Side == kWhite ? rank::k3 : rank::k6;
     Bitboard double_moves =
         (single_moves & second_rank).Shift<forward>() & empty;
-    AddPawnMoves(double_moves, forward * 2, Move::Flags::kDoublePawnPush,
-                 moves);
+    AddPawnMoves(position, double_moves, forward * 2,
+                 Move::Flags::kDoublePawnPush, moves);
   }
 
   if constexpr (MoveType == kCapture || MoveType == kEvasion) {
@@ -72,30 +100,29 @@ void GeneratePawnMoves(const Position &position, std::vector<Move> &moves) {
     Bitboard left_captures = pawns.Shift<left>() & enemies;
     Bitboard right_captures = pawns.Shift<right>() & enemies;
 
-    AddPawnMoves(left_captures & ~promotion_rank, left, Move::Flags::kCapture,
-                 moves);
-    AddPawnMoves(right_captures & ~promotion_rank, right, Move::Flags::kCapture,
-                 moves);
+    AddPawnMoves(position, left_captures & ~promotion_rank, left,
+                 Move::Flags::kCapture, moves);
+    AddPawnMoves(position, right_captures & ~promotion_rank, right,
+                 Move::Flags::kCapture, moves);
 
     std::optional<Square> en_passant_target = position.GetEnPassantTarget();
     if (en_passant_target) {
       auto target = Bitboard(*en_passant_target);
-      AddPawnMoves(pawns.Shift<left>() & target, left,
+      AddPawnMoves(position, pawns.Shift<left>() & target, left,
                    Move::Flags::kEnPassantCapture, moves);
-      AddPawnMoves(pawns.Shift<right>() & target, right,
+      AddPawnMoves(position, pawns.Shift<right>() & target, right,
                    Move::Flags::kEnPassantCapture, moves);
     }
 
-    AddPawnPromotions(left_captures & promotion_rank, left,
+    AddPawnPromotions(position, left_captures & promotion_rank, left,
                       Move::Flags::kCapture, moves);
-    AddPawnPromotions(right_captures & promotion_rank, right,
+    AddPawnPromotions(position, right_captures & promotion_rank, right,
                       Move::Flags::kCapture, moves);
   }
 }
 
-template <Side Side, Piece Piece>
-void GenerateMoves(const Position &position, Bitboard targets,
-                   std::vector<Move> &moves) {
+template <Side Side, Piece Piece, typename Board, typename List>
+void GenerateMoves(const Board &position, Bitboard targets, List &moves) {
   Bitboard pieces = position.GetPieces(Side, Piece);
   while (pieces) {
     Square from = pieces.PopLeastSignificantBit();
@@ -105,65 +132,59 @@ void GenerateMoves(const Position &position, Bitboard targets,
     while (attacks) {
       Square to = attacks.PopLeastSignificantBit();
 
+      const auto captured = position.GetPiece(to);
       Move::Flags flags = Move::Flags::kNone;
-      if (position.GetPiece(to) != kEmptyPiece) {
+      if (captured != kEmptyPiece) {
         flags = Move::Flags::kCapture;
       }
-      moves.emplace_back(from, to, flags);
+      AddMove(moves, Move(from, to, flags), Piece, captured);
     }
   }
 }
 
-[[nodiscard]] bool IsImpeded(const Position &position, Bitboard path) {
+template <typename Board>
+[[nodiscard]] bool IsImpeded(const Board &position, Bitboard path) {
   return static_cast<bool>(position.GetPieces() & path);
 }
 
-template <Side Side>
-[[nodiscard]] bool IsAttacked(const Position &position, Bitboard path) {
-  while (path) {
-    Square square = path.PopLeastSignificantBit();
-    if (position.GetAttackers(square, ~Side)) {
-      return true;
-    }
-  }
-  return false;
-}
-
-template <Side Side>
-void GenerateCastlingMoves(const Position &position, std::vector<Move> &moves) {
+template <Side Side, typename Board, typename List>
+void GenerateCastlingMoves(const Board &position, List &moves) {
   static_assert(Side == kWhite || Side == kBlack);
 
-  if (position.GetCastlingRights().HasKingSide<Side>()) {
+  // The attacked squares are only computed, once, if a path is clear.
+  const auto is_attacked = [&](Bitboard path) {
+    return static_cast<bool>(position.GetAttackedSquares(~Side) & path);
+  };
+
+  if (position.GetCastlingRights().template HasKingSide<Side>()) {
     Bitboard rook_path = GetKingSideCastlingPath<Side>();
-    if (!IsImpeded(position, rook_path) &&
-        !IsAttacked<Side>(position, rook_path)) {
+    if (!IsImpeded(position, rook_path) && !is_attacked(rook_path)) {
       static constexpr Move kCastlingMoves[] = {
           Move(E1, G1, Move::Flags::kKingCastle),
           Move(E8, G8, Move::Flags::kKingCastle),
       };
-      moves.push_back(kCastlingMoves[Side]);
+      AddMove(moves, kCastlingMoves[Side], kKing, kEmptyPiece);
     }
   }
 
-  if (position.GetCastlingRights().HasQueenSide<Side>()) {
+  if (position.GetCastlingRights().template HasQueenSide<Side>()) {
     Bitboard rook_path = GetQueenSideCastlingPath<Side>();
 
     Bitboard king_path = rook_path;
     king_path.PopLeastSignificantBit();
 
-    if (!IsImpeded(position, rook_path) &&
-        !IsAttacked<Side>(position, king_path)) {
+    if (!IsImpeded(position, rook_path) && !is_attacked(king_path)) {
       static constexpr Move kCastlingMoves[] = {
           Move(E1, C1, Move::Flags::kQueenCastle),
           Move(E8, C8, Move::Flags::kQueenCastle),
       };
-      moves.push_back(kCastlingMoves[Side]);
+      AddMove(moves, kCastlingMoves[Side], kKing, kEmptyPiece);
     }
   }
 }
 
-template <Side Side, MoveType MoveType>
-Bitboard GetTargets(const Position &position) {
+template <Side Side, MoveType MoveType, typename Board>
+Bitboard GetTargets(const Board &position) {
   if constexpr (MoveType == kQuiet) {
     return ~position.GetPieces();
   }
@@ -188,8 +209,8 @@ Bitboard GetTargets(const Position &position) {
   return {};
 }
 
-template <Side Side, MoveType MoveType>
-Bitboard GetKingTargets(const Position &position) {
+template <Side Side, MoveType MoveType, typename Board>
+Bitboard GetKingTargets(const Board &position) {
   if constexpr (MoveType == kQuiet) {
     return ~position.GetPieces();
   }
@@ -207,8 +228,8 @@ Bitboard GetKingTargets(const Position &position) {
   return {};
 }
 
-template <Side Side, MoveType MoveType>
-void GenerateMoves(const Position &position, std::vector<Move> &moves) {
+template <Side Side, MoveType MoveType, typename Board, typename List>
+void GenerateMoves(const Board &position, List &moves) {
   // Generate moves for all non-king pieces. This logic is shared for two
   // main scenarios:
   //
@@ -249,10 +270,8 @@ void GenerateMoves(const Position &position, std::vector<Move> &moves) {
   }
 }
 
-}  // namespace
-
-template <MoveType MoveType>
-void GenerateMoves(const Position &position, std::vector<Move> &moves) {
+template <MoveType MoveType, typename Board, typename List>
+void GenerateMovesForSideToMove(const Board &position, List &moves) {
   if (position.SideToMove() == kWhite) {
     GenerateMoves<kWhite, MoveType>(position, moves);
   } else {
@@ -260,31 +279,77 @@ void GenerateMoves(const Position &position, std::vector<Move> &moves) {
   }
 }
 
+template <typename Board, typename List>
+void GenerateAllMoves(const Board &position, List &moves) {
+  if (position.GetCheckers(position.SideToMove())) {
+    GenerateMovesForSideToMove<kEvasion>(position, moves);
+  } else {
+    GenerateMovesForSideToMove<kQuiet>(position, moves);
+    GenerateMovesForSideToMove<kCapture>(position, moves);
+  }
+}
+
+}  // namespace
+
+template <MoveType MoveType>
+void GenerateMoves(const Position &position, MoveList &moves) {
+  GenerateMovesForSideToMove<MoveType>(position, moves);
+}
+
+template <MoveType MoveType>
+void GenerateMoves(const Position &position, ExtendedMoveList &moves) {
+  GenerateMovesForSideToMove<MoveType>(position, moves);
+}
+
 template <MoveType MoveType>
 std::vector<Move> GenerateMoves(const Position &position) {
-  std::vector<Move> moves;
+  MoveList moves;
   GenerateMoves<MoveType>(position, moves);
-  return moves;
+  return {moves.begin(), moves.end()};
 }
 
 // Explicitly instantiate the templates for `GenerateMoves()`.
 // This ensures the function is compiled and available to the linker, as the
 // template's definition is in this .cc file rather than a header.
+template void GenerateMoves<kQuiet>(const Position &position, MoveList &moves);
+
+template void GenerateMoves<kCapture>(const Position &position,
+                                      MoveList &moves);
+
+template void GenerateMoves<kEvasion>(const Position &position,
+                                      MoveList &moves);
+
+template void GenerateMoves<kQuiet>(const Position &position,
+                                    ExtendedMoveList &moves);
+
+template void GenerateMoves<kCapture>(const Position &position,
+                                      ExtendedMoveList &moves);
+
+template void GenerateMoves<kEvasion>(const Position &position,
+                                      ExtendedMoveList &moves);
+
 template std::vector<Move> GenerateMoves<kQuiet>(const Position &position);
 
 template std::vector<Move> GenerateMoves<kCapture>(const Position &position);
 
 template std::vector<Move> GenerateMoves<kEvasion>(const Position &position);
 
+void GenerateMoves(const Position &position, MoveList &moves) {
+  GenerateAllMoves(position, moves);
+}
+
+void GenerateMoves(const Position &position, ExtendedMoveList &moves) {
+  GenerateAllMoves(position, moves);
+}
+
 std::vector<Move> GenerateMoves(const Position &position) {
-  std::vector<Move> moves;
-  if (position.GetCheckers(position.SideToMove())) {
-    GenerateMoves<kEvasion>(position, moves);
-  } else {
-    GenerateMoves<kQuiet>(position, moves);
-    GenerateMoves<kCapture>(position, moves);
-  }
-  return moves;
+  MoveList moves;
+  GenerateMoves(position, moves);
+  return {moves.begin(), moves.end()};
+}
+
+void GenerateMoves(const PackedPosition &position, MoveList &moves) {
+  GenerateAllMoves(position, moves);
 }
 
 }  // namespace follychess
@@ -4,6 +4,8 @@
 #include <vector>
 
 #include "move.h"
+#include "move_list.h"
+#include "packed_position.h"
 #include "position.h"
 #include "types.h"
 
@@ -14,6 +16,22 @@ std::vector<Move> GenerateMoves(const Position &position);
 
 std::vector<Move> GenerateMoves(const Position &position);
 
+// Appends the moves to `moves` instead of returning them, which does not
+// allocate. The search uses these overloads.
+template <MoveType MoveType>
+void GenerateMoves(const Position &position, MoveList &moves);
+
+void GenerateMoves(const Position &position, MoveList &moves);
+
+// Like the above, for moves that carry the pieces they move and capture.
+template <MoveType MoveType>
+void GenerateMoves(const Position &position, ExtendedMoveList &moves);
+
+void GenerateMoves(const Position &position, ExtendedMoveList &moves);
+
+// Generates the pseudo-legal moves of a packed position, for copy-make.
+void GenerateMoves(const PackedPosition &position, MoveList &moves);
+
 }  // namespace follychess
 
 #endif  // FOLLYCHESS_MOVE_GENERATOR_H_
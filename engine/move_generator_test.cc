@@ -3,6 +3,12 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <cstddef>
+#include <format>
+#include <string_view>
+
+#include "engine/move.h"
+#include "engine/move_list.h"
 #include "engine/position.h"
 #include "engine/testing.h"
 
@@ -937,5 +943,38 @@ TEST(Evasion, CheckResolvedViaKnightCapture) {
   EXPECT_THAT(GenerateMoves<kEvasion>(position), Contains(MakeMove("g6f7#c")));
 }
 
+// Extended moves are the same moves, in the same order, with the pieces that
+// they move and capture.
+TEST(ExtendedMoves, CarryPieces) {
+  for (std::string_view fen : {
+           "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - "
+           "0 1",
+           "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+           "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+           "4k3/8/8/8/1b6/8/3P4/4K3 w - - 0 1",
+       }) {
+    const Position position = Position::FromFen(fen).value();
+    MoveList moves;
+    GenerateMoves(position, moves);
+    ExtendedMoveList extended_moves;
+    GenerateMoves(position, extended_moves);
+
+    ASSERT_THAT(extended_moves.size(), Eq(moves.size())) << fen;
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+      EXPECT_THAT(extended_moves[i], Eq(position.ExtendMove(moves[i])))
+          << std::format("{:f}\n{}", moves[i], position);
+    }
+  }
+}
+
+TEST(ExtendedMoves, EnPassantCapturesAPawn) {
+  const Position position = Position::FromFen(
+      "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3")
+                                .value();
+  ExtendedMoveList moves;
+  GenerateMoves<kCapture>(position, moves);
+  EXPECT_THAT(moves, Contains(ExtendedMove(MakeMove("e5f6#ep"), kPawn, kPawn)));
+}
+
 }  // namespace
 }  // namespace follychess
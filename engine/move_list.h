@@ -0,0 +1,62 @@
+#ifndef FOLLYCHESS_ENGINE_MOVE_LIST_H_
+#define FOLLYCHESS_ENGINE_MOVE_LIST_H_
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include "absl/log/check.h"
+#include "engine/move.h"
+
+namespace follychess {
+
+// A list of moves with a fixed capacity that lives on the stack, so that
+// generating the moves of a position never allocates. No position has more
+// than 218 legal moves, and the pseudo-legal moves fit the capacity as well.
+template <typename T>
+class BasicMoveList {
+ public:
+  static constexpr std::size_t kCapacity = 256;
+
+  using value_type = T;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    DCHECK_LT(size_, kCapacity);
+    return moves_[size_++] = T(std::forward<Args>(args)...);
+  }
+
+  void push_back(T move) { emplace_back(move); }
+
+  void clear() { size_ = 0; }
+
+  [[nodiscard]] std::size_t size() const { return size_; }
+
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+
+  [[nodiscard]] T& operator[](std::size_t i) { return moves_[i]; }
+
+  [[nodiscard]] T operator[](std::size_t i) const { return moves_[i]; }
+
+  [[nodiscard]] iterator begin() { return moves_.data(); }
+
+  [[nodiscard]] iterator end() { return moves_.data() + size_; }
+
+  [[nodiscard]] const_iterator begin() const { return moves_.data(); }
+
+  [[nodiscard]] const_iterator end() const { return moves_.data() + size_; }
+
+ private:
+  std::array<T, kCapacity> moves_;
+  std::size_t size_ = 0;
+};
+
+using MoveList = BasicMoveList<Move>;
+
+using ExtendedMoveList = BasicMoveList<ExtendedMove>;
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_ENGINE_MOVE_LIST_H_
@@ -0,0 +1,100 @@
+#include "engine/packed_position.h"
+
+#include <optional>
+
+#include "absl/log/check.h"
+#include "engine/bitboard.h"
+#include "engine/move.h"
+#include "engine/position.h"
+#include "engine/types.h"
+
+namespace follychess {
+
+PackedPosition::PackedPosition(const Position &position)
+    : en_passant_target_(position.GetEnPassantTarget()),
+      castling_rights_(position.GetCastlingRights()),
+      side_to_move_(position.SideToMove()),
+      half_moves_(position.GetHalfMoves()),
+      full_moves_(position.GetFullMoves()) {
+  for (Side side : {kWhite, kBlack}) {
+    for (int piece = kPawn; piece <= kKing; ++piece) {
+      Bitboard pieces = position.GetPieces(side, static_cast<Piece>(piece));
+      while (pieces) {
+        Toggle(pieces.PopLeastSignificantBit(), static_cast<Piece>(piece),
+               side);
+      }
+    }
+  }
+
+  if (side_to_move_ == kBlack) {
+    zobrist_key_.UpdateSideToMove();
+  }
+  zobrist_key_.ToggleEnPassantTarget(en_passant_target_);
+  zobrist_key_.ToggleCastlingRights(castling_rights_);
+  DCHECK_EQ(GetKey(), position.GetKey());
+}
+
+void PackedPosition::Toggle(Square square, Piece piece, Side side) {
+  const int code = (piece + 1) | side << 3;
+  const Bitboard bit(square);
+  for (int i = 0; i < 4; ++i) {
+    if (code & (1 << i)) {
+      quad_[i] ^= bit;
+    }
+  }
+  zobrist_key_.Update(square, piece, side);
+}
+
+PackedPosition PackedPosition::Do(Move move) const {
+  const Side us = side_to_move_;
+  const Side them = ~us;
+  const Square from = move.GetFrom();
+  const Square to = move.GetTo();
+  const Piece piece = GetPiece(from);
+  DCHECK(piece != kEmptyPiece);
+
+  PackedPosition child = *this;
+
+  // As in Position::Do(), pawn moves and captures reset the half move clock.
+  child.half_moves_ = piece == kPawn ? 0 : half_moves_ + 1;
+  if (const Piece victim = GetPiece(to); victim != kEmptyPiece) {
+    child.Toggle(to, victim, them);
+    child.half_moves_ = 0;
+  }
+  if (move.IsEnPassantCapture()) {
+    child.Toggle(move.GetEnPassantVictim(), kPawn, them);
+  }
+
+  child.Toggle(from, piece, us);
+  child.Toggle(to, move.IsPromotion() ? move.GetPromotedPiece() : piece, us);
+
+  if (move.IsKingSideCastling()) {
+    child.Toggle(static_cast<Square>(from + 3), kRook, us);
+    child.Toggle(static_cast<Square>(from + 1), kRook, us);
+  } else if (move.IsQueenSideCastling()) {
+    child.Toggle(static_cast<Square>(from - 4), kRook, us);
+    child.Toggle(static_cast<Square>(from - 1), kRook, us);
+  }
+
+  child.zobrist_key_.ToggleCastlingRights(castling_rights_);
+  child.castling_rights_.InvalidateOnMove(from);
+  child.castling_rights_.InvalidateOnMove(to);
+  child.zobrist_key_.ToggleCastlingRights(child.castling_rights_);
+
+  child.zobrist_key_.ToggleEnPassantTarget(en_passant_target_);
+  if (move.IsDoublePawnPush()) {
+    child.en_passant_target_ = move.GetEnPassantTarget();
+    child.zobrist_key_.ToggleEnPassantTarget(child.en_passant_target_);
+  } else {
+    child.en_passant_target_ = std::nullopt;
+  }
+
+  if (us == kBlack) {
+    ++child.full_moves_;
+  }
+  child.side_to_move_ = them;
+  child.zobrist_key_.UpdateSideToMove();
+  return child;
+}
+
+}  // namespace follychess
@@ -0,0 +1,114 @@
+#ifndef FOLLYCHESS_ENGINE_PACKED_POSITION_H_
+#define FOLLYCHESS_ENGINE_PACKED_POSITION_H_
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "engine/attackers.h"
+#include "engine/bitboard.h"
+#include "engine/castling.h"
+#include "engine/move.h"
+#include "engine/position.h"
+#include "engine/types.h"
+#include "engine/zobrist.h"
+
+namespace follychess {
+
+// A position packed into a single cache line for copy-make: Do() returns the
+// child position and leaves this one unchanged, so moves are never undone,
+// and threads can hand positions to each other by value.
+//
+// The board is a quad-bitboard. Each square holds a 4-bit code, whose bit i
+// is stored in `quad_[i]`: the low three bits are the piece plus one, so that
+// zero is an empty square, and the high bit is set for black pieces.
+//
+// Unlike Position, a packed position keeps no pawn key and caches no check
+// information.
+class alignas(64) PackedPosition {
+ public:
+  explicit PackedPosition(const Position &position);
+
+  [[nodiscard]] Bitboard GetPieces() const {
+    return quad_[0] | quad_[1] | quad_[2];
+  }
+
+  [[nodiscard]] Bitboard GetPieces(Side side) const {
+    return GetPieces() & (side == kBlack ? quad_[3] : ~quad_[3]);
+  }
+
+  [[nodiscard]] Bitboard GetPieces(Piece piece) const {
+    const int code = piece + 1;
+    return (code & 0b001 ? quad_[0] : ~quad_[0]) &
+           (code & 0b010 ? quad_[1] : ~quad_[1]) &
+           (code & 0b100 ? quad_[2] : ~quad_[2]);
+  }
+
+  [[nodiscard]] Bitboard GetPieces(Side side, Piece piece) const {
+    return GetPieces(piece) & (side == kBlack ? quad_[3] : ~quad_[3]);
+  }
+
+  [[nodiscard]] Piece GetPiece(Square square) const {
+    const int code = quad_[0].Get(square) | quad_[1].Get(square) << 1 |
+                     quad_[2].Get(square) << 2;
+    return code == 0 ? kEmptyPiece : static_cast<Piece>(code - 1);
+  }
+
+  [[nodiscard]] Side SideToMove() const { return side_to_move_; }
+
+  [[nodiscard]] Square GetKing(Side side) const {
+    return GetPieces(side, kKing).LeastSignificantBit();
+  }
+
+  [[nodiscard]] Bitboard GetAttackers(Square to, Side by) const {
+    return FindAttackers(*this, to, by, GetPieces());
+  }
+
+  // Returns the pieces that give check to the king of `of`.
+  [[nodiscard]] Bitboard GetCheckers(Side of) const {
+    return GetAttackers(GetKing(of), ~of);
+  }
+
+  // See Position::GetAttackedSquares().
+  [[nodiscard]] Bitboard GetAttackedSquares(Side by) const {
+    return FindAttackedSquares(*this, by);
+  }
+
+  [[nodiscard]] const CastlingRights &GetCastlingRights() const {
+    return castling_rights_;
+  }
+
+  [[nodiscard]] std::optional<Square> GetEnPassantTarget() const {
+    return en_passant_target_;
+  }
+
+  [[nodiscard]] int GetHalfMoves() const { return half_moves_; }
+
+  [[nodiscard]] int GetFullMoves() const { return full_moves_; }
+
+  [[nodiscard]] std::uint64_t GetKey() const { return zobrist_key_.GetKey(); }
+
+  // Returns the position after `move`, which must be pseudo-legal.
+  [[nodiscard]] PackedPosition Do(Move move) const;
+
+  bool operator==(const PackedPosition &other) const = default;
+
+ private:
+  // Adds or removes the piece on the square, in the board and in the key.
+  void Toggle(Square square, Piece piece, Side side);
+
+  std::array<Bitboard, 4> quad_;
+  ZobristKey zobrist_key_;
+  std::optional<Square> en_passant_target_;
+  CastlingRights castling_rights_;
+  Side side_to_move_;
+  std::uint8_t half_moves_;
+  std::uint16_t full_moves_;
+};
+
+static_assert(sizeof(PackedPosition) == 64,
+              "PackedPosition does not fill exactly one cache line.");
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_ENGINE_PACKED_POSITION_H_
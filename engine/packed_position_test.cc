@@ -0,0 +1,94 @@
+#include "engine/packed_position.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <format>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "engine/move.h"
+#include "engine/move_generator.h"
+#include "engine/position.h"
+
+namespace follychess {
+namespace {
+
+using ::testing::Eq;
+using ::testing::UnorderedElementsAreArray;
+
+TEST(PackedPosition, MatchesPosition) {
+  const Position position =
+      Position::FromFen(
+          "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 3 9")
+          .value();
+  const PackedPosition packed(position);
+
+  EXPECT_THAT(packed.GetPieces(), Eq(position.GetPieces()));
+  for (Side side : {kWhite, kBlack}) {
+    EXPECT_THAT(packed.GetPieces(side), Eq(position.GetPieces(side)));
+    for (int piece = kPawn; piece <= kKing; ++piece) {
+      EXPECT_THAT(packed.GetPieces(side, static_cast<Piece>(piece)),
+                  Eq(position.GetPieces(side, static_cast<Piece>(piece))));
+    }
+  }
+  for (int square = 0; square < kNumSquares; ++square) {
+    EXPECT_THAT(packed.GetPiece(static_cast<Square>(square)),
+                Eq(position.GetPiece(static_cast<Square>(square))));
+  }
+  EXPECT_THAT(packed.SideToMove(), Eq(kBlack));
+  EXPECT_THAT(packed.GetCastlingRights(), Eq(position.GetCastlingRights()));
+  EXPECT_THAT(packed.GetHalfMoves(), Eq(3));
+  EXPECT_THAT(packed.GetFullMoves(), Eq(9));
+  EXPECT_THAT(packed.GetKey(), Eq(position.GetKey()));
+}
+
+// Plays random games and checks that copy-make on packed positions produces
+// the same positions and moves as make/unmake on Position.
+TEST(PackedPosition, DoMatchesPosition) {
+  constexpr std::string_view kFens[] = {
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+      "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+      "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+  };
+  constexpr int kPlayoutsPerFen = 4;
+  constexpr int kMaxPlies = 60;
+
+  std::mt19937 random(0);
+  for (std::string_view fen : kFens) {
+    for (int playout = 0; playout < kPlayoutsPerFen; ++playout) {
+      Position position = Position::FromFen(fen).value();
+      for (int ply = 0; ply < kMaxPlies; ++ply) {
+        const PackedPosition packed(position);
+        const std::vector<Move> moves = GenerateMoves(position);
+        MoveList packed_moves;
+        GenerateMoves(packed, packed_moves);
+        ASSERT_THAT(packed_moves, UnorderedElementsAreArray(moves))
+            << std::format("{}", position);
+
+        std::vector<Move> legal_moves;
+        for (Move move : moves) {
+          const PackedPosition child = packed.Do(move);
+          const UndoInfo undo_info = position.Do(move);
+          ASSERT_THAT(child, Eq(PackedPosition(position)))
+              << std::format("{:f}\n{}", move, position);
+          if (!position.GetCheckers(~position.SideToMove())) {
+            legal_moves.push_back(move);
+          }
+          position.Undo(undo_info);
+        }
+        if (legal_moves.empty()) {
+          break;
+        }
+        position.Do(legal_moves[std::uniform_int_distribution<std::size_t>(
+            0, legal_moves.size() - 1)(random)]);
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace follychess
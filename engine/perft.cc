@@ -7,12 +7,15 @@
 #include "absl/log/log.h"
 #include "move.h"
 #include "move_generator.h"
+#include "move_list.h"
+#include "packed_position.h"
 #include "position.h"
-#include "scoped_move.h"
+#include "types.h"
 
 namespace follychess {
 namespace {
 
+template <Side Side>
 std::size_t RunPerft(std::size_t depth, std::size_t current_depth,
                      Position &position, Move start_move,
                      std::vector<std::size_t> &depth_counts) {
@@ -26,20 +29,44 @@ std::size_t RunPerft(std::size_t depth, std::size_t current_depth,
   std::size_t final_move_count = 0;
 
   for (const Move &move : moves) {
-    ScopedMove scoped_move(move, position);
+    const UndoInfo undo_info =
+        position.Do<Side>(move, position.GetPiece(move.GetFrom()));
 
-    if (position.GetCheckers(~position.SideToMove())) {
-      continue;
+    if (!position.GetCheckers(Side)) {
+      final_move_count += RunPerft<~Side>(depth, current_depth + 1, position,
+                                          start_move, depth_counts);
     }
-    final_move_count +=
-        RunPerft(depth, current_depth + 1, position, start_move, depth_counts);
+    position.Undo<Side>(undo_info);
   }
 
   return final_move_count;
 }
 
+std::size_t RunCopyMakePerft(std::size_t depth,
+                             const PackedPosition &position) {
+  MoveList moves;
+  GenerateMoves(position, moves);
+
+  std::size_t count = 0;
+  for (Move move : moves) {
+    const PackedPosition child = position.Do(move);
+    if (child.GetCheckers(position.SideToMove())) {
+      continue;
+    }
+    count += depth == 1 ? 1 : RunCopyMakePerft(depth - 1, child);
+  }
+  return count;
+}
+
 }  // namespace
 
+std::size_t RunCopyMakePerft(std::size_t depth, const Position &position) {
+  if (depth == 0) {
+    return 1;
+  }
+  return RunCopyMakePerft(depth, PackedPosition(position));
+}
+
 void RunPerft(std::size_t depth, const Position &position,
               std::vector<std::size_t> &final_depth_counts,
               std::map<Move, std::size_t> &final_move_counts) {
@@ -66,7 +93,11 @@ void RunPerft(std::size_t depth, const Position &position,
       }
 
       all_move_counts[i] =
-          RunPerft(depth, 1, new_position, move, all_depth_counts[i]);
+          new_position.SideToMove() == kWhite
+              ? RunPerft<kWhite>(depth, 1, new_position, move,
+                                 all_depth_counts[i])
+              : RunPerft<kBlack>(depth, 1, new_position, move,
+                                 all_depth_counts[i]);
     });
   }
 
@@ -12,6 +12,11 @@ void RunPerft(std::size_t depth, const Position &position,
               std::vector<std::size_t> &final_depth_counts,
               std::map<Move, std::size_t> &final_move_counts);
 
+// Returns the number of leaf nodes `depth` plies below `position`. Unlike
+// RunPerft(), which makes and unmakes moves, this copies a packed position for
+// each move and runs on the calling thread.
+std::size_t RunCopyMakePerft(std::size_t depth, const Position &position);
+
 }  // namespace follychess
 
 #endif  // FOLLYCHESS_PERFT_H_
@@ -3,6 +3,8 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <format>
 #include <ranges>
 
 #include "absl/strings/str_join.h"
@@ -14,6 +16,7 @@ namespace follychess {
 namespace {
 
 using ::testing::ElementsAreArray;
+using ::testing::Eq;
 using ::testing::IsEmpty;
 
 struct PerftTestCase {
@@ -165,6 +168,47 @@ TEST_P(PerftTest, Run) {
   EXPECT_THAT(depth_counts, ElementsAreArray(expected_node_count));
 }
 
+TEST_P(PerftTest, CopyMake) {
+  const auto &[_, fen, expected_node_count] = GetParam();
+  std::expected<Position, std::string> position = Position::FromFen(fen);
+  ASSERT_THAT(position.error_or(""), IsEmpty());
+
+  // Copy-make runs on a single thread, so the deepest counts are skipped.
+  const std::size_t depth =
+      std::min<std::size_t>(expected_node_count.size() - 1, 4);
+  EXPECT_THAT(RunCopyMakePerft(depth, position.value()),
+              Eq(expected_node_count[depth]));
+}
+
+// Checks GivesCheck() against making each legal move in the tree below
+// `position` and testing the other side for check.
+void ExpectGivesCheck(std::size_t depth, Position &position) {
+  if (depth == 0) {
+    return;
+  }
+  for (Move move : GenerateMoves(position)) {
+    const bool gives_check = position.GivesCheck(move);
+    const UndoInfo undo_info = position.Do(move);
+    if (!position.GetCheckers(~position.SideToMove())) {
+      EXPECT_THAT(gives_check,
+                  Eq(static_cast<bool>(
+                      position.GetCheckers(position.SideToMove()))))
+          << std::format("{}\n{}", move, position);
+      ExpectGivesCheck(depth - 1, position);
+    }
+    position.Undo(undo_info);
+  }
+}
+
+TEST_P(PerftTest, GivesCheck) {
+  const auto &[_, fen, expected_node_count] = GetParam();
+  std::expected<Position, std::string> position = Position::FromFen(fen);
+  ASSERT_THAT(position.error_or(""), IsEmpty());
+
+  ExpectGivesCheck(std::min<std::size_t>(expected_node_count.size() - 1, 3),
+                   position.value());
+}
+
 INSTANTIATE_TEST_SUITE_P(Perft, PerftTest, testing::ValuesIn(kTestCases),
                          GetTestName);
 
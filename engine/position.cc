@@ -5,7 +5,9 @@
 #include "absl/strings/str_split.h"
 #include "attacks.h"
 #include "bitboard.h"
+#include "engine/attackers.h"
 #include "engine/castling.h"
+#include "engine/line.h"
 
 namespace follychess {
 
@@ -34,6 +36,31 @@ namespace {
   return kEmptyBoard;
 }
 
+[[nodiscard]] Piece GetCapturedPiece(const Position &position, Move move) {
+  return move.IsEnPassantCapture() ? kPawn : position.GetPiece(move.GetTo());
+}
+
+// Returns true if the three squares are on one rank, file or diagonal.
+[[nodiscard]] bool AreAligned(Square a, Square b, Square c) {
+  return (GetLine(a, c) & b) || (GetLine(a, b) & c);
+}
+
+[[nodiscard]] Bitboard GeneratePieceAttacks(Piece piece, Square square,
+                                            Bitboard occupied) {
+  switch (piece) {
+    case kKnight:
+      return GenerateAttacks<kKnight>(square, occupied);
+    case kBishop:
+      return GenerateAttacks<kBishop>(square, occupied);
+    case kRook:
+      return GenerateAttacks<kRook>(square, occupied);
+    case kQueen:
+      return GenerateAttacks<kQueen>(square, occupied);
+    default:
+      return kEmptyBoard;
+  }
+}
+
 }  // namespace
 
 Piece Position::GetPiece(Square square) const {
@@ -80,27 +107,12 @@ Bitboard Position::GetPieces(Side side, Piece type) const {
 }
 
 Bitboard Position::GetAttackers(Square to, Side attacker_side) const {
-  Bitboard occupied = GetPieces();
-  Bitboard attackers;
-
-  Side victim_side = ~attacker_side;
-
-  attackers |=
-      GetPawnAttacks(to, victim_side) & GetPieces(attacker_side, kPawn);
-  attackers |= GenerateAttacks<kKnight>(to, occupied) &
-               GetPieces(attacker_side, kKnight);
-  attackers |=
-      GenerateAttacks<kKing>(to, occupied) & GetPieces(attacker_side, kKing);
-
-  // Generates attacks from rooks, bishops, and queens:
-  attackers |=
-      GenerateAttacks<kRook>(to, occupied) &
-      (GetPieces(attacker_side, kRook) | GetPieces(attacker_side, kQueen));
-  attackers |=
-      GenerateAttacks<kBishop>(to, occupied) &
-      (GetPieces(attacker_side, kBishop) | GetPieces(attacker_side, kQueen));
+  return GetAttackers(to, attacker_side, GetPieces());
+}
 
-  return attackers;
+Bitboard Position::GetAttackers(Square to, Side attacker_side,
+                                Bitboard occupied) const {
+  return FindAttackers(*this, to, attacker_side, occupied);
 }
 
 Square Position::GetKing(Side side) const {
@@ -112,11 +124,259 @@ Square Position::GetKing(Side side) const {
   return king.LeastSignificantBit();
 }
 
-Bitboard Position::GetCheckers(Side king_side) const {
+Bitboard Position::ComputeCheckers(Side king_side) const {
   Side attacker_side = ~king_side;
   return GetAttackers(GetKing(king_side), attacker_side);
 }
 
+void Position::ComputeBlockers() const {
+  const Bitboard occupied = GetPieces();
+  for (Side side : {kWhite, kBlack}) {
+    Bitboard &blockers = check_info_.blockers[side];
+    blockers = kEmptyBoard;
+    if (GetPieces(side, kKing).GetCount() != 1) {
+      // Only partial positions, e.g., in tests, lack a single king.
+      continue;
+    }
+
+    // The enemy sliders that would attack the king on an empty board. Any
+    // slider with exactly one piece in between pins or blocks that piece.
+    const Square king = GetKing(side);
+    const Side enemy = ~side;
+    const Bitboard queens = GetPieces(enemy, kQueen);
+    Bitboard snipers =
+        (GenerateAttacks<kRook>(king, kEmptyBoard) &
+         (GetPieces(enemy, kRook) | queens)) |
+        (GenerateAttacks<kBishop>(king, kEmptyBoard) &
+         (GetPieces(enemy, kBishop) | queens));
+    while (snipers) {
+      const Square sniper = snipers.PopLeastSignificantBit();
+      const Bitboard between =
+          GetLine(sniper, king) & ~Bitboard(sniper) & occupied;
+      if (between.GetCount() == 1) {
+        blockers |= between;
+      }
+    }
+  }
+  check_info_.has_blockers = true;
+}
+
+void Position::ComputeCheckSquares() const {
+  std::array<Bitboard, kNumPieces> &squares = check_info_.check_squares;
+  const Side them = ~side_to_move_;
+  const Square king = GetKing(them);
+  const Bitboard occupied = GetPieces();
+
+  // A pawn of the side to move checks from the squares that a pawn of the
+  // other side on the king's square would attack.
+  squares[kPawn] = GetPawnAttacks(king, them);
+  squares[kKnight] = GenerateAttacks<kKnight>(king, occupied);
+  squares[kBishop] = GenerateAttacks<kBishop>(king, occupied);
+  squares[kRook] = GenerateAttacks<kRook>(king, occupied);
+  squares[kQueen] = squares[kBishop] | squares[kRook];
+  squares[kKing] = kEmptyBoard;
+  check_info_.has_check_squares = true;
+}
+
+Bitboard Position::ComputeAttackedSquares(Side by) const {
+  return FindAttackedSquares(*this, by);
+}
+
+bool Position::GivesCheck(Move move) const {
+  const Side us = side_to_move_;
+  const Square from = move.GetFrom();
+  const Square to = move.GetTo();
+  const Square king = GetKing(~us);
+
+  if (!check_info_.has_check_squares) {
+    ComputeCheckSquares();
+  }
+  if (!move.IsPromotion() &&
+      check_info_.check_squares[GetPiece(from)].Get(to)) {
+    return true;
+  }
+
+  // The moving piece uncovers a slider, unless it stays on the line.
+  if (GetBlockers(~us).Get(from) && !AreAligned(king, from, to)) {
+    return true;
+  }
+
+  if (move.IsPromotion()) {
+    // The promoted piece may attack through the square that the pawn left.
+    return GeneratePieceAttacks(move.GetPromotedPiece(), to,
+                                GetPieces() & ~Bitboard(from))
+        .Get(king);
+  }
+
+  if (move.IsEnPassantCapture()) {
+    // Removing two pawns from the board may uncover a slider even though
+    // neither pawn is a blocker on its own.
+    const Bitboard occupied =
+        (GetPieces() & ~Bitboard(from) & ~Bitboard(move.GetEnPassantVictim())) |
+        Bitboard(to);
+    const Bitboard queens = GetPieces(us, kQueen);
+    return (GenerateAttacks<kRook>(king, occupied) &
+            (GetPieces(us, kRook) | queens)) ||
+           (GenerateAttacks<kBishop>(king, occupied) &
+            (GetPieces(us, kBishop) | queens));
+  }
+
+  if (const Bitboard rook_mask = GetCastlingRookMask(move, us)) {
+    const Square rook_to = move.IsKingSideCastling()
+                               ? static_cast<Square>(from + 1)
+                               : static_cast<Square>(from - 1);
+    const Bitboard occupied =
+        (GetPieces() & ~Bitboard(from) & ~rook_mask) | Bitboard(to) |
+        Bitboard(rook_to);
+    return GenerateAttacks<kRook>(rook_to, occupied).Get(king);
+  }
+
+  return false;
+}
+
+bool Position::IsPseudoLegal(Move move) const {
+  const Side us = side_to_move_;
+  const Square from = move.GetFrom();
+  const Square to = move.GetTo();
+  if (!sides_[us].Get(from) || sides_[us].Get(to)) {
+    return false;
+  }
+
+  const Bitboard checkers = GetCheckers(us);
+  if (move.IsKingSideCastling() || move.IsQueenSideCastling()) {
+    // Castling out of check is not generated.
+    return !checkers && (us == kWhite ? IsCastlingPseudoLegal<kWhite>(move)
+                                      : IsCastlingPseudoLegal<kBlack>(move));
+  }
+
+  const Piece piece = GetPiece(from);
+  if (piece == kPawn) {
+    if (!IsPawnMovePseudoLegal(move)) {
+      return false;
+    }
+  } else {
+    // Other pieces only make plain moves and captures.
+    const Move::Flags flags =
+        sides_[~us].Get(to) ? Move::kCapture : Move::kNone;
+    const Bitboard attacks =
+        piece == kKing ? GenerateAttacks<kKing>(from, GetPieces())
+                       : GeneratePieceAttacks(piece, from, GetPieces());
+    if (move != Move(from, to, flags) || !attacks.Get(to)) {
+      return false;
+    }
+  }
+
+  // In check, the other pieces may only capture a single checker or block it.
+  // Pawn moves and king moves are generated unfiltered.
+  if (checkers && piece != kKing) {
+    if (checkers.GetCount() > 1) {
+      return false;
+    }
+    if (piece != kPawn &&
+        !((GetLine(checkers.LeastSignificantBit(), GetKing(us)) | checkers)
+              .Get(to))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Position::IsPawnMovePseudoLegal(Move move) const {
+  const Side us = side_to_move_;
+  const Square from = move.GetFrom();
+  const Square to = move.GetTo();
+  const int forward = us == kWhite ? -8 : 8;
+
+  // Moves to the last rank must promote, and no others may.
+  const int last_rank = us == kWhite ? 0 : 7;
+  if (move.IsPromotion() != (GetRank(to) == last_rank)) {
+    return false;
+  }
+
+  if (move.IsEnPassantCapture()) {
+    return en_passant_target_ == to && GetPawnAttacks(from, us).Get(to);
+  }
+  if (move.IsCapture()) {
+    // Two of the flag values with the capture bit are unused.
+    return (move.IsPromotion() || move == Move(from, to, Move::kCapture)) &&
+           sides_[~us].Get(to) && GetPawnAttacks(from, us).Get(to);
+  }
+
+  const Bitboard occupied = GetPieces();
+  if (to != from + forward || occupied.Get(to)) {
+    if (!move.IsDoublePawnPush()) {
+      return false;
+    }
+    const int start_rank = us == kWhite ? 6 : 1;
+    const auto middle = static_cast<Square>(from + forward);
+    return GetRank(from) == start_rank && to == middle + forward &&
+           !occupied.Get(middle) && !occupied.Get(to);
+  }
+  return !move.IsDoublePawnPush();
+}
+
+template <Side Side>
+bool Position::IsCastlingPseudoLegal(Move move) const {
+  // The castling rights imply that the king and the rook are on their
+  // starting squares.
+  const Bitboard occupied = GetPieces();
+
+  if (move.IsKingSideCastling()) {
+    const Bitboard path = GetKingSideCastlingPath<Side>();
+    return move == Move(Side == kWhite ? E1 : E8, Side == kWhite ? G1 : G8,
+                        Move::kKingCastle) &&
+           castling_rights_.HasKingSide<Side>() && !(occupied & path) &&
+           !(GetAttackedSquares(~Side) & path);
+  }
+
+  Bitboard path = GetQueenSideCastlingPath<Side>();
+  Bitboard king_path = path;
+  king_path.PopLeastSignificantBit();
+  return move == Move(Side == kWhite ? E1 : E8, Side == kWhite ? C1 : C8,
+                      Move::kQueenCastle) &&
+         castling_rights_.HasQueenSide<Side>() && !(occupied & path) &&
+         !(GetAttackedSquares(~Side) & king_path);
+}
+
+bool Position::IsLegal(Move move) const {
+  DCHECK(IsPseudoLegal(move));
+  const Side us = side_to_move_;
+  const Square from = move.GetFrom();
+  const Square to = move.GetTo();
+  const Square king = GetKing(us);
+
+  if (move.IsKingSideCastling() || move.IsQueenSideCastling()) {
+    // The path of the king was checked by IsPseudoLegal().
+    return true;
+  }
+
+  if (from == king) {
+    // The attacked squares are computed without the king, so that it cannot
+    // step back along the line of a slider that checks it.
+    return !GetAttackedSquares(~us).Get(to);
+  }
+
+  if (move.IsEnPassantCapture()) {
+    // Removing two pawns from a rank can uncover a slider, so the attacks
+    // are recomputed for the board after the capture.
+    const Bitboard occupied =
+        (GetPieces() & ~Bitboard(from) & ~Bitboard(move.GetEnPassantVictim())) |
+        Bitboard(to);
+    return !GetAttackers(king, ~us, occupied);
+  }
+
+  const Bitboard checkers = GetCheckers(us);
+  if (checkers) {
+    if (checkers.GetCount() > 1 ||
+        !(GetLine(checkers.LeastSignificantBit(), king) | checkers).Get(to)) {
+      return false;
+    }
+  }
+
+  // A pinned piece may only move along the line of its pin.
+  return !GetPinned(us).Get(from) || AreAligned(king, from, to);
+}
+
 namespace {
 
 std::expected<void, std::string> FillPiece(
@@ -278,76 +538,105 @@ std::expected<Position, std::string> Position::FromFen(std::string_view fen) {
   return Position::FromFen(absl::StrSplit(fen, absl::ByAsciiWhitespace()));
 }
 
-UndoInfo Position::Do(const Move &move) {
-  // TODO(aryann): Reset the half move clock if there was a pawn move.
-  Piece victim = GetPiece(move.GetTo());
+ExtendedMove Position::ExtendMove(Move move) const {
+  return ExtendedMove(move, GetPiece(move.GetFrom()),
+                      GetCapturedPiece(*this, move));
+}
+
+UndoInfo Position::Do(const Move &move) { return Do(ExtendMove(move)); }
+
+UndoInfo Position::Do(ExtendedMove move) {
+  return side_to_move_ == kWhite ? Do<kWhite>(move) : Do<kBlack>(move);
+}
+
+template <Side Side>
+UndoInfo Position::Do(Move move, Piece piece) {
+  return Do<Side>(ExtendedMove(move, piece, GetCapturedPiece(*this, move)));
+}
+
+template <Side Side>
+UndoInfo Position::Do(ExtendedMove extended_move) {
+  static constexpr auto kThem = ~Side;
+  const Move move = extended_move.GetMove();
+  const Piece piece = extended_move.GetPiece();
+  DCHECK(side_to_move_ == Side);
+  DCHECK(piece != kEmptyPiece);
+  DCHECK(GetPiece(move.GetFrom()) == piece);
+  DCHECK(GetSide(move.GetFrom()) == Side);
+
+  const Square from = move.GetFrom();
+  const Square to = move.GetTo();
+
+  // The en passant victim is not on the destination square. It is removed
+  // below.
+  const Piece victim = move.IsEnPassantCapture()
+                           ? kEmptyPiece
+                           : extended_move.GetCapturedPiece();
+  DCHECK(GetPiece(to) == victim);
   const UndoInfo undo_info = {
       .move = move,
+      .en_passant_target = en_passant_target_,
       .captured_piece = victim,
+      .piece = piece,
       .half_moves = half_moves_,
-      .en_passant_target = en_passant_target_,
       .castling_rights = castling_rights_,
   };
 
+  // Pawn moves and captures, including en passant, reset the half move
+  // clock.
   if (victim == kEmptyPiece) {
-    ++half_moves_;
+    half_moves_ = piece == kPawn ? 0 : half_moves_ + 1;
   } else {
-    DCHECK(GetSide(move.GetTo()) == ~side_to_move_);
+    DCHECK(GetSide(to) == kThem);
 
-    pieces_[victim].Clear(move.GetTo());
-    sides_[~side_to_move_].Clear(move.GetTo());
+    pieces_[victim].Clear(to);
+    sides_[kThem].Clear(to);
     half_moves_ = 0;
-    zobrist_key_.Update(move.GetTo(), victim, ~side_to_move_);
+    UpdateKeys(to, victim, kThem);
   }
 
-  Piece piece = GetPiece(move.GetFrom());
-  DCHECK(piece != kEmptyPiece);
-  zobrist_key_.Update(move.GetFrom(), piece, side_to_move_);
-  zobrist_key_.Update(move.GetTo(), piece, side_to_move_);
+  UpdateKeys(from, piece, Side);
+  UpdateKeys(to, piece, Side);
 
   if (move.IsEnPassantCapture()) {
     Square en_passant_victim = move.GetEnPassantVictim();
     pieces_[kPawn].Clear(en_passant_victim);
-    sides_[~side_to_move_].Clear(en_passant_victim);
-    zobrist_key_.Update(en_passant_victim, kPawn, ~side_to_move_);
-    half_moves_ = 0;
+    sides_[kThem].Clear(en_passant_victim);
+    UpdateKeys(en_passant_victim, kPawn, kThem);
   }
 
-  Bitboard from_to = Bitboard(move.GetFrom()) | Bitboard(move.GetTo());
+  Bitboard from_to = Bitboard(from) | Bitboard(to);
   pieces_[piece] ^= from_to;
-
-  Side side = GetSide(move.GetFrom());
-  DCHECK(side != kEmptySide);
-  sides_[side] ^= from_to;
+  sides_[Side] ^= from_to;
 
   if (move.IsPromotion()) {
-    pieces_[kPawn].Clear(move.GetTo());
-    pieces_[move.GetPromotedPiece()].Set(move.GetTo());
-    zobrist_key_.Update(move.GetTo(), kPawn, side_to_move_);
-    zobrist_key_.Update(move.GetTo(), move.GetPromotedPiece(), side_to_move_);
+    pieces_[kPawn].Clear(to);
+    pieces_[move.GetPromotedPiece()].Set(to);
+    UpdateKeys(to, kPawn, Side);
+    UpdateKeys(to, move.GetPromotedPiece(), Side);
   }
 
   // Non-empty if and only if the move is a castling move.
   //
   // TODO(aryann): The Do() and Undo() castling logic can be shared.
-  Bitboard rook_mask = GetCastlingRookMask(move, side);
+  Bitboard rook_mask = GetCastlingRookMask(move, Side);
   DCHECK(!rook_mask || move.IsKingSideCastling() || move.IsQueenSideCastling());
   pieces_[kRook] ^= rook_mask;
-  sides_[side] ^= rook_mask;
+  sides_[Side] ^= rook_mask;
   while (rook_mask) {
     Square square = rook_mask.PopLeastSignificantBit();
-    zobrist_key_.Update(square, kRook, side_to_move_);
+    UpdateKeys(square, kRook, Side);
   }
 
   zobrist_key_.ToggleCastlingRights(castling_rights_);
-  castling_rights_.InvalidateOnMove(move.GetFrom());
-  castling_rights_.InvalidateOnMove(move.GetTo());
+  castling_rights_.InvalidateOnMove(from);
+  castling_rights_.InvalidateOnMove(to);
   zobrist_key_.ToggleCastlingRights(castling_rights_);
 
-  if (side_to_move_ == kBlack) {
+  if constexpr (Side == kBlack) {
     ++full_moves_;
   }
-  side_to_move_ = ~side_to_move_;
+  side_to_move_ = kThem;
 
   zobrist_key_.ToggleEnPassantTarget(en_passant_target_);
   if (move.IsDoublePawnPush()) {
@@ -358,11 +647,32 @@ UndoInfo Position::Do(const Move &move) {
   }
 
   zobrist_key_.UpdateSideToMove();
+  check_info_.Invalidate();
   return undo_info;
 }
 
+template UndoInfo Position::Do<kWhite>(Move move, Piece piece);
+template UndoInfo Position::Do<kBlack>(Move move, Piece piece);
+template UndoInfo Position::Do<kWhite>(ExtendedMove move);
+template UndoInfo Position::Do<kBlack>(ExtendedMove move);
+
+void Position::Undo(const UndoInfo &undo_info) {
+  if (side_to_move_ == kBlack) {
+    Undo<kWhite>(undo_info);
+  } else {
+    Undo<kBlack>(undo_info);
+  }
+}
+
+template <Side Side>
 void Position::Undo(const UndoInfo &undo_info) {
+  static constexpr auto kThem = ~Side;
+  DCHECK(side_to_move_ == kThem);
+
   const Move &move = undo_info.move;
+  const Square from = move.GetFrom();
+  const Square to = move.GetTo();
+  const Piece piece = undo_info.piece;
 
   zobrist_key_.ToggleEnPassantTarget(en_passant_target_);
   en_passant_target_ = undo_info.en_passant_target;
@@ -372,59 +682,58 @@ void Position::Undo(const UndoInfo &undo_info) {
   castling_rights_ = undo_info.castling_rights;
   zobrist_key_.ToggleCastlingRights(castling_rights_);
 
-  side_to_move_ = ~side_to_move_;
+  side_to_move_ = Side;
 
   if (move.IsPromotion()) {
-    pieces_[move.GetPromotedPiece()].Clear(move.GetTo());
-    pieces_[kPawn].Set(move.GetTo());
-    zobrist_key_.Update(move.GetTo(), kPawn, side_to_move_);
-    zobrist_key_.Update(move.GetTo(), move.GetPromotedPiece(), side_to_move_);
+    pieces_[move.GetPromotedPiece()].Clear(to);
+    pieces_[kPawn].Set(to);
+    UpdateKeys(to, kPawn, Side);
+    UpdateKeys(to, move.GetPromotedPiece(), Side);
   }
 
-  Bitboard from_to = Bitboard(move.GetFrom()) | Bitboard(move.GetTo());
-
-  Piece piece = GetPiece(move.GetTo());
-  DCHECK(piece != kEmptyPiece);
-  zobrist_key_.Update(move.GetFrom(), piece, side_to_move_);
-  zobrist_key_.Update(move.GetTo(), piece, side_to_move_);
+  DCHECK(GetPiece(to) == piece);
+  UpdateKeys(from, piece, Side);
+  UpdateKeys(to, piece, Side);
 
+  Bitboard from_to = Bitboard(from) | Bitboard(to);
   pieces_[piece] ^= from_to;
-
-  Side side = GetSide(move.GetTo());
-  DCHECK(side != kEmptySide);
-  sides_[side] ^= from_to;
+  sides_[Side] ^= from_to;
 
   if (move.IsEnPassantCapture()) {
     Square en_passant_victim = move.GetEnPassantVictim();
-    pieces_[kPawn].Set(move.GetEnPassantVictim());
-    sides_[~side].Set(move.GetEnPassantVictim());
-    zobrist_key_.Update(en_passant_victim, kPawn, ~side_to_move_);
+    pieces_[kPawn].Set(en_passant_victim);
+    sides_[kThem].Set(en_passant_victim);
+    UpdateKeys(en_passant_victim, kPawn, kThem);
   }
 
   if (undo_info.captured_piece != kEmptyPiece) {
     // Restores a non-passant captured piece.
-    pieces_[undo_info.captured_piece].Set(move.GetTo());
-    sides_[~side].Set(move.GetTo());
-    zobrist_key_.Update(move.GetTo(), undo_info.captured_piece, ~side);
+    pieces_[undo_info.captured_piece].Set(to);
+    sides_[kThem].Set(to);
+    UpdateKeys(to, undo_info.captured_piece, kThem);
   }
 
   // Non-empty if and only if the move is a castling move.
-  Bitboard rook_mask = GetCastlingRookMask(move, side);
+  Bitboard rook_mask = GetCastlingRookMask(move, Side);
   DCHECK(!rook_mask || move.IsKingSideCastling() || move.IsQueenSideCastling());
   pieces_[kRook] ^= rook_mask;
-  sides_[side] ^= rook_mask;
+  sides_[Side] ^= rook_mask;
   while (rook_mask) {
     Square square = rook_mask.PopLeastSignificantBit();
-    zobrist_key_.Update(square, kRook, side_to_move_);
+    UpdateKeys(square, kRook, Side);
   }
 
-  if (side == kBlack) {
+  if constexpr (Side == kBlack) {
     --full_moves_;
   }
   half_moves_ = undo_info.half_moves;
   zobrist_key_.UpdateSideToMove();
+  check_info_.Invalidate();
 }
 
+template void Position::Undo<kWhite>(const UndoInfo &undo_info);
+template void Position::Undo<kBlack>(const UndoInfo &undo_info);
+
 void Position::InitKey() {
   for (int i = 0; i < kNumSquares; ++i) {
     const auto square = static_cast<Square>(i);
@@ -433,7 +742,7 @@ void Position::InitKey() {
       continue;
     }
 
-    zobrist_key_.Update(square, piece, GetSide(square));
+    UpdateKeys(square, piece, GetSide(square));
   }
 
   if (side_to_move_ == kBlack) {
@@ -51,8 +51,68 @@ class Position {
   // Returns the king for the side to move.
   [[nodiscard]] Square GetKing(Side side) const;
 
-  // Returns the king checkers for the side to move.
-  [[nodiscard]] Bitboard GetCheckers(Side of) const;
+  // Returns the pieces that give check to the king of `of`. The checkers of
+  // the side to move are computed once per position and then cached.
+  [[nodiscard]] Bitboard GetCheckers(Side of) const {
+    if (of != side_to_move_) {
+      return ComputeCheckers(of);
+    }
+    if (!check_info_.has_checkers) {
+      check_info_.checkers = ComputeCheckers(of);
+      check_info_.has_checkers = true;
+    }
+    return check_info_.checkers;
+  }
+
+  // Returns the pieces of either side that are the only piece between the king
+  // of `king_side` and an enemy rook, bishop or queen. Moving such a piece off
+  // the line exposes the king to the slider. The blockers are computed once
+  // per position and then cached.
+  [[nodiscard]] Bitboard GetBlockers(Side king_side) const {
+    if (!check_info_.has_blockers) {
+      ComputeBlockers();
+    }
+    return check_info_.blockers[king_side];
+  }
+
+  // Returns the pieces of `side` that are pinned to their own king.
+  [[nodiscard]] Bitboard GetPinned(Side side) const {
+    return GetBlockers(side) & sides_[side];
+  }
+
+  // Returns the squares that the pieces of `by` attack. The enemy king does
+  // not block sliders, so that the squares behind it on a checking line count
+  // as attacked: the king cannot escape by stepping along the line. The
+  // squares attacked by the side not to move are computed once per position
+  // and then cached.
+  [[nodiscard]] Bitboard GetAttackedSquares(Side by) const {
+    if (by == side_to_move_) {
+      return ComputeAttackedSquares(by);
+    }
+    if (!check_info_.has_attacked) {
+      check_info_.attacked = ComputeAttackedSquares(by);
+      check_info_.has_attacked = true;
+    }
+    return check_info_.attacked;
+  }
+
+  // Returns true if `move`, which must be pseudo-legal for the side to move,
+  // checks the enemy king, either directly or by uncovering a slider. The move
+  // is not made.
+  [[nodiscard]] bool GivesCheck(Move move) const;
+
+  // Returns true if GenerateMoves() would generate `move` in this position.
+  // This validates moves from other sources, such as the transposition table,
+  // which may belong to a different position after a key collision.
+  [[nodiscard]] bool IsPseudoLegal(Move move) const;
+
+  // Returns true if `move`, which must be pseudo-legal, does not leave the king
+  // of the side to move in check.
+  [[nodiscard]] bool IsLegal(Move move) const;
+
+  // Returns `move` together with the pieces that it moves and captures in this
+  // position.
+  [[nodiscard]] ExtendedMove ExtendMove(Move move) const;
 
   [[nodiscard]] const CastlingRights &GetCastlingRights() const {
     return castling_rights_;
@@ -70,10 +130,30 @@ class Position {
 
   UndoInfo Do(const Move &move);
 
+  // Like Do(), for moves that carry their pieces, which need not be looked up.
+  UndoInfo Do(ExtendedMove move);
+
+  // Like Do(), for callers that know the side to move at compile time, such
+  // as those templated on the side, and the piece on the move's from square.
+  template <Side Side>
+  UndoInfo Do(Move move, Piece piece);
+
+  template <Side Side>
+  UndoInfo Do(ExtendedMove move);
+
+  void Undo(const UndoInfo &undo_info);
+
+  // Like Undo(), for callers that know that `Side` made the move.
+  template <Side Side>
   void Undo(const UndoInfo &undo_info);
 
   [[nodiscard]] std::uint64_t GetKey() const { return zobrist_key_.GetKey(); }
 
+  // Returns a Zobrist key over the pawns only. Positions with the same pawn
+  // structure share a pawn key, which makes it suitable for caching pawn
+  // evaluation terms.
+  [[nodiscard]] std::uint64_t GetPawnKey() const { return pawn_key_.GetKey(); }
+
  private:
   Position()
       : side_to_move_(kWhite),
@@ -83,6 +163,33 @@ class Position {
 
   void InitKey();
 
+  [[nodiscard]] Bitboard ComputeCheckers(Side king_side) const;
+
+  // Returns the pieces of `by` that would attack `to` if `occupied` were the
+  // occupied squares. Pieces off `occupied` are ignored.
+  [[nodiscard]] Bitboard GetAttackers(Square to, Side by,
+                                      Bitboard occupied) const;
+
+  [[nodiscard]] bool IsPawnMovePseudoLegal(Move move) const;
+
+  template <Side Side>
+  [[nodiscard]] bool IsCastlingPseudoLegal(Move move) const;
+
+  void ComputeBlockers() const;
+
+  void ComputeCheckSquares() const;
+
+  [[nodiscard]] Bitboard ComputeAttackedSquares(Side by) const;
+
+  // Toggles the piece on the square in the position key and, if the piece is
+  // a pawn, in the pawn key.
+  void UpdateKeys(Square square, Piece piece, Side side) {
+    zobrist_key_.Update(square, piece, side);
+    if (piece == kPawn) {
+      pawn_key_.Update(square, piece, side);
+    }
+  }
+
   std::array<Bitboard, kNumPieces> pieces_;
   std::array<Bitboard, kNumSides> sides_;
 
@@ -95,6 +202,38 @@ class Position {
   int full_moves_;
 
   ZobristKey zobrist_key_;
+  ZobristKey pawn_key_;
+
+  // Check information that is derived from the board on first use. Do() and
+  // Undo() invalidate it. Since it is derived, it does not take part in
+  // comparisons. Because const methods fill it in, threads must not share a
+  // Position without copying it.
+  struct CheckInfo {
+    bool operator==(const CheckInfo &) const { return true; }
+
+    void Invalidate() {
+      has_checkers = false;
+      has_blockers = false;
+      has_check_squares = false;
+      has_attacked = false;
+    }
+
+    Bitboard checkers;
+    std::array<Bitboard, kNumSides> blockers;
+
+    // The squares from which each piece of the side to move would check the
+    // enemy king.
+    std::array<Bitboard, kNumPieces> check_squares;
+
+    // The squares attacked by the side not to move.
+    Bitboard attacked;
+
+    bool has_checkers = false;
+    bool has_blockers = false;
+    bool has_check_squares = false;
+    bool has_attacked = false;
+  };
+  mutable CheckInfo check_info_;
 };
 
 }  // namespace follychess
@@ -3,8 +3,14 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <expected>
+#include <format>
+#include <random>
+#include <string_view>
+#include <vector>
 
+#include "engine/move_generator.h"
 #include "engine/testing.h"
 #include "scoped_move.h"
 
@@ -190,7 +196,7 @@ TEST(Position, DoAndUndo) {
       "1: R . B Q K B N R"
       "   a b c d e f g h"
       //
-      "   w KQkq d6 2 2";
+      "   w KQkq d6 0 2";
 
   std::string_view position_three =
       "8: r n b q k b n r"
@@ -224,6 +230,27 @@ TEST(Position, DoAndUndo) {
   EXPECT_THAT(position, EqualsPosition(kStartingPosition));
 }
 
+TEST(Position, PawnMovesResetHalfMoves) {
+  Position position =
+      Position::FromFen("4k3/4p3/8/8/8/8/4P3/4K3 w - - 10 20").value();
+
+  UndoInfo king_move = position.Do(Move(E1, D1));
+  EXPECT_THAT(position.GetHalfMoves(), Eq(11));
+
+  UndoInfo pawn_move = position.Do(Move(E7, E6));
+  EXPECT_THAT(position.GetHalfMoves(), Eq(0));
+
+  UndoInfo double_push =
+      position.Do(Move(E2, E4, Move::Flags::kDoublePawnPush));
+  EXPECT_THAT(position.GetHalfMoves(), Eq(0));
+
+  position.Undo(double_push);
+  position.Undo(pawn_move);
+  EXPECT_THAT(position.GetHalfMoves(), Eq(11));
+  position.Undo(king_move);
+  EXPECT_THAT(position.GetHalfMoves(), Eq(10));
+}
+
 TEST(GetPieces, StartingPosition) {
   Position position = Position::Starting();
 
@@ -898,6 +925,163 @@ TEST(GetCheckers, Pawns) {
   }
 }
 
+TEST(GetPinned, PinsAndDiscoveredAttacks) {
+  Position position = MakePosition(
+      "8: . . . . k . . ."
+      "7: . . . . r . . ."
+      "6: . . N . . . . ."
+      "5: . . . . N . . ."
+      "4: Q . . . . . . ."
+      "3: . . . B . . . ."
+      "2: . . . . . . . ."
+      "1: . . . . K . . ."
+      "   a b c d e f g h"
+      //
+      "   w - - 0 1");
+
+  // The rook pins the knight on e5. The bishop is not on a line between the
+  // king and a black slider.
+  EXPECT_THAT(position.GetPinned(kWhite), Eq(Bitboard(E5)));
+  EXPECT_THAT(position.GetBlockers(kWhite), Eq(Bitboard(E5)));
+
+  // The knight on c6 blocks the queen's diagonal towards the black king. It is
+  // not pinned, but moving it gives a discovered check.
+  EXPECT_THAT(position.GetPinned(kBlack), Eq(kEmptyBoard));
+  EXPECT_THAT(position.GetBlockers(kBlack), Eq(Bitboard(C6)));
+}
+
+TEST(GetPinned, UpdatesOnDoAndUndo) {
+  Position position = MakePosition(
+      "8: . . . . k . . ."
+      "7: . . . . . . . ."
+      "6: . . . . . . . ."
+      "5: . . . . . . . ."
+      "4: . b . . . . . ."
+      "3: . . . . . . . ."
+      "2: . . . P . . . ."
+      "1: . . . . K . . ."
+      "   a b c d e f g h"
+      //
+      "   w - - 0 1");
+  EXPECT_THAT(position.GetPinned(kWhite), Eq(Bitboard(D2)));
+  EXPECT_THAT(position.GetCheckers(kWhite), Eq(kEmptyBoard));
+
+  const UndoInfo undo_info = position.Do(Move(E1, F2));
+  EXPECT_THAT(position.GetPinned(kWhite), Eq(kEmptyBoard));
+
+  const UndoInfo check = position.Do(Move(B4, C5));
+  EXPECT_THAT(position.GetCheckers(kWhite), Eq(Bitboard(C5)));
+  EXPECT_THAT(position.GetCheckers(kBlack), Eq(kEmptyBoard));
+
+  position.Undo(check);
+  position.Undo(undo_info);
+  EXPECT_THAT(position.GetPinned(kWhite), Eq(Bitboard(D2)));
+}
+
+TEST(GetAttackedSquares, SeesThroughTheEnemyKing) {
+  Position position = MakePosition(
+      "8: . . . . k . . ."
+      "7: . . . . . . . ."
+      "6: . . . . . . . ."
+      "5: . . . . . . . ."
+      "4: . . . . . . . ."
+      "3: . . . . . . . ."
+      "2: . . . . . . P ."
+      "1: r . . K . . . ."
+      "   a b c d e f g h"
+      //
+      "   w - - 0 1");
+
+  // The rook checks the king on d1 and also attacks e1 behind it, so that the
+  // king cannot step away along the rank.
+  const Bitboard by_black = position.GetAttackedSquares(kBlack);
+  EXPECT_TRUE(by_black.Get(E1));
+  EXPECT_TRUE(by_black.Get(H1));
+  EXPECT_TRUE(by_black.Get(A8));
+  EXPECT_FALSE(by_black.Get(D2));
+
+  // The white pawn attacks diagonally forward on both sides.
+  const Bitboard by_white = position.GetAttackedSquares(kWhite);
+  EXPECT_TRUE(by_white.Get(F3));
+  EXPECT_TRUE(by_white.Get(H3));
+  EXPECT_FALSE(by_white.Get(G3));
+  EXPECT_FALSE(by_white.Get(H2));
+}
+
+TEST(GetAttackedSquares, MatchesGetAttackers) {
+  const Position position =
+      Position::FromFen(
+          "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1")
+          .value();
+  for (Side side : {kWhite, kBlack}) {
+    const Bitboard attacked = position.GetAttackedSquares(side);
+    for (int square = 0; square < kNumSquares; ++square) {
+      EXPECT_THAT(attacked.Get(static_cast<Square>(square)),
+                  Eq(static_cast<bool>(position.GetAttackers(
+                      static_cast<Square>(square), side))))
+          << std::format("{} {}", side == kWhite ? "white" : "black",
+                         static_cast<Square>(square));
+    }
+  }
+}
+
+// Plays random games from positions with castling, en passant and promotion
+// moves, and checks IsPseudoLegal() against every encodable move and
+// IsLegal() against making each generated move.
+TEST(IsPseudoLegal, RandomPlayouts) {
+  constexpr std::string_view kFens[] = {
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+      "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+      "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+      "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+  };
+  constexpr int kPlayoutsPerFen = 3;
+  constexpr int kMaxPlies = 40;
+
+  std::mt19937 random(0);
+  for (std::string_view fen : kFens) {
+    for (int playout = 0; playout < kPlayoutsPerFen; ++playout) {
+      Position position = Position::FromFen(fen).value();
+      for (int ply = 0; ply < kMaxPlies; ++ply) {
+        std::vector<Move> moves = GenerateMoves(position);
+        std::ranges::sort(moves);
+
+        for (int from = 0; from < kNumSquares; ++from) {
+          for (int to = 0; to < kNumSquares; ++to) {
+            for (int flags = 0; flags < 16; ++flags) {
+              const Move move(static_cast<Square>(from),
+                              static_cast<Square>(to),
+                              static_cast<Move::Flags>(flags));
+              ASSERT_THAT(position.IsPseudoLegal(move),
+                          Eq(std::ranges::binary_search(moves, move)))
+                  << std::format("{:f}\n{}", move, position);
+            }
+          }
+        }
+
+        std::vector<Move> legal_moves;
+        for (Move move : moves) {
+          const bool is_legal = position.IsLegal(move);
+          ScopedMove scoped_move(move, position);
+          ASSERT_THAT(
+              is_legal,
+              Eq(!position.GetCheckers(~position.SideToMove())))
+              << std::format("{:f}", move);
+          if (is_legal) {
+            legal_moves.push_back(move);
+          }
+        }
+        if (legal_moves.empty()) {
+          break;
+        }
+        position.Do(legal_moves[std::uniform_int_distribution<std::size_t>(
+            0, legal_moves.size() - 1)(random)]);
+      }
+    }
+  }
+}
+
 TEST(EnPassant, White) {
   Position position = Position::Starting();
 
@@ -1024,7 +1208,7 @@ TEST(QuietPromotion, White) {
                                          "1: . . . . . . . ."
                                          "   a b c d e f g h"
                                          //
-                                         "   b KQkq - 1 1"));
+                                         "   b KQkq - 0 1"));
   }
   EXPECT_THAT(position, EqualsPosition("8: . . . . . . . ."
                                        "7: . . . P . . . ."
@@ -1080,7 +1264,7 @@ TEST(QuietPromotion, Black) {
                                          "1: . . . . . . . q"
                                          "   a b c d e f g h"
                                          //
-                                         "   w Qkq - 1 2"));
+                                         "   w Qkq - 0 2"));
   }
   EXPECT_THAT(position, EqualsPosition("8: . . . . . . . ."
                                        "7: . . . . . . . ."
@@ -1305,5 +1489,82 @@ TEST(Position, Key) {
   EXPECT_THAT(position.GetKey(), Eq(v0));
 }
 
+TEST(Position, PawnKey) {
+  Position position = Position::Starting();
+  std::uint64_t v0 = position.GetPawnKey();
+
+  {
+    ScopedMove knight_move(Move(B1, C3), position);
+    EXPECT_THAT(position.GetPawnKey(), Eq(v0));
+
+    {
+      ScopedMove pawn_move(Move(E7, E5, Move::Flags::kDoublePawnPush),
+                           position);
+      std::uint64_t v1 = position.GetPawnKey();
+      EXPECT_THAT(v1, Not(Eq(v0)));
+
+      {
+        ScopedMove another_knight_move(Move(G1, F3), position);
+        EXPECT_THAT(position.GetPawnKey(), Eq(v1));
+      }
+      EXPECT_THAT(position.GetPawnKey(), Eq(v1));
+    }
+
+    EXPECT_THAT(position.GetPawnKey(), Eq(v0));
+  }
+
+  EXPECT_THAT(position.GetPawnKey(), Eq(v0));
+}
+
+TEST(Position, PawnKeyMatchesFen) {
+  Position position = MakePosition(
+      "8: . . . . k . . ."
+      "7: . P . . . . . ."
+      "6: . . . . . . . ."
+      "5: . . . P p . . ."
+      "4: . . . . . . . ."
+      "3: . . . . . . . ."
+      "2: . . . . . . . ."
+      "1: . . . . K . . ."
+      "   a b c d e f g h"
+      //
+      "   w - e6 0 1");
+
+  {
+    ScopedMove en_passant(Move(D5, E6, Move::Flags::kEnPassantCapture),
+                          position);
+    EXPECT_THAT(position.GetPawnKey(),
+                Eq(MakePosition("8: . . . . k . . ."
+                                "7: . P . . . . . ."
+                                "6: . . . . P . . ."
+                                "5: . . . . . . . ."
+                                "4: . . . . . . . ."
+                                "3: . . . . . . . ."
+                                "2: . . . . . . . ."
+                                "1: . . . . K . . ."
+                                "   a b c d e f g h"
+                                //
+                                "   b - - 0 1")
+                       .GetPawnKey()));
+  }
+
+  {
+    ScopedMove promotion(Move(B7, B8, Move::Flags::kQueenPromotion), position);
+    EXPECT_THAT(position.GetPawnKey(),
+                Eq(MakePosition("8: . Q . . k . . ."
+                                "7: . . . . . . . ."
+                                "6: . . . . . . . ."
+                                "5: . . . P p . . ."
+                                "4: . . . . . . . ."
+                                "3: . . . . . . . ."
+                                "2: . . . . . . . ."
+                                "1: . . . . K . . ."
+                                "   a b c d e f g h"
+                                //
+                                "   b - - 0 1")
+                       .GetPawnKey()));
+  }
+}
+
 }  // namespace
 }  // namespace follychess
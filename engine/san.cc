@@ -0,0 +1,228 @@
+#include "engine/san.h"
+
+#include <expected>
+#include <format>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "engine/move.h"
+#include "engine/move_generator.h"
+#include "engine/move_list.h"
+#include "engine/position.h"
+#include "engine/types.h"
+
+namespace follychess {
+namespace {
+
+std::optional<Piece> ParsePiece(char input) {
+  switch (input) {
+    case 'N':
+      return kKnight;
+    case 'B':
+      return kBishop;
+    case 'R':
+      return kRook;
+    case 'Q':
+      return kQueen;
+    case 'K':
+      return kKing;
+    default:
+      return std::nullopt;
+  }
+}
+
+// The parts of a non-castling SAN move. Squares that are only partially given
+// for disambiguation leave the rest unset.
+struct SanMove {
+  Piece piece = kPawn;
+  std::optional<int> from_file;
+  std::optional<int> from_rank;
+  Square to = A8;
+  std::optional<Piece> promotion;
+};
+
+std::optional<SanMove> Parse(std::string_view input) {
+  SanMove move;
+  if (!input.empty()) {
+    if (std::optional<Piece> piece = ParsePiece(input.front())) {
+      move.piece = *piece;
+      input.remove_prefix(1);
+    }
+  }
+
+  // Promotions are written both as "e8=Q" and as "e8Q".
+  if (move.piece == kPawn && !input.empty()) {
+    if (std::optional<Piece> promotion = ParsePiece(input.back());
+        promotion && *promotion != kKing) {
+      move.promotion = promotion;
+      input.remove_suffix(1);
+      if (input.ends_with('=')) {
+        input.remove_suffix(1);
+      }
+    }
+  }
+
+  if (input.size() < 2) {
+    return std::nullopt;
+  }
+  std::optional<Square> to = ParseSquare(input.substr(input.size() - 2));
+  if (!to) {
+    return std::nullopt;
+  }
+  move.to = *to;
+  input.remove_suffix(2);
+
+  if (input.ends_with('x')) {
+    input.remove_suffix(1);
+  }
+  for (char c : input) {
+    if (c >= 'a' && c <= 'h' && !move.from_file) {
+      move.from_file = c - 'a';
+    } else if (c >= '1' && c <= '8' && !move.from_rank) {
+      move.from_rank = 8 - (c - '0');
+    } else {
+      return std::nullopt;
+    }
+  }
+  return move;
+}
+
+constexpr char kPieceChars[] = {'P', 'N', 'B', 'R', 'Q', 'K'};
+
+bool HasLegalMove(const Position &position) {
+  MoveList moves;
+  GenerateMoves(position, moves);
+  for (Move move : moves) {
+    if (position.IsLegal(move)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Matches(const Position &position, const SanMove &san, Move move) {
+  const Square from = move.GetFrom();
+  if (move.GetTo() != san.to || position.GetPiece(from) != san.piece ||
+      move.IsKingSideCastling() || move.IsQueenSideCastling()) {
+    return false;
+  }
+  if ((san.from_file && GetFile(from) != *san.from_file) ||
+      (san.from_rank && GetRank(from) != *san.from_rank)) {
+    return false;
+  }
+  if (move.IsPromotion() != san.promotion.has_value()) {
+    return false;
+  }
+  return !move.IsPromotion() || move.GetPromotedPiece() == *san.promotion;
+}
+
+}  // namespace
+
+std::expected<Move, std::string> ParseSan(const Position &position,
+                                          std::string_view san) {
+  std::string_view input = san;
+  while (!input.empty() && (input.back() == '+' || input.back() == '#' ||
+                            input.back() == '!' || input.back() == '?')) {
+    input.remove_suffix(1);
+  }
+
+  std::optional<Move::Flags> castling;
+  if (input == "O-O" || input == "0-0") {
+    castling = Move::kKingCastle;
+  } else if (input == "O-O-O" || input == "0-0-0") {
+    castling = Move::kQueenCastle;
+  }
+
+  std::optional<SanMove> parsed;
+  if (!castling) {
+    parsed = Parse(input);
+    if (!parsed) {
+      return std::unexpected(std::format("Invalid SAN move: {}", san));
+    }
+  }
+
+  MoveList moves;
+  GenerateMoves(position, moves);
+  std::optional<Move> match;
+  for (Move move : moves) {
+    const bool matches =
+        castling ? move == Move(move.GetFrom(), move.GetTo(), *castling)
+                 : Matches(position, *parsed, move);
+    if (!matches || !position.IsLegal(move)) {
+      continue;
+    }
+    if (match) {
+      return std::unexpected(std::format("Ambiguous SAN move: {}", san));
+    }
+    match = move;
+  }
+
+  if (!match) {
+    return std::unexpected(std::format("Illegal SAN move: {}", san));
+  }
+  return *match;
+}
+
+std::string ToSan(const Position &position, Move move) {
+  const Square from = move.GetFrom();
+  const Square to = move.GetTo();
+  const Piece piece = position.GetPiece(from);
+
+  std::string san;
+  if (move.IsKingSideCastling()) {
+    san = "O-O";
+  } else if (move.IsQueenSideCastling()) {
+    san = "O-O-O";
+  } else if (piece == kPawn) {
+    if (move.IsCapture()) {
+      san = std::format("{}x", ToString(from).front());
+    }
+    san += ToString(to);
+    if (move.IsPromotion()) {
+      san += std::format("={}", kPieceChars[move.GetPromotedPiece()]);
+    }
+  } else {
+    san.push_back(kPieceChars[piece]);
+
+    // Another piece of the same kind that can legally move to the same square
+    // calls for the file of the moving piece, or its rank if the files match,
+    // or both.
+    bool ambiguous = false;
+    bool same_file = false;
+    bool same_rank = false;
+    MoveList moves;
+    GenerateMoves(position, moves);
+    for (Move other : moves) {
+      const Square other_from = other.GetFrom();
+      if (other.GetTo() != to || other_from == from ||
+          position.GetPiece(other_from) != piece || !position.IsLegal(other)) {
+        continue;
+      }
+      ambiguous = true;
+      same_file |= GetFile(other_from) == GetFile(from);
+      same_rank |= GetRank(other_from) == GetRank(from);
+    }
+    const std::string from_name = ToString(from);
+    if (ambiguous && (!same_file || same_rank)) {
+      san.push_back(from_name[0]);
+    }
+    if (same_file) {
+      san.push_back(from_name[1]);
+    }
+
+    if (move.IsCapture()) {
+      san.push_back('x');
+    }
+    san += ToString(to);
+  }
+
+  Position child = position;
+  child.Do(move);
+  if (child.GetCheckers(child.SideToMove())) {
+    san.push_back(HasLegalMove(child) ? '+' : '#');
+  }
+  return san;
+}
+
+}  // namespace follychess
@@ -0,0 +1,28 @@
+#ifndef FOLLYCHESS_ENGINE_SAN_H_
+#define FOLLYCHESS_ENGINE_SAN_H_
+
+#include <expected>
+#include <string>
+#include <string_view>
+
+#include "engine/move.h"
+#include "engine/position.h"
+
+namespace follychess {
+
+// Parses a move in Standard Algebraic Notation (SAN), such as "Nbd7", "exd5",
+// "e8=Q+" or "O-O", and returns the legal move of `position` that it denotes.
+// Check and annotation suffixes are ignored, and castling may also be written
+// with zeros.
+//
+// Returns an error if the move is malformed, illegal or ambiguous.
+std::expected<Move, std::string> ParseSan(const Position &position,
+                                          std::string_view san);
+
+// Returns `move`, which must be legal in `position`, in Standard Algebraic
+// Notation, with a "+" or "#" suffix if it gives check or checkmate.
+std::string ToSan(const Position &position, Move move);
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_ENGINE_SAN_H_
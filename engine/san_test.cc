@@ -0,0 +1,155 @@
+#include "engine/san.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string_view>
+
+#include "absl/log/check.h"
+#include "engine/move.h"
+#include "engine/move_generator.h"
+#include "engine/position.h"
+
+namespace follychess {
+namespace {
+
+using ::testing::Eq;
+using ::testing::HasSubstr;
+
+Position FromFen(std::string_view fen) {
+  auto position = Position::FromFen(fen);
+  CHECK(position.has_value()) << position.error();
+  return *position;
+}
+
+TEST(ParseSan, PawnMoves) {
+  const Position start = Position::Starting();
+  EXPECT_THAT(ParseSan(start, "e4"), Eq(Move(E2, E4, Move::kDoublePawnPush)));
+  EXPECT_THAT(ParseSan(start, "e3"), Eq(Move(E2, E3)));
+
+  const Position position = FromFen(
+      "rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 2");
+  EXPECT_THAT(ParseSan(position, "exd5"), Eq(Move(E4, D5, Move::kCapture)));
+
+  const Position en_passant = FromFen(
+      "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3");
+  EXPECT_THAT(ParseSan(en_passant, "exf6"),
+              Eq(Move(E5, F6, Move::kEnPassantCapture)));
+}
+
+TEST(ParseSan, PieceMoves) {
+  const Position start = Position::Starting();
+  EXPECT_THAT(ParseSan(start, "Nf3"), Eq(Move(G1, F3)));
+  EXPECT_THAT(ParseSan(start, "Nc3!?"), Eq(Move(B1, C3)));
+
+  const Position position =
+      FromFen("r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - "
+              "4 4");
+  EXPECT_THAT(ParseSan(position, "Qxf7#"), Eq(Move(H5, F7, Move::kCapture)));
+  EXPECT_THAT(ParseSan(position, "Bxf7+"), Eq(Move(C4, F7, Move::kCapture)));
+}
+
+TEST(ParseSan, Disambiguation) {
+  const Position position = FromFen("4k3/8/8/8/8/8/4K3/R6R w - - 0 1");
+  EXPECT_THAT(ParseSan(position, "Rad1"), Eq(Move(A1, D1)));
+  EXPECT_THAT(ParseSan(position, "Rhd1"), Eq(Move(H1, D1)));
+  EXPECT_THAT(ParseSan(position, "Rd1").error_or(""),
+              Eq("Ambiguous SAN move: Rd1"));
+
+  const Position ranks = FromFen("4k3/8/8/R7/8/8/8/R3K3 w - - 0 1");
+  EXPECT_THAT(ParseSan(ranks, "R1a3"), Eq(Move(A1, A3)));
+  EXPECT_THAT(ParseSan(ranks, "R5a3"), Eq(Move(A5, A3)));
+  EXPECT_THAT(ParseSan(ranks, "Ra1a3"), Eq(Move(A1, A3)));
+}
+
+TEST(ParseSan, PinnedPiecesAreNotAmbiguous) {
+  // Both knights reach c3, but the one on e2 is pinned to the king.
+  const Position position = FromFen("4r1k1/8/8/8/8/8/4N3/1N2K3 w - - 0 1");
+  EXPECT_THAT(ParseSan(position, "Nc3"), Eq(Move(B1, C3)));
+}
+
+TEST(ParseSan, Castling) {
+  const Position position =
+      FromFen("r3k2r/pppqbppp/8/8/8/8/PPPQBPPP/R3K2R w KQkq - 0 1");
+  EXPECT_THAT(ParseSan(position, "O-O"), Eq(Move(E1, G1, Move::kKingCastle)));
+  EXPECT_THAT(ParseSan(position, "0-0-0+"),
+              Eq(Move(E1, C1, Move::kQueenCastle)));
+}
+
+TEST(ParseSan, Promotions) {
+  const Position position = FromFen("3r4/4P3/8/8/8/8/k7/4K3 w - - 0 1");
+  EXPECT_THAT(ParseSan(position, "e8=Q+"),
+              Eq(Move(E7, E8, Move::kQueenPromotion)));
+  EXPECT_THAT(ParseSan(position, "e8N"),
+              Eq(Move(E7, E8, Move::kKnightPromotion)));
+  EXPECT_THAT(ParseSan(position, "exd8=R"),
+              Eq(Move(E7, D8, Move::kRookPromotionCapture)));
+}
+
+TEST(ParseSan, Errors) {
+  const Position start = Position::Starting();
+  EXPECT_THAT(ParseSan(start, "").error_or(""), Eq("Invalid SAN move: "));
+  EXPECT_THAT(ParseSan(start, "Zf3").error_or(""),
+              Eq("Invalid SAN move: Zf3"));
+  EXPECT_THAT(ParseSan(start, "e5").error_or(""),
+              Eq("Illegal SAN move: e5"));
+  EXPECT_THAT(ParseSan(start, "O-O").error_or(""),
+              HasSubstr("Illegal SAN move"));
+}
+
+TEST(ToSan, Moves) {
+  const Position start = Position::Starting();
+  EXPECT_THAT(ToSan(start, Move(E2, E4, Move::kDoublePawnPush)), Eq("e4"));
+  EXPECT_THAT(ToSan(start, Move(G1, F3)), Eq("Nf3"));
+
+  const Position position =
+      FromFen("r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - "
+              "4 4");
+  EXPECT_THAT(ToSan(position, Move(H5, F7, Move::kCapture)), Eq("Qxf7#"));
+  EXPECT_THAT(ToSan(position, Move(C4, F7, Move::kCapture)), Eq("Bxf7+"));
+
+  const Position castling =
+      FromFen("r3k2r/pppqbppp/8/8/8/8/PPPQBPPP/R3K2R w KQkq - 0 1");
+  EXPECT_THAT(ToSan(castling, Move(E1, G1, Move::kKingCastle)), Eq("O-O"));
+  EXPECT_THAT(ToSan(castling, Move(E1, C1, Move::kQueenCastle)), Eq("O-O-O"));
+
+  const Position promotion = FromFen("3r4/4P3/8/8/8/8/k7/4K3 w - - 0 1");
+  EXPECT_THAT(ToSan(promotion, Move(E7, D8, Move::kQueenPromotionCapture)),
+              Eq("exd8=Q"));
+}
+
+TEST(ToSan, Disambiguation) {
+  const Position files = FromFen("4k3/8/8/8/8/8/4K3/R6R w - - 0 1");
+  EXPECT_THAT(ToSan(files, Move(A1, D1)), Eq("Rad1"));
+
+  const Position ranks = FromFen("4k3/8/8/R7/8/8/8/R3K3 w - - 0 1");
+  EXPECT_THAT(ToSan(ranks, Move(A1, A3)), Eq("R1a3"));
+
+  const Position both = FromFen("4k3/8/8/8/8/Q1Q5/8/Q3K3 w - - 0 1");
+  EXPECT_THAT(ToSan(both, Move(A3, B2)), Eq("Qa3b2"));
+
+  // The pinned knight on e2 does not make the move ambiguous.
+  const Position pinned = FromFen("4r1k1/8/8/8/8/8/4N3/1N2K3 w - - 0 1");
+  EXPECT_THAT(ToSan(pinned, Move(B1, C3)), Eq("Nc3"));
+}
+
+TEST(ToSan, RoundTrips) {
+  for (std::string_view fen : {
+           "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - "
+           "0 1",
+           "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+           "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+       }) {
+    const Position position = FromFen(fen);
+    for (Move move : GenerateMoves(position)) {
+      if (!position.IsLegal(move)) {
+        continue;
+      }
+      EXPECT_THAT(ParseSan(position, ToSan(position, move)), Eq(move))
+          << fen << " " << ToSan(position, move);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace follychess
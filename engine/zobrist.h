@@ -21,9 +21,14 @@ struct ZobristKeys {
   std::uint64_t black_to_move;
 };
 
+// The keys are generated from a fixed seed so that hashing, and therefore the
+// search, is reproducible from run to run. std::mt19937_64's output sequence is
+// fully specified by the standard, so the keys are also the same across
+// standard library implementations.
+inline constexpr std::uint64_t kZobristSeed = 0x9e3779b97f4a7c15ULL;
+
 inline ZobristKeys::ZobristKeys() : elements(), en_passant_files(), castling() {
-  std::mt19937 engine(std::random_device{}());
-  std::uniform_int_distribution<std::uint64_t> dist(0);
+  std::mt19937_64 engine(kZobristSeed);
 
   for (int i = 0; i < kNumSquares; ++i) {
     DCHECK_EQ(elements.size(), kNumSquares);
@@ -33,24 +38,24 @@ inline ZobristKeys::ZobristKeys() : elements(), en_passant_files(), castling() {
 
       for (int k = 0; k < kNumSides; ++k) {
         DCHECK_EQ(elements[i][j].size(), kNumSides);
-        elements[i][j][k] = dist(engine);
+        elements[i][j][k] = engine();
       }
     }
   }
 
   for (std::uint64_t& file : en_passant_files) {
-    file = dist(engine);
+    file = engine();
   }
 
   for (std::uint64_t& combination : castling) {
-    combination = dist(engine);
+    combination = engine();
   }
 
-  black_to_move = dist(engine);
+  black_to_move = engine();
 }
 
-// N.B.: ZobristKeys relies on a random number generator, so it cannot be
-// defined as a constexpr variable.
+// N.B.: ZobristKeys relies on a pseudo-random number generator, so it cannot
+// be defined as a constexpr variable.
 inline const ZobristKeys kZobristKeys;
 
 class ZobristKey {
@@ -11,6 +11,14 @@ namespace {
 using ::testing::Eq;
 using ::testing::Not;
 
+TEST(ZobristKeys, IsDeterministic) {
+  const ZobristKeys keys;
+  EXPECT_THAT(keys.elements, Eq(kZobristKeys.elements));
+  EXPECT_THAT(keys.en_passant_files, Eq(kZobristKeys.en_passant_files));
+  EXPECT_THAT(keys.castling, Eq(kZobristKeys.castling));
+  EXPECT_THAT(keys.black_to_move, Eq(kZobristKeys.black_to_move));
+}
+
 TEST(ZobristKey, Empty) {
   EXPECT_THAT(ZobristKey().GetKey(), Eq(0ULL));
   EXPECT_THAT(ZobristKey(), Eq(ZobristKey()));
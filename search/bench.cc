@@ -0,0 +1,120 @@
+#include "search/bench.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "engine/game.h"
+#include "engine/position.h"
+#include "search/search.h"
+
+namespace follychess {
+namespace {
+
+// A mix of openings, middle games and end games. None of the positions are
+// terminal, so every search produces a best move.
+constexpr std::array kBenchPositions = std::to_array<std::string_view>({
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 11",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "4rrk1/pp1n3p/3q2pQ/2p1pb2/2PP4/2P3N1/P2B2PP/4RRK1 b - - 7 19",
+    "rq3rk1/ppp2ppp/1bnpb3/3N2B1/3NP3/7P/PPPQ1PP1/2KR3R w - - 7 14",
+    "r1bq1r1k/1pp1n1pp/1p1p4/4p2Q/4Pp2/1BNP4/PPP2PPP/3R1RK1 w - - 2 14",
+    "r3r1k1/2p2ppp/p1p1bn2/8/1q2P3/2NPQN2/PPP3PP/R4RK1 b - - 2 15",
+    "r1bbk1nr/pp3p1p/2n5/1N4p1/2Np1B2/8/PPP2PPP/2KR1B1R w kq - 0 13",
+    "r1bq1rk1/ppp1nppp/4n3/3p3Q/3P4/1BP1B3/PP1N2PP/R4RK1 w - - 1 16",
+    "4r1k1/r1q2ppp/ppp2n2/4P3/5Rb1/1N1BQ3/PPP3PP/R5K1 w - - 1 17",
+    "2rqkb1r/ppp2p2/2npb1p1/1N1Nn2p/2P1PP2/8/PP2B1PP/R1BQK2R b KQ - 0 11",
+    "r1bq1r1k/b1p1npp1/p2p3p/1p6/3PP3/1B2NN2/PP3PPP/R2Q1RK1 w - - 1 16",
+    "3r1rk1/p5pp/bpp1pp2/8/q1PP1P2/b3P3/P2NQRPP/1R2B1K1 b - - 6 22",
+    "r1q2rk1/2p1bppp/2Pp4/p6b/Q1PNp3/4B3/PP1R1PPP/2K4R w - - 2 18",
+    "4k2r/1pb2ppp/1p2p3/1R1p4/3P4/2r1PN2/P4PPP/1R4K1 b - - 3 22",
+    "3q2k1/pb3p1p/4pbp1/2r5/PpN2N2/1P2P2P/5PP1/Q2R2K1 b - - 4 26",
+    "6k1/6p1/6Pp/ppp5/3pn2P/1P3K2/1PP2P2/8 b - - 3 54",
+    "3r3k/2r4p/1p1b3q/p4P2/P2Pp3/1B2P3/3BQ1RP/6K1 w - - 0 1",
+    "2r3k1/1p1b1pp1/pq2p2p/3pP3/1P1B4/P2B1Q2/5PPP/2R3K1 w - - 0 1",
+    "r1bqk2r/pppp1ppp/2n2n2/2b1p3/2B1P3/3P1N2/PPP2PPP/RNBQK2R w KQkq - 1 5",
+    "rnbqkb1r/pp2pppp/3p1n2/8/3NP3/8/PPP2PPP/RNBQKB1R w KQkq - 1 5",
+    "rnbqkb1r/ppp1pp1p/5np1/3p4/2PP4/2N5/PP2PPPP/R1BQKBNR w KQkq - 0 4",
+    "r1bqkbnr/pppp1ppp/2n5/1B2p3/4P3/5N2/PPPP1PPP/RNBQK2R b KQkq - 3 3",
+    "rnbqk2r/pppp1ppp/4pn2/8/1bPP4/2N5/PP2PPPP/R1BQKBNR w KQkq - 2 4",
+    "rnbqkbnr/pp1ppppp/8/2p5/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2",
+    "r2qkb1r/pp2nppp/3p4/2pNN1B1/2BnP3/3P4/PPP2PPP/R2bK2R w KQkq - 1 1",
+    "2kr3r/pp1q1ppp/5n2/1Nb5/2Pp1B2/7Q/P4PPP/1R3RK1 w - - 0 1",
+    "r1b2rk1/2q1b1pp/p2ppn2/1p6/3QP3/1BN1B3/PPP3PP/R4RK1 w - - 0 1",
+    "2r1r1k1/p4ppp/1p3n2/3p4/3P4/P1R2N2/1P3PPP/2R3K1 w - - 0 1",
+    "r2q1rk1/1p2bppp/p1npbn2/4p3/4P3/1NN1BP2/PPPQ2PP/2KR1B1R w - - 0 1",
+    "6k1/6p1/p4p1p/1p2pP2/1P2P1P1/P5KP/8/8 w - - 0 1",
+    "8/8/1p2k1p1/3p3p/1p1P1P1P/1P2PK2/8/8 w - - 0 1",
+    "8/3k4/8/8/8/4B3/4KB2/2B5 w - - 0 1",
+    "8/8/1P6/5pr1/8/4R3/7k/2K5 w - - 0 1",
+    "8/2p4P/8/kr6/6R1/8/8/1K6 w - - 0 1",
+    "8/8/3P3k/8/1p6/8/1P6/1K3n2 b - - 0 1",
+    "8/R7/2q5/8/6k1/8/1P5p/K6R w - - 0 124",
+    "6k1/3b3r/1p1p4/p1n2p2/1PPNpP1q/P3Q1p1/1R1RB1P1/5K2 b - - 0 1",
+    "r2r1n2/pp2bk2/2p1p2p/3q4/3PN1QP/2P3R1/P4PP1/5RK1 w - - 0 1",
+    "8/8/8/8/5kp1/P7/8/1K1N4 w - - 0 1",
+    "8/8/8/5N2/8/p7/8/2NK3k w - - 0 1",
+    "8/8/8/8/1R6/k7/8/K7 w - - 0 1",
+    "8/8/8/3k4/8/8/4P3/4K3 w - - 0 1",
+    "8/5k2/8/8/8/2Q5/8/4K3 w - - 0 1",
+    "8/8/7r/K7/1R6/7k/8/N7 w - - 0 1",
+    "4k3/8/8/8/8/8/r7/4K2R w K - 0 1",
+    "5rk1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+});
+
+}  // namespace
+
+std::span<const std::string_view> GetBenchPositions() {
+  return kBenchPositions;
+}
+
+BenchResult RunBench(const BenchOptions& options) {
+  const SearchOptions search_options = SearchOptions().SetDepth(options.depth);
+
+  std::atomic<std::size_t> next_position = 0;
+  std::atomic<std::int64_t> nodes = 0;
+
+  auto worker = [&] {
+    Searcher searcher(options.hash_size_mb);
+    for (std::size_t i = next_position++; i < kBenchPositions.size();
+         i = next_position++) {
+      auto position = Position::FromFen(kBenchPositions[i]);
+      CHECK(position.has_value()) << position.error();
+
+      // Each position starts from empty tables, so that the node count does
+      // not depend on which positions a thread searched before.
+      searcher.Clear();
+      const SearchResult result =
+          searcher.Search(Game(*position), search_options);
+      nodes += result.stats.GetNodes();
+    }
+  };
+
+  const auto start = std::chrono::steady_clock::now();
+  {
+    std::vector<std::jthread> threads;
+    for (int i = 1; i < options.threads; ++i) {
+      threads.emplace_back(worker);
+    }
+    worker();
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  return {
+      .nodes = nodes,
+      .elapsed =
+          std::chrono::duration_cast<std::chrono::milliseconds>(end - start),
+  };
+}
+
+}  // namespace follychess
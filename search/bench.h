@@ -0,0 +1,63 @@
+#ifndef FOLLYCHESS_SEARCH_BENCH_H_
+#define FOLLYCHESS_SEARCH_BENCH_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "search/transposition.h"
+
+namespace follychess {
+
+struct BenchOptions {
+  int depth = 5;
+
+  // The number of positions that are searched concurrently. Each position is
+  // always searched by a single thread, so the total node count does not depend
+  // on this value.
+  int threads = 1;
+
+  // The size of the transposition table used for each position, in megabytes.
+  std::size_t hash_size_mb = TranspositionTable::kDefaultSizeMb;
+};
+
+struct BenchResult {
+  // The total number of nodes searched across all positions. For a given build
+  // and depth, this is identical from run to run, so it serves as a signature
+  // of the search's behavior.
+  std::int64_t nodes = 0;
+
+  std::chrono::milliseconds elapsed{0};
+
+  [[nodiscard]] std::int64_t GetNodesPerSecond() const {
+    return nodes * 1000 / std::max<std::int64_t>(1, elapsed.count());
+  }
+};
+
+// Returns the positions searched by RunBench() in FEN notation.
+std::span<const std::string_view> GetBenchPositions();
+
+// Searches each of the bench positions to a fixed depth.
+BenchResult RunBench(const BenchOptions& options = BenchOptions());
+
+}  // namespace follychess
+
+template <>
+struct std::formatter<follychess::BenchResult> : std::formatter<std::string> {
+  auto format(const follychess::BenchResult &result,
+              std::format_context &context) const {
+    return std::format_to(context.out(),
+                          "Total time (ms) : {}\n"
+                          "Nodes searched  : {}\n"
+                          "Nodes/second    : {}",
+                          result.elapsed.count(), result.nodes,
+                          result.GetNodesPerSecond());
+  }
+};
+
+#endif  // FOLLYCHESS_SEARCH_BENCH_H_
@@ -0,0 +1,22 @@
+#include <cstdlib>
+#include <print>
+#include <string>
+
+#include "search/bench.h"
+
+// Usage: bench_main [depth] [threads] [hash]
+int main(int argc, char **argv) {
+  follychess::BenchOptions options;
+  if (argc > 1) {
+    options.depth = std::stoi(argv[1]);
+  }
+  if (argc > 2) {
+    options.threads = std::stoi(argv[2]);
+  }
+  if (argc > 3) {
+    options.hash_size_mb = std::stoul(argv[3]);
+  }
+
+  std::println("{}", follychess::RunBench(options));
+  return 0;
+}
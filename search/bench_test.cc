@@ -0,0 +1,49 @@
+#include "search/bench.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "engine/move_generator.h"
+#include "engine/position.h"
+#include "engine/scoped_move.h"
+
+namespace follychess {
+namespace {
+
+using ::testing::Eq;
+using ::testing::Gt;
+using ::testing::SizeIs;
+
+[[nodiscard]] bool HasLegalMove(Position position) {
+  for (Move move : GenerateMoves(position)) {
+    ScopedMove scoped_move(move, position);
+    if (!position.GetCheckers(~position.SideToMove())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+TEST(Bench, PositionsAreValid) {
+  EXPECT_THAT(GetBenchPositions(), SizeIs(50));
+
+  for (std::string_view fen : GetBenchPositions()) {
+    SCOPED_TRACE(fen);
+    auto position = Position::FromFen(fen);
+    ASSERT_TRUE(position.has_value()) << position.error();
+    EXPECT_FALSE(position->GetCheckers(~position->SideToMove()));
+    EXPECT_TRUE(HasLegalMove(*position));
+  }
+}
+
+TEST(Bench, NodeCountIsDeterministic) {
+  const BenchResult result = RunBench(BenchOptions{.depth = 2});
+  EXPECT_THAT(result.nodes, Gt(0));
+
+  EXPECT_THAT(RunBench(BenchOptions{.depth = 2}).nodes, Eq(result.nodes));
+  EXPECT_THAT(RunBench(BenchOptions{.depth = 2, .threads = 4}).nodes,
+              Eq(result.nodes));
+}
+
+}  // namespace
+}  // namespace follychess
@@ -0,0 +1,19 @@
+#include "search/eval_cache.h"
+
+#include <bit>
+
+#include "absl/log/check.h"
+
+namespace follychess {
+
+EvalCache::EvalCache(std::size_t entries)
+    : entries_(entries, kEmptyEntry),
+      mask_(entries - 1),
+      probes_(0),
+      hits_(0) {
+  CHECK(std::has_single_bit(entries))
+      << "The number of eval cache entries must be a power of two: "
+      << entries;
+}
+
+}  // namespace follychess
@@ -0,0 +1,68 @@
+#ifndef FOLLYCHESS_SEARCH_EVAL_CACHE_H_
+#define FOLLYCHESS_SEARCH_EVAL_CACHE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace follychess {
+
+// A fixed-size, direct-mapped cache of static evaluations keyed by
+// `Position::GetKey`.
+//
+// The quiescence search reaches the same positions through different capture
+// orders, so caching the static evaluation saves recomputing it. Each entry
+// packs the upper half of the key and the score into a single 64-bit word,
+// so a probe is one load and an entry can never be observed half-written. The
+// table is not shared: each search thread is expected to own its own cache.
+class EvalCache {
+ public:
+  // The number of entries must be a power of two.
+  explicit EvalCache(std::size_t entries = kDefaultEntries);
+
+  // Returns the cached score for the key, if any.
+  [[nodiscard]] std::optional<int> Probe(std::uint64_t key) {
+    ++probes_;
+
+    const std::uint64_t entry = entries_[key & mask_];
+    if ((entry & kKeyMask) != (key & kKeyMask) || entry == kEmptyEntry) {
+      return std::nullopt;
+    }
+
+    ++hits_;
+    return static_cast<std::int32_t>(entry & ~kKeyMask);
+  }
+
+  // Stores the score for the key, replacing whatever was in its slot.
+  void Store(std::uint64_t key, int score) {
+    entries_[key & mask_] =
+        (key & kKeyMask) | static_cast<std::uint32_t>(score);
+  }
+
+  // Removes all entries, e.g., after the evaluation function changes.
+  void Clear() { std::ranges::fill(entries_, kEmptyEntry); }
+
+  [[nodiscard]] std::int64_t GetProbes() const { return probes_; }
+
+  [[nodiscard]] std::int64_t GetHits() const { return hits_; }
+
+ private:
+  static constexpr std::size_t kDefaultEntries = 1 << 16;
+
+  static constexpr std::uint64_t kKeyMask = 0xFFFF'FFFF'0000'0000;
+
+  // Keys whose upper half is all ones with a score of -1 are never served
+  // from the cache.
+  static constexpr std::uint64_t kEmptyEntry = ~0ULL;
+
+  std::vector<std::uint64_t> entries_;
+  std::uint64_t mask_;
+
+  std::int64_t probes_;
+  std::int64_t hits_;
+};
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_SEARCH_EVAL_CACHE_H_
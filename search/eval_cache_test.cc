@@ -0,0 +1,60 @@
+#include "search/eval_cache.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <optional>
+
+namespace follychess {
+namespace {
+
+using ::testing::Eq;
+using ::testing::Optional;
+
+TEST(EvalCache, ProbeAndStore) {
+  EvalCache eval_cache(/*entries=*/16);
+  constexpr std::uint64_t kKey = 0x1234'5678'9ABC'DEF0;
+
+  EXPECT_THAT(eval_cache.Probe(kKey), Eq(std::nullopt));
+
+  eval_cache.Store(kKey, 42);
+  EXPECT_THAT(eval_cache.Probe(kKey), Optional(42));
+
+  eval_cache.Store(kKey, -315);
+  EXPECT_THAT(eval_cache.Probe(kKey), Optional(-315));
+
+  EXPECT_THAT(eval_cache.GetProbes(), Eq(3));
+  EXPECT_THAT(eval_cache.GetHits(), Eq(2));
+}
+
+TEST(EvalCache, EmptyCacheMisses) {
+  EvalCache eval_cache(/*entries=*/16);
+  EXPECT_THAT(eval_cache.Probe(0), Eq(std::nullopt));
+  EXPECT_THAT(eval_cache.Probe(~0ULL), Eq(std::nullopt));
+  EXPECT_THAT(eval_cache.GetHits(), Eq(0));
+}
+
+TEST(EvalCache, CollidingKeysReplaceEachOther) {
+  EvalCache eval_cache(/*entries=*/16);
+  constexpr std::uint64_t kKey1 = 0x1111'1111'0000'0003;
+  constexpr std::uint64_t kKey2 = 0x2222'2222'0000'0013;
+
+  eval_cache.Store(kKey1, 10);
+  EXPECT_THAT(eval_cache.Probe(kKey2), Eq(std::nullopt));
+
+  eval_cache.Store(kKey2, 20);
+  EXPECT_THAT(eval_cache.Probe(kKey1), Eq(std::nullopt));
+  EXPECT_THAT(eval_cache.Probe(kKey2), Optional(20));
+}
+
+TEST(EvalCache, Clear) {
+  EvalCache eval_cache(/*entries=*/16);
+  constexpr std::uint64_t kKey = 0x1234'5678'9ABC'DEF0;
+
+  eval_cache.Store(kKey, 42);
+  eval_cache.Clear();
+  EXPECT_THAT(eval_cache.Probe(kKey), Eq(std::nullopt));
+}
+
+}  // namespace
+}  // namespace follychess
@@ -1,6 +1,10 @@
 #include "search/evaluation.h"
 
+#include <algorithm>
+
+#include "engine/attacks.h"
 #include "engine/position.h"
+#include "search/pawn_structure.h"
 
 namespace follychess {
 namespace {
@@ -111,6 +115,97 @@ template <Side Side>
          GetPlacementScore<Side, kKing>(position);
 }
 
+// Mobility bonus per safe square, and the number of safe squares considered
+// neutral, indexed by piece type.
+constexpr std::array<int, kNumPieces> kMobilityWeights = {0, 4, 5, 2, 1, 0};
+constexpr std::array<int, kNumPieces> kMobilityBaselines = {0, 4, 6, 7, 13, 0};
+
+// Attack units per attacked square in the enemy king zone, indexed by piece
+// type.
+constexpr std::array<int, kNumPieces> kKingAttackUnits = {0, 2, 2, 3, 5, 0};
+
+// The percentage of the king danger that applies, indexed by the number of
+// pieces attacking the king zone. A lone attacker is rarely dangerous.
+constexpr std::array<int, 8> kKingAttackerScaling = {0,  0,  50, 75,
+                                                     88, 94, 97, 99};
+
+constexpr int kMaxKingDanger = 500;
+
+// The squares each side attacks with its pawns, and the zone around each
+// king. These are computed once per evaluation and shared by the mobility and
+// king safety terms.
+struct AttackMaps {
+  explicit AttackMaps(const Position& position) {
+    const Bitboard white_pawns = position.GetPieces(kWhite, kPawn);
+    const Bitboard black_pawns = position.GetPieces(kBlack, kPawn);
+    pawn_attacks[kWhite] =
+        white_pawns.Shift<kNorthEast>() | white_pawns.Shift<kNorthWest>();
+    pawn_attacks[kBlack] =
+        black_pawns.Shift<kSouthEast>() | black_pawns.Shift<kSouthWest>();
+
+    for (Side side : {kWhite, kBlack}) {
+      const Square king = position.GetKing(side);
+      king_zones[side] =
+          Bitboard(king) | GenerateAttacks<kKing>(king, kEmptyBoard);
+    }
+  }
+
+  std::array<Bitboard, kNumSides> pawn_attacks;
+  std::array<Bitboard, kNumSides> king_zones;
+};
+
+// Accumulates the mobility of `Side`'s pieces of type `Piece`, and their
+// attacks on the enemy king zone.
+template <Side Side, Piece Piece>
+void AddPieceActivity(const Position& position, const AttackMaps& maps,
+                      int& mobility, int& king_attack_units,
+                      int& king_attackers) {
+  const Bitboard occupied = position.GetPieces();
+  const Bitboard safe =
+      ~position.GetPieces(Side) & ~maps.pawn_attacks[~Side];
+
+  Bitboard pieces = position.GetPieces(Side, Piece);
+  while (pieces) {
+    const Bitboard attacks =
+        GenerateAttacks<Piece>(pieces.PopLeastSignificantBit(), occupied);
+    mobility += kMobilityWeights[Piece] *
+                ((attacks & safe).GetCount() - kMobilityBaselines[Piece]);
+
+    const int zone_attacks = (attacks & maps.king_zones[~Side]).GetCount();
+    if (zone_attacks > 0) {
+      king_attack_units += kKingAttackUnits[Piece] * zone_attacks;
+      ++king_attackers;
+    }
+  }
+}
+
+// Returns the mobility of `Side`'s pieces and the danger they pose to the
+// enemy king.
+template <Side Side>
+[[nodiscard]] ActivityScore GetActivityScore(const Position& position,
+                                             const AttackMaps& maps) {
+  int mobility = 0;
+  int king_attack_units = 0;
+  int king_attackers = 0;
+  AddPieceActivity<Side, kKnight>(position, maps, mobility, king_attack_units,
+                                  king_attackers);
+  AddPieceActivity<Side, kBishop>(position, maps, mobility, king_attack_units,
+                                  king_attackers);
+  AddPieceActivity<Side, kRook>(position, maps, mobility, king_attack_units,
+                                king_attackers);
+  AddPieceActivity<Side, kQueen>(position, maps, mobility, king_attack_units,
+                                 king_attackers);
+
+  const int danger =
+      std::min(kMaxKingDanger, king_attack_units * king_attack_units / 4);
+  const int scaling = kKingAttackerScaling[std::min<std::size_t>(
+      king_attackers, kKingAttackerScaling.size() - 1)];
+  return {
+      .mobility = mobility,
+      .king_safety = danger * scaling / 100,
+  };
+}
+
 [[nodiscard]] constexpr int SideDifference(const Position& position,
                                            const Piece piece) {
   return position.GetPieces(kWhite, piece).GetCount() -
@@ -133,8 +228,28 @@ template <Side Side>
          GetPlacementScore<kBlack>(position);
 }
 
+[[nodiscard]] ActivityScore GetActivityScore(const Position& position) {
+  const AttackMaps maps(position);
+  const ActivityScore white = GetActivityScore<kWhite>(position, maps);
+  const ActivityScore black = GetActivityScore<kBlack>(position, maps);
+
+  // Each side's king safety is the danger posed by the other side.
+  return {
+      .mobility = white.mobility - black.mobility,
+      .king_safety = white.king_safety - black.king_safety,
+  };
+}
+
+[[nodiscard]] int Evaluate(const Position& position, PawnTable& pawn_table) {
+  const ActivityScore activity = GetActivityScore(position);
+  return GetMaterialScore(position) + GetPlacementScore(position) +
+         pawn_table.Probe(position).score + activity.mobility +
+         activity.king_safety;
+}
+
 [[nodiscard]] int Evaluate(const Position& position) {
-  return GetMaterialScore(position) + GetPlacementScore(position);
+  thread_local PawnTable pawn_table;
+  return Evaluate(position, pawn_table);
 }
 
 }  // namespace follychess
@@ -2,6 +2,7 @@
 #define FOLLYCHESS_SEARCH_EVALUATION_H_
 
 #include "engine/position.h"
+#include "search/pawn_structure.h"
 
 namespace follychess {
 
@@ -9,6 +10,26 @@ namespace follychess {
 
 [[nodiscard]] int GetPlacementScore(const Position& position);
 
+// The piece activity terms from white's perspective. Both are computed from
+// the same per-side attack maps in a single pass over the pieces.
+struct ActivityScore {
+  // Rewards knights, bishops, rooks, and queens for the number of squares
+  // they can move to that are neither occupied by friendly pieces nor
+  // attacked by enemy pawns.
+  int mobility = 0;
+
+  // Penalizes each side for the enemy pieces attacking the squares around its
+  // king, weighted by the number of attackers.
+  int king_safety = 0;
+};
+
+[[nodiscard]] ActivityScore GetActivityScore(const Position& position);
+
+// Evaluates the position from white's perspective, using `pawn_table` to cache
+// the pawn-structure terms.
+[[nodiscard]] int Evaluate(const Position& position, PawnTable& pawn_table);
+
+// Like above, but uses a pawn table owned by the calling thread.
 [[nodiscard]] int Evaluate(const Position& position);
 
 }  // namespace follychess
@@ -147,5 +147,70 @@ TEST(Evaluation, GetPlacementScore) {
               Eq(50));
 }
 
+TEST(Evaluation, GetActivityScoreStarting) {
+  ActivityScore activity = GetActivityScore(Position::Starting());
+  EXPECT_THAT(activity.mobility, Eq(0));
+  EXPECT_THAT(activity.king_safety, Eq(0));
+}
+
+TEST(Evaluation, GetActivityScoreMobility) {
+  ActivityScore activity = GetActivityScore(MakePosition(
+      "8: . . . . k . . ."
+      "7: . . . . . . . ."
+      "6: . . . . . . . ."
+      "5: . . . . . . . ."
+      "4: . . . N p . . ."
+      "3: . . . . . . . ."
+      "2: . . . . . . . ."
+      "1: . . . . K . . ."
+      "   a b c d e f g h"
+      //
+      "   w - - 0 1"));
+
+  // The knight has 8 moves, but f3 is attacked by the pawn on e4.
+  EXPECT_THAT(activity.mobility, Eq(4 * (7 - 4)));
+  EXPECT_THAT(activity.king_safety, Eq(0));
+}
+
+TEST(Evaluation, GetActivityScoreKingSafety) {
+  ActivityScore activity = GetActivityScore(MakePosition(
+      "8: . . . . . . k ."
+      "7: . . . . . . . ."
+      "6: . . . . . . . ."
+      "5: . . . . . . N ."
+      "4: . . . . . . . ."
+      "3: . . . Q . . . ."
+      "2: . . . . . . . ."
+      "1: . . . . K . . ."
+      "   a b c d e f g h"
+      //
+      "   w - - 0 1"));
+
+  // The knight attacks f7 and h7, and the queen attacks h7:
+  //
+  //   units = 2 * 2 + 5 * 1 = 9
+  //   danger = 9 * 9 / 4 = 20
+  //
+  // With two attackers, half of the danger applies.
+  EXPECT_THAT(activity.king_safety, Eq(10));
+}
+
+TEST(Evaluation, GetActivityScoreLoneAttacker) {
+  ActivityScore activity = GetActivityScore(MakePosition(
+      "8: . . . . . . k ."
+      "7: . . . . . . . ."
+      "6: . . . . . . . ."
+      "5: . . . . . . . ."
+      "4: . . . . . . . ."
+      "3: . . . Q . . . ."
+      "2: . . . . . . . ."
+      "1: . . . . K . . ."
+      "   a b c d e f g h"
+      //
+      "   w - - 0 1"));
+
+  EXPECT_THAT(activity.king_safety, Eq(0));
+}
+
 }  // namespace
 }  // namespace follychess
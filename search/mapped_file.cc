@@ -0,0 +1,69 @@
+#include "search/mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <string>
+#include <utility>
+
+namespace follychess {
+
+std::expected<MappedFile, std::string> MappedFile::Open(
+    const std::string &path) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return std::unexpected(std::format("Unable to open file: {}", path));
+  }
+
+  struct stat status;
+  if (fstat(fd, &status) != 0) {
+    close(fd);
+    return std::unexpected(std::format("Unable to read file size: {}", path));
+  }
+
+  const auto size = static_cast<std::size_t>(status.st_size);
+  if (size == 0) {
+    // Empty files cannot be mapped.
+    close(fd);
+    return MappedFile(nullptr, 0);
+  }
+
+  void *data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping keeps its own reference to the file.
+  close(fd);
+  if (data == MAP_FAILED) {
+    return std::unexpected(std::format("Unable to map file: {}", path));
+  }
+  return MappedFile(static_cast<const std::uint8_t *>(data), size);
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  if (this != &other) {
+    Unmap();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() { Unmap(); }
+
+void MappedFile::Unmap() {
+  if (data_ != nullptr) {
+    munmap(const_cast<std::uint8_t *>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+}
+
+}  // namespace follychess
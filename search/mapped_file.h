@@ -0,0 +1,49 @@
+#ifndef FOLLYCHESS_SEARCH_MAPPED_FILE_H_
+#define FOLLYCHESS_SEARCH_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string>
+
+namespace follychess {
+
+// A read-only memory mapping of a whole file. Pages are loaded by the
+// operating system on first access and shared between processes, so large
+// files such as endgame tables cost nothing until they are probed.
+class MappedFile {
+ public:
+  // Maps the file at `path`. Returns an error if the file cannot be opened or
+  // mapped.
+  static std::expected<MappedFile, std::string> Open(const std::string &path);
+
+  MappedFile(MappedFile &&other) noexcept;
+
+  MappedFile &operator=(MappedFile &&other) noexcept;
+
+  MappedFile(const MappedFile &) = delete;
+
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  ~MappedFile();
+
+  [[nodiscard]] std::span<const std::uint8_t> GetData() const {
+    return {data_, size_};
+  }
+
+  [[nodiscard]] std::size_t GetSize() const { return size_; }
+
+ private:
+  MappedFile(const std::uint8_t *data, std::size_t size)
+      : data_(data), size_(size) {}
+
+  void Unmap();
+
+  const std::uint8_t *data_;
+  std::size_t size_;
+};
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_SEARCH_MAPPED_FILE_H_
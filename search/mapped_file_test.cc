@@ -0,0 +1,53 @@
+#include "search/mapped_file.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+#include <utility>
+
+namespace follychess {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+
+std::string WriteFile(const std::string &name, const std::string &contents) {
+  const std::string path = testing::TempDir() + name;
+  std::ofstream file(path, std::ios::binary);
+  file << contents;
+  return path;
+}
+
+TEST(MappedFile, Open) {
+  const std::string path = WriteFile("mapped_file_test", "abc");
+
+  auto file = MappedFile::Open(path);
+  ASSERT_TRUE(file.has_value()) << file.error();
+  EXPECT_THAT(file->GetSize(), Eq(3));
+  EXPECT_THAT(file->GetData(), ElementsAre('a', 'b', 'c'));
+
+  MappedFile moved = std::move(file.value());
+  EXPECT_THAT(moved.GetData(), ElementsAre('a', 'b', 'c'));
+  EXPECT_THAT(file->GetData(), IsEmpty());
+}
+
+TEST(MappedFile, Empty) {
+  const std::string path = WriteFile("mapped_file_test_empty", "");
+
+  auto file = MappedFile::Open(path);
+  ASSERT_TRUE(file.has_value()) << file.error();
+  EXPECT_THAT(file->GetData(), IsEmpty());
+}
+
+TEST(MappedFile, Missing) {
+  auto file = MappedFile::Open(testing::TempDir() + "does_not_exist");
+  ASSERT_FALSE(file.has_value());
+  EXPECT_THAT(file.error(), HasSubstr("Unable to open file: "));
+}
+
+}  // namespace
+}  // namespace follychess
@@ -1,21 +1,25 @@
 #include "search/move_ordering.h"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <functional>
-#include <vector>
+#include <span>
 
+#include "absl/log/check.h"
 #include "engine/move.h"
+#include "engine/move_list.h"
 #include "engine/position.h"
 
 namespace follychess {
 namespace {
 
-[[nodiscard]] int MoveKey(const Position& position, Move move) {
-  if (move.IsCapture()) {
-    const Piece attacker = position.GetPiece(move.GetFrom());
-    const Piece victim = position.GetPiece(move.GetTo());
-
-    const int victim_score = kKing - victim;
-    const int attacker_score = attacker;
+// Orders captures by most valuable victim, then least valuable attacker, and
+// puts quiet moves after them.
+[[nodiscard]] int GetScore(ExtendedMove move) {
+  if (move.GetMove().IsCapture()) {
+    const int victim_score = kKing - move.GetCapturedPiece();
+    const int attacker_score = move.GetPiece();
 
     return (victim_score * static_cast<int>(kNumPieces)) + attacker_score;
   }
@@ -23,10 +27,39 @@ namespace {
   return 1'000;
 }
 
+// Sorts the scored moves in place. No more moves than fit a move list are
+// ordered at once, so the scores live on the stack.
+using ScoredMoves = std::array<ScoredMove, ExtendedMoveList::kCapacity>;
+
+void SortByScore(std::span<ScoredMove> moves) {
+  std::ranges::sort(moves, std::less(), &ScoredMove::score);
+}
+
 }  // namespace
 
-void OrderMoves(const Position& position, std::vector<Move>& moves) {
-  std::ranges::sort(moves, std::less(), std::bind_front(MoveKey, position));
+void OrderMoves(const Position& position, std::span<Move> moves) {
+  DCHECK_LE(moves.size(), ExtendedMoveList::kCapacity);
+  ScoredMoves scored;
+  for (std::size_t i = 0; i < moves.size(); ++i) {
+    const ExtendedMove move = position.ExtendMove(moves[i]);
+    scored[i] = {.move = move, .score = GetScore(move)};
+  }
+  SortByScore(std::span(scored).first(moves.size()));
+  for (std::size_t i = 0; i < moves.size(); ++i) {
+    moves[i] = scored[i].move.GetMove();
+  }
+}
+
+void OrderMoves(std::span<ExtendedMove> moves) {
+  DCHECK_LE(moves.size(), ExtendedMoveList::kCapacity);
+  ScoredMoves scored;
+  for (std::size_t i = 0; i < moves.size(); ++i) {
+    scored[i] = {.move = moves[i], .score = GetScore(moves[i])};
+  }
+  SortByScore(std::span(scored).first(moves.size()));
+  for (std::size_t i = 0; i < moves.size(); ++i) {
+    moves[i] = scored[i].move;
+  }
 }
 
 }  // namespace follychess
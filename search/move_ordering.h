@@ -1,14 +1,25 @@
 #ifndef FOLLYCHESS_SEARCH_MOVE_ORDERING_H_
 #define FOLLYCHESS_SEARCH_MOVE_ORDERING_H_
 
-#include <vector>
+#include <span>
 
 #include "engine/move.h"
 #include "engine/position.h"
 
 namespace follychess {
 
-void OrderMoves(const Position& position, std::vector<Move>& moves);
+// A move together with its ordering score. Each move is scored once before
+// sorting, rather than on every comparison. Lower scores sort first.
+struct ScoredMove {
+  ExtendedMove move;
+  int score;
+};
+
+void OrderMoves(const Position& position, std::span<Move> moves);
+
+// Like the above, but the scores come from the pieces that the moves carry,
+// so no pieces are looked up on the board.
+void OrderMoves(std::span<ExtendedMove> moves);
 
 }  // namespace follychess
 
@@ -3,6 +3,10 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <vector>
+
+#include "engine/move.h"
+#include "engine/move_generator.h"
 #include "engine/position.h"
 #include "engine/testing.h"
 
@@ -45,5 +49,25 @@ TEST(MoveOrdering, All) {
                      })));
 }
 
+TEST(MoveOrdering, ExtendedMovesMatchMoves) {
+  const Position position =
+      Position::FromFen(
+          "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1")
+          .value();
+  std::vector<Move> moves = GenerateMoves(position);
+  std::vector<ExtendedMove> extended_moves;
+  for (Move move : moves) {
+    extended_moves.push_back(position.ExtendMove(move));
+  }
+
+  OrderMoves(position, moves);
+  OrderMoves(extended_moves);
+  std::vector<Move> ordered;
+  for (ExtendedMove move : extended_moves) {
+    ordered.push_back(move.GetMove());
+  }
+  EXPECT_THAT(ordered, ElementsAreArray(moves));
+}
+
 }  // namespace
 }  // namespace follychess
@@ -0,0 +1,553 @@
+#include "search/nnue.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+#include "absl/log/check.h"
+#include "engine/bitboard.h"
+
+namespace follychess::nnue {
+namespace {
+
+static_assert(std::endian::native == std::endian::little,
+              "Network blobs are stored in little-endian byte order.");
+
+constexpr std::string_view kMagic = "FCNN";
+constexpr std::uint32_t kVersion = 1;
+
+// Inputs to the hidden layers are clipped to [0, kMaxActivation], so that
+// they fit in a uint8 and the products with the int8 weights can be summed
+// pairwise in an int16 without overflowing.
+constexpr int kMaxActivation = 127;
+
+template <typename T>
+void Write(std::string& out, const T* data, std::size_t count) {
+  out.append(reinterpret_cast<const char*>(data), count * sizeof(T));
+}
+
+class Reader {
+ public:
+  explicit Reader(std::string_view blob) : blob_(blob) {}
+
+  template <typename T>
+  [[nodiscard]] bool Read(T* data, std::size_t count) {
+    const std::size_t size = count * sizeof(T);
+    if (blob_.size() < size) {
+      return false;
+    }
+    std::memcpy(data, blob_.data(), size);
+    blob_.remove_prefix(size);
+    return true;
+  }
+
+  [[nodiscard]] bool AtEnd() const { return blob_.empty(); }
+
+ private:
+  std::string_view blob_;
+};
+
+// Writes the feature transformer output for `perspective` into `values` from
+// scratch.
+void Refresh(const Network& network, const Position& position,
+             Side perspective,
+             std::array<std::int16_t, kHalfDimensions>& values) {
+  values = network.feature_biases;
+
+  const Square king = position.GetKing(perspective);
+  for (Side side : {kWhite, kBlack}) {
+    for (Piece piece : {kPawn, kKnight, kBishop, kRook, kQueen}) {
+      Bitboard pieces = position.GetPieces(side, piece);
+      while (pieces) {
+        const Square square = pieces.PopLeastSignificantBit();
+        internal::AddFeature(
+            network, GetFeatureIndex(perspective, king, piece, side, square),
+            values);
+      }
+    }
+  }
+}
+
+// Writes the clipped feature transformer outputs, side to move first.
+template <bool Scalar>
+void TransformFeatures(const Accumulator& accumulator, Side side_to_move,
+                       std::uint8_t* output) {
+  const std::array<Side, kNumSides> perspectives = {side_to_move,
+                                                     ~side_to_move};
+  for (std::size_t half = 0; half < kNumSides; ++half) {
+    const std::int16_t* input = accumulator.values[perspectives[half]].data();
+    std::uint8_t* half_output = output + half * kHalfDimensions;
+
+    if constexpr (!Scalar) {
+#if defined(__AVX2__)
+      const __m256i zero = _mm256_setzero_si256();
+      for (std::size_t i = 0; i < kHalfDimensions; i += 32) {
+        const __m256i low = _mm256_load_si256(
+            reinterpret_cast<const __m256i*>(input + i));
+        const __m256i high = _mm256_load_si256(
+            reinterpret_cast<const __m256i*>(input + i + 16));
+
+        // The pack saturates to [-128, 127] but interleaves the 128-bit
+        // lanes, so the result needs to be permuted back into order.
+        const __m256i packed = _mm256_max_epi8(
+            _mm256_packs_epi16(low, high), zero);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(half_output + i),
+                           _mm256_permute4x64_epi64(packed, 0b11011000));
+      }
+      continue;
+#elif defined(__SSE4_1__)
+      const __m128i zero = _mm_setzero_si128();
+      for (std::size_t i = 0; i < kHalfDimensions; i += 16) {
+        const __m128i low =
+            _mm_load_si128(reinterpret_cast<const __m128i*>(input + i));
+        const __m128i high =
+            _mm_load_si128(reinterpret_cast<const __m128i*>(input + i + 8));
+        _mm_store_si128(reinterpret_cast<__m128i*>(half_output + i),
+                        _mm_max_epi8(_mm_packs_epi16(low, high), zero));
+      }
+      continue;
+#endif
+    }
+
+    for (std::size_t i = 0; i < kHalfDimensions; ++i) {
+      half_output[i] = static_cast<std::uint8_t>(
+          std::clamp<int>(input[i], 0, kMaxActivation));
+    }
+  }
+}
+
+template <bool Scalar, std::size_t Inputs, std::size_t Outputs>
+void AffineTransform(const AffineLayer<Inputs, Outputs>& layer,
+                     const std::uint8_t* input, std::int32_t* output) {
+  for (std::size_t out = 0; out < Outputs; ++out) {
+    const std::int8_t* row = layer.weights.data() + out * Inputs;
+
+    if constexpr (!Scalar) {
+#if defined(__AVX2__)
+      static_assert(Inputs % 32 == 0);
+      const __m256i ones = _mm256_set1_epi16(1);
+      __m256i sum = _mm256_setzero_si256();
+      for (std::size_t i = 0; i < Inputs; i += 32) {
+        const __m256i in =
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(input + i));
+        const __m256i weights =
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(row + i));
+
+        // uint8 * int8 products, summed pairwise into int16 and then into
+        // int32.
+        sum = _mm256_add_epi32(
+            sum, _mm256_madd_epi16(_mm256_maddubs_epi16(in, weights), ones));
+      }
+
+      __m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum),
+                                     _mm256_extracti128_si256(sum, 1));
+      sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, 0b01001110));
+      sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, 0b10110001));
+      output[out] = layer.biases[out] + _mm_cvtsi128_si32(sum128);
+      continue;
+#elif defined(__SSE4_1__)
+      static_assert(Inputs % 16 == 0);
+      const __m128i ones = _mm_set1_epi16(1);
+      __m128i sum = _mm_setzero_si128();
+      for (std::size_t i = 0; i < Inputs; i += 16) {
+        const __m128i in =
+            _mm_load_si128(reinterpret_cast<const __m128i*>(input + i));
+        const __m128i weights =
+            _mm_load_si128(reinterpret_cast<const __m128i*>(row + i));
+        sum = _mm_add_epi32(
+            sum, _mm_madd_epi16(_mm_maddubs_epi16(in, weights), ones));
+      }
+
+      sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0b01001110));
+      sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0b10110001));
+      output[out] = layer.biases[out] + _mm_cvtsi128_si32(sum);
+      continue;
+#endif
+    }
+
+    std::int32_t sum = layer.biases[out];
+    for (std::size_t i = 0; i < Inputs; ++i) {
+      sum += static_cast<std::int32_t>(input[i]) * row[i];
+    }
+    output[out] = sum;
+  }
+}
+
+template <std::size_t Size>
+void ClippedRelu(const std::int32_t* input, std::uint8_t* output) {
+  for (std::size_t i = 0; i < Size; ++i) {
+    output[i] = static_cast<std::uint8_t>(
+        std::clamp(input[i] >> kWeightScaleBits, 0, kMaxActivation));
+  }
+}
+
+template <bool Scalar>
+std::int32_t PropagateImpl(const Network& network,
+                           const Accumulator& accumulator, Side side_to_move) {
+  alignas(64) std::array<std::uint8_t, 2 * kHalfDimensions> transformed;
+  alignas(64) std::array<std::int32_t, kHidden1Dimensions> hidden1;
+  alignas(64) std::array<std::uint8_t, kHidden1Dimensions> hidden1_clipped;
+  alignas(64) std::array<std::int32_t, kHidden2Dimensions> hidden2;
+  alignas(64) std::array<std::uint8_t, kHidden2Dimensions> hidden2_clipped;
+  std::int32_t output;
+
+  TransformFeatures<Scalar>(accumulator, side_to_move, transformed.data());
+  AffineTransform<Scalar>(network.hidden1, transformed.data(),
+                          hidden1.data());
+  ClippedRelu<kHidden1Dimensions>(hidden1.data(), hidden1_clipped.data());
+  AffineTransform<Scalar>(network.hidden2, hidden1_clipped.data(),
+                          hidden2.data());
+  ClippedRelu<kHidden2Dimensions>(hidden2.data(), hidden2_clipped.data());
+  AffineTransform<Scalar>(network.output, hidden2_clipped.data(), &output);
+  return output;
+}
+
+[[nodiscard]] int ToWhitePerspective(std::int32_t output, Side side_to_move) {
+  const int score = output / kOutputScale;
+  return side_to_move == kWhite ? score : -score;
+}
+
+}  // namespace
+
+std::size_t GetFeatureIndex(Side perspective, Square king, Piece piece,
+                            Side side, Square square) {
+  DCHECK_NE(piece, kKing);
+  DCHECK_NE(piece, kEmptyPiece);
+
+  // Black sees the board flipped, so that both sides share the same weights.
+  if (perspective == kBlack) {
+    king = Reflect(king);
+    square = Reflect(square);
+  }
+
+  const std::size_t piece_index = 2 * piece + (side == perspective ? 0 : 1);
+  return king * kNumPieceFeatures + piece_index * kNumSquares + square;
+}
+
+std::expected<std::unique_ptr<Network>, std::string> Network::FromBlob(
+    std::string_view blob) {
+  Reader reader(blob);
+
+  std::array<char, 4> magic;
+  std::uint32_t version;
+  if (!reader.Read(magic.data(), magic.size()) ||
+      std::string_view(magic.data(), magic.size()) != kMagic ||
+      !reader.Read(&version, 1)) {
+    return std::unexpected("Invalid network: missing header.");
+  }
+  if (version != kVersion) {
+    return std::unexpected(
+        std::format("Invalid network: unsupported version {}.", version));
+  }
+
+  std::array<std::uint32_t, 4> dimensions;
+  constexpr std::array<std::uint32_t, 4> kExpectedDimensions = {
+      kNumFeatures, kHalfDimensions, kHidden1Dimensions, kHidden2Dimensions};
+  if (!reader.Read(dimensions.data(), dimensions.size()) ||
+      dimensions != kExpectedDimensions) {
+    return std::unexpected(
+        "Invalid network: the architecture does not match (40960 -> 256) x 2 "
+        "-> 32 -> 32 -> 1.");
+  }
+
+  auto network = std::make_unique<Network>();
+  auto read_layer = [&reader](auto& layer) {
+    return reader.Read(layer.biases.data(), layer.biases.size()) &&
+           reader.Read(layer.weights.data(), layer.weights.size());
+  };
+  if (!reader.Read(network->feature_biases.data(),
+                   network->feature_biases.size()) ||
+      !reader.Read(network->feature_weights.data(),
+                   network->feature_weights.size()) ||
+      !read_layer(network->hidden1) || !read_layer(network->hidden2) ||
+      !read_layer(network->output)) {
+    return std::unexpected("Invalid network: truncated weights.");
+  }
+  if (!reader.AtEnd()) {
+    return std::unexpected("Invalid network: unexpected trailing data.");
+  }
+
+  return network;
+}
+
+std::expected<std::unique_ptr<Network>, std::string> Network::FromFile(
+    const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return std::unexpected(
+        std::format("Unable to open network file: {}", path));
+  }
+
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return FromBlob(contents.str());
+}
+
+std::unique_ptr<Network> Network::Random(std::uint64_t seed) {
+  std::mt19937_64 engine(seed);
+  auto fill = [&engine](auto& values, int min, int max) {
+    std::uniform_int_distribution<int> distribution(min, max);
+    for (auto& value : values) {
+      value = static_cast<std::remove_reference_t<decltype(value)>>(
+          distribution(engine));
+    }
+  };
+
+  auto network = std::make_unique<Network>();
+  fill(network->feature_biases, 0, 64);
+  fill(network->feature_weights, -24, 24);
+  fill(network->hidden1.biases, -1024, 1024);
+  fill(network->hidden1.weights, -8, 8);
+  fill(network->hidden2.biases, -1024, 1024);
+  fill(network->hidden2.weights, -16, 16);
+  fill(network->output.biases, -256, 256);
+  fill(network->output.weights, -16, 16);
+  return network;
+}
+
+std::string Network::Serialize() const {
+  std::string out(kMagic);
+  Write(out, &kVersion, 1);
+
+  constexpr std::array<std::uint32_t, 4> kDimensions = {
+      kNumFeatures, kHalfDimensions, kHidden1Dimensions, kHidden2Dimensions};
+  Write(out, kDimensions.data(), kDimensions.size());
+
+  auto write_layer = [&out](const auto& layer) {
+    Write(out, layer.biases.data(), layer.biases.size());
+    Write(out, layer.weights.data(), layer.weights.size());
+  };
+  Write(out, feature_biases.data(), feature_biases.size());
+  Write(out, feature_weights.data(), feature_weights.size());
+  write_layer(hidden1);
+  write_layer(hidden2);
+  write_layer(output);
+  return out;
+}
+
+int Evaluate(const Network& network, const Position& position) {
+  Accumulator accumulator;
+  Refresh(network, position, kWhite, accumulator.values[kWhite]);
+  Refresh(network, position, kBlack, accumulator.values[kBlack]);
+  return ToWhitePerspective(
+      internal::Propagate(network, accumulator, position.SideToMove()),
+      position.SideToMove());
+}
+
+Evaluator::Evaluator(const Network& network) : network_(network), size_(0) {
+  // Enough for any realistic search depth. The stack grows if needed.
+  stack_.resize(kInitialStackSize);
+}
+
+void Evaluator::Reset(const Position& position) {
+  size_ = 1;
+  Entry& root = stack_[0];
+  Refresh(network_, position, kWhite, root.accumulator.values[kWhite]);
+  Refresh(network_, position, kBlack, root.accumulator.values[kBlack]);
+  root.computed = {true, true};
+  root.num_dirty_pieces = 0;
+  root.king_moved = {false, false};
+}
+
+void Evaluator::Push(const Position& position, Move move) {
+  DCHECK_GT(size_, 0);
+  if (size_ == stack_.size()) {
+    stack_.emplace_back();
+  }
+
+  Entry& entry = stack_[size_++];
+  entry.computed = {false, false};
+  entry.num_dirty_pieces = 0;
+  entry.king_moved = {false, false};
+
+  auto add_dirty_piece = [&entry](Piece piece, Side side, Square square,
+                                  bool added) {
+    DCHECK_LT(entry.num_dirty_pieces, entry.dirty_pieces.size());
+    entry.dirty_pieces[entry.num_dirty_pieces++] = {
+        .piece = piece,
+        .side = side,
+        .square = square,
+        .added = added,
+    };
+  };
+
+  const Side side = position.SideToMove();
+  const Square from = move.GetFrom();
+  const Square to = move.GetTo();
+  const Piece piece = position.GetPiece(from);
+
+  if (move.IsCapture()) {
+    const Square victim =
+        move.IsEnPassantCapture() ? move.GetEnPassantVictim() : to;
+    add_dirty_piece(position.GetPiece(victim), ~side, victim, false);
+  }
+
+  // Kings are not features. Instead, a king move changes every feature of its
+  // own side's perspective, which is handled by a refresh.
+  if (piece == kKing) {
+    entry.king_moved[side] = true;
+
+    if (move.IsKingSideCastling() || move.IsQueenSideCastling()) {
+      const std::uint8_t rank = GetRank(from);
+      const bool king_side = move.IsKingSideCastling();
+      add_dirty_piece(kRook, side, MakeSquare(rank, king_side ? 7 : 0), false);
+      add_dirty_piece(kRook, side, MakeSquare(rank, king_side ? 5 : 3), true);
+    }
+    return;
+  }
+
+  add_dirty_piece(piece, side, from, false);
+  add_dirty_piece(move.IsPromotion() ? move.GetPromotedPiece() : piece, side,
+                  to, true);
+}
+
+void Evaluator::Pop() {
+  DCHECK_GT(size_, 1);
+  --size_;
+}
+
+int Evaluator::Evaluate(const Position& position) {
+  DCHECK_GT(size_, 0);
+  Update(position, kWhite);
+  Update(position, kBlack);
+  return ToWhitePerspective(
+      internal::Propagate(network_, stack_[size_ - 1].accumulator,
+                          position.SideToMove()),
+      position.SideToMove());
+}
+
+void Evaluator::Update(const Position& position, Side perspective) {
+  Entry& top = stack_[size_ - 1];
+  if (top.computed[perspective]) {
+    return;
+  }
+
+  // Finds the nearest entry that has already been computed. If a king move
+  // of this perspective is in the way, a refresh is cheaper than replaying
+  // the moves.
+  std::size_t index = size_ - 1;
+  while (!stack_[index].computed[perspective]) {
+    if (index == 0 || stack_[index].king_moved[perspective]) {
+      Refresh(network_, position, perspective,
+              top.accumulator.values[perspective]);
+      top.computed[perspective] = true;
+      return;
+    }
+    --index;
+  }
+
+  // The king has not moved since the computed entry, so its current square
+  // is valid for every entry in between.
+  const Square king = position.GetKing(perspective);
+  for (++index; index < size_; ++index) {
+    Entry& entry = stack_[index];
+    std::array<std::int16_t, kHalfDimensions>& values =
+        entry.accumulator.values[perspective];
+    values = stack_[index - 1].accumulator.values[perspective];
+
+    for (std::size_t i = 0; i < entry.num_dirty_pieces; ++i) {
+      const DirtyPiece& dirty_piece = entry.dirty_pieces[i];
+      const std::size_t feature =
+          GetFeatureIndex(perspective, king, dirty_piece.piece,
+                          dirty_piece.side, dirty_piece.square);
+      if (dirty_piece.added) {
+        internal::AddFeature(network_, feature, values);
+      } else {
+        internal::SubtractFeature(network_, feature, values);
+      }
+    }
+    entry.computed[perspective] = true;
+  }
+}
+
+namespace internal {
+
+void AddFeature(const Network& network, std::size_t feature,
+                std::array<std::int16_t, kHalfDimensions>& values) {
+  const std::int16_t* weights =
+      network.feature_weights.data() + feature * kHalfDimensions;
+#if defined(__AVX2__)
+  for (std::size_t i = 0; i < kHalfDimensions; i += 16) {
+    auto* value = reinterpret_cast<__m256i*>(values.data() + i);
+    _mm256_store_si256(
+        value, _mm256_add_epi16(_mm256_load_si256(value),
+                                _mm256_loadu_si256(
+                                    reinterpret_cast<const __m256i*>(
+                                        weights + i))));
+  }
+#elif defined(__SSE4_1__)
+  for (std::size_t i = 0; i < kHalfDimensions; i += 8) {
+    auto* value = reinterpret_cast<__m128i*>(values.data() + i);
+    _mm_store_si128(
+        value, _mm_add_epi16(_mm_load_si128(value),
+                             _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                                 weights + i))));
+  }
+#else
+  for (std::size_t i = 0; i < kHalfDimensions; ++i) {
+    values[i] += weights[i];
+  }
+#endif
+}
+
+void SubtractFeature(const Network& network, std::size_t feature,
+                     std::array<std::int16_t, kHalfDimensions>& values) {
+  const std::int16_t* weights =
+      network.feature_weights.data() + feature * kHalfDimensions;
+#if defined(__AVX2__)
+  for (std::size_t i = 0; i < kHalfDimensions; i += 16) {
+    auto* value = reinterpret_cast<__m256i*>(values.data() + i);
+    _mm256_store_si256(
+        value, _mm256_sub_epi16(_mm256_load_si256(value),
+                                _mm256_loadu_si256(
+                                    reinterpret_cast<const __m256i*>(
+                                        weights + i))));
+  }
+#elif defined(__SSE4_1__)
+  for (std::size_t i = 0; i < kHalfDimensions; i += 8) {
+    auto* value = reinterpret_cast<__m128i*>(values.data() + i);
+    _mm_store_si128(
+        value, _mm_sub_epi16(_mm_load_si128(value),
+                             _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                                 weights + i))));
+  }
+#else
+  for (std::size_t i = 0; i < kHalfDimensions; ++i) {
+    values[i] -= weights[i];
+  }
+#endif
+}
+
+std::int32_t Propagate(const Network& network, const Accumulator& accumulator,
+                       Side side_to_move) {
+  return PropagateImpl</*Scalar=*/false>(network, accumulator, side_to_move);
+}
+
+std::int32_t PropagateScalar(const Network& network,
+                             const Accumulator& accumulator,
+                             Side side_to_move) {
+  return PropagateImpl</*Scalar=*/true>(network, accumulator, side_to_move);
+}
+
+std::string_view GetSimdName() {
+#if defined(__AVX2__)
+  return "AVX2";
+#elif defined(__SSE4_1__)
+  return "SSE4.1";
+#else
+  return "scalar";
+#endif
+}
+
+}  // namespace internal
+
+}  // namespace follychess::nnue
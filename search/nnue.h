@@ -0,0 +1,175 @@
+#ifndef FOLLYCHESS_SEARCH_NNUE_H_
+#define FOLLYCHESS_SEARCH_NNUE_H_
+
+#include <array>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "engine/move.h"
+#include "engine/position.h"
+#include "engine/types.h"
+
+namespace follychess::nnue {
+
+// The network follows the HalfKP architecture: each side sees every non-king
+// piece relative to its own king square. The two 256-wide halves are
+// concatenated, side to move first, and fed through two 32-wide hidden layers
+// into a single output:
+//
+//   (40960 -> 256) x 2 -> 32 -> 32 -> 1
+constexpr std::size_t kNumPieceFeatures = 2 * (kNumPieces - 1) * kNumSquares;
+constexpr std::size_t kNumFeatures = kNumSquares * kNumPieceFeatures;
+constexpr std::size_t kHalfDimensions = 256;
+constexpr std::size_t kHidden1Dimensions = 32;
+constexpr std::size_t kHidden2Dimensions = 32;
+
+// Hidden layer outputs are scaled down by 2^kWeightScaleBits before the
+// clipped ReLU, and the final output is divided by kOutputScale to obtain
+// centipawns.
+constexpr int kWeightScaleBits = 6;
+constexpr int kOutputScale = 16;
+
+// Returns the index of the feature for `piece` of `side` on `square`, as seen
+// from `perspective` whose king is on `king`.
+[[nodiscard]] std::size_t GetFeatureIndex(Side perspective, Square king,
+                                          Piece piece, Side side,
+                                          Square square);
+
+// A fully connected layer with int8 weights and int32 biases. The weights are
+// stored row-major: one row of `Inputs` weights per output.
+template <std::size_t Inputs, std::size_t Outputs>
+struct AffineLayer {
+  static constexpr std::size_t kInputs = Inputs;
+  static constexpr std::size_t kOutputs = Outputs;
+
+  alignas(64) std::array<std::int32_t, Outputs> biases{};
+  alignas(64) std::array<std::int8_t, Inputs * Outputs> weights{};
+};
+
+// The quantized weights of a network.
+//
+// The feature transformer is ~20 MiB, so networks are always heap-allocated
+// and shared by reference between evaluators.
+struct Network {
+  // Parses a network from its binary representation. See `Serialize` for the
+  // format.
+  static std::expected<std::unique_ptr<Network>, std::string> FromBlob(
+      std::string_view blob);
+
+  // Reads and parses a network file.
+  static std::expected<std::unique_ptr<Network>, std::string> FromFile(
+      const std::string& path);
+
+  // Returns a network with small, deterministic pseudo-random weights. This is
+  // useful for testing and benchmarking the inference code, but does not play
+  // well.
+  static std::unique_ptr<Network> Random(std::uint64_t seed);
+
+  // Returns the binary representation of the network: the magic string
+  // "FCNN", a little-endian uint32 version and the layer dimensions, followed
+  // by the biases and weights of each layer in order.
+  [[nodiscard]] std::string Serialize() const;
+
+  alignas(64) std::array<std::int16_t, kHalfDimensions> feature_biases{};
+  std::vector<std::int16_t> feature_weights =
+      std::vector<std::int16_t>(kNumFeatures * kHalfDimensions);
+
+  AffineLayer<2 * kHalfDimensions, kHidden1Dimensions> hidden1;
+  AffineLayer<kHidden1Dimensions, kHidden2Dimensions> hidden2;
+  AffineLayer<kHidden2Dimensions, 1> output;
+};
+
+// The output of the feature transformer for both perspectives.
+struct Accumulator {
+  alignas(64) std::array<std::array<std::int16_t, kHalfDimensions>, kNumSides>
+      values;
+};
+
+// Evaluates the position from scratch, without any incremental state. The
+// score is from white's perspective, like `follychess::Evaluate`.
+[[nodiscard]] int Evaluate(const Network& network, const Position& position);
+
+// Evaluates positions along a line of play, updating the feature transformer
+// incrementally as moves are made and unmade.
+//
+// The accumulator stack mirrors the game's move stack: call `Push` right
+// before `Game::Do` and `Pop` right after `Game::Undo`. Updates are deferred
+// until a position is actually evaluated, so interior nodes that are never
+// evaluated cost only the bookkeeping of the changed pieces.
+class Evaluator {
+ public:
+  explicit Evaluator(const Network& network);
+
+  // Discards the stack and starts a new line at `position`.
+  void Reset(const Position& position);
+
+  // Records `move`, which is about to be made on `position`.
+  void Push(const Position& position, Move move);
+
+  void Pop();
+
+  // Evaluates the position at the top of the stack, which must be `position`.
+  // The score is from white's perspective.
+  [[nodiscard]] int Evaluate(const Position& position);
+
+ private:
+  // A piece that was added to or removed from the board by a move.
+  struct DirtyPiece {
+    Piece piece;
+    Side side;
+    Square square;
+    bool added;
+  };
+
+  struct Entry {
+    Accumulator accumulator;
+    std::array<bool, kNumSides> computed;
+
+    // The changes that lead from the previous entry to this one.
+    std::array<DirtyPiece, 3> dirty_pieces;
+    std::uint8_t num_dirty_pieces;
+    std::array<bool, kNumSides> king_moved;
+  };
+
+  static constexpr std::size_t kInitialStackSize = 128;
+
+  void Update(const Position& position, Side perspective);
+
+  const Network& network_;
+
+  // Entries past `size_` are kept around to avoid reallocating on every push.
+  std::vector<Entry> stack_;
+  std::size_t size_;
+};
+
+namespace internal {
+
+// The inference kernels. The SIMD versions are selected at compile time; the
+// scalar versions are always available so that they can be checked against
+// each other.
+void AddFeature(const Network& network, std::size_t feature,
+                std::array<std::int16_t, kHalfDimensions>& values);
+
+void SubtractFeature(const Network& network, std::size_t feature,
+                     std::array<std::int16_t, kHalfDimensions>& values);
+
+[[nodiscard]] std::int32_t Propagate(const Network& network,
+                                     const Accumulator& accumulator,
+                                     Side side_to_move);
+
+[[nodiscard]] std::int32_t PropagateScalar(const Network& network,
+                                           const Accumulator& accumulator,
+                                           Side side_to_move);
+
+// Returns the name of the instruction set used by the kernels.
+[[nodiscard]] std::string_view GetSimdName();
+
+}  // namespace internal
+
+}  // namespace follychess::nnue
+
+#endif  // FOLLYCHESS_SEARCH_NNUE_H_
@@ -0,0 +1,167 @@
+#include "search/nnue.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "engine/game.h"
+#include "engine/move_generator.h"
+#include "engine/position.h"
+
+namespace follychess::nnue {
+namespace {
+
+using ::testing::Eq;
+using ::testing::HasSubstr;
+using ::testing::Ne;
+
+const Network& GetNetwork() {
+  static const std::unique_ptr<Network> kNetwork = Network::Random(42);
+  return *kNetwork;
+}
+
+Position FromFen(std::string_view fen) {
+  return Position::FromFen(fen).value();
+}
+
+TEST(GetFeatureIndex, IsMirroredForBlack) {
+  EXPECT_THAT(GetFeatureIndex(kWhite, E1, kPawn, kWhite, E2),
+              Eq(GetFeatureIndex(kBlack, E8, kPawn, kBlack, E7)));
+  EXPECT_THAT(GetFeatureIndex(kWhite, G1, kQueen, kBlack, D8),
+              Eq(GetFeatureIndex(kBlack, G8, kQueen, kWhite, D1)));
+
+  EXPECT_THAT(GetFeatureIndex(kWhite, E1, kPawn, kWhite, E2),
+              Ne(GetFeatureIndex(kWhite, E1, kPawn, kBlack, E2)));
+  EXPECT_THAT(GetFeatureIndex(kWhite, E1, kPawn, kWhite, E2),
+              Ne(GetFeatureIndex(kWhite, D1, kPawn, kWhite, E2)));
+}
+
+TEST(GetFeatureIndex, IsInRange) {
+  EXPECT_THAT(GetFeatureIndex(kWhite, A8, kPawn, kWhite, A8), Eq(0));
+  EXPECT_THAT(GetFeatureIndex(kWhite, H1, kQueen, kBlack, H1),
+              Eq(kNumFeatures - 1));
+}
+
+TEST(Network, SerializeRoundTrip) {
+  const Network& network = GetNetwork();
+  auto parsed = Network::FromBlob(network.Serialize());
+  ASSERT_TRUE(parsed.has_value()) << parsed.error();
+
+  EXPECT_THAT((*parsed)->feature_biases, Eq(network.feature_biases));
+  EXPECT_THAT((*parsed)->feature_weights, Eq(network.feature_weights));
+  EXPECT_THAT((*parsed)->hidden1.weights, Eq(network.hidden1.weights));
+  EXPECT_THAT((*parsed)->hidden2.biases, Eq(network.hidden2.biases));
+  EXPECT_THAT((*parsed)->output.weights, Eq(network.output.weights));
+
+  const Position position = Position::Starting();
+  EXPECT_THAT(Evaluate(**parsed, position), Eq(Evaluate(network, position)));
+}
+
+TEST(Network, FromBlobErrors) {
+  EXPECT_THAT(Network::FromBlob("").error_or(""),
+              Eq("Invalid network: missing header."));
+  EXPECT_THAT(Network::FromBlob("NNUE\x01\x00\x00\x00").error_or(""),
+              Eq("Invalid network: missing header."));
+  EXPECT_THAT(Network::FromBlob(std::string_view("FCNN\x02\x00\x00\x00", 8))
+                  .error_or(""),
+              Eq("Invalid network: unsupported version 2."));
+
+  std::string blob = GetNetwork().Serialize();
+  EXPECT_THAT(Network::FromBlob(blob.substr(0, 20)).error_or(""),
+              HasSubstr("the architecture does not match"));
+  EXPECT_THAT(
+      Network::FromBlob(blob.substr(0, blob.size() - 1)).error_or(""),
+      Eq("Invalid network: truncated weights."));
+  EXPECT_THAT(Network::FromBlob(blob + "x").error_or(""),
+              Eq("Invalid network: unexpected trailing data."));
+}
+
+TEST(Network, FromFileMissing) {
+  EXPECT_THAT(Network::FromFile("/does/not/exist.nnue").error_or(""),
+              Eq("Unable to open network file: /does/not/exist.nnue"));
+}
+
+TEST(Propagate, SimdMatchesScalar) {
+  std::mt19937 engine(0);
+  std::uniform_int_distribution<int> distribution(-300, 300);
+
+  for (int i = 0; i < 100; ++i) {
+    Accumulator accumulator;
+    for (auto& values : accumulator.values) {
+      for (std::int16_t& value : values) {
+        value = static_cast<std::int16_t>(distribution(engine));
+      }
+    }
+
+    for (Side side : {kWhite, kBlack}) {
+      EXPECT_THAT(internal::Propagate(GetNetwork(), accumulator, side),
+                  Eq(internal::PropagateScalar(GetNetwork(), accumulator,
+                                               side)));
+    }
+  }
+}
+
+TEST(Evaluate, IsSymmetric) {
+  const Position white_to_move = FromFen(
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+  const Position black_to_move = FromFen(
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR b KQkq - 0 1");
+
+  EXPECT_THAT(Evaluate(GetNetwork(), white_to_move),
+              Eq(-Evaluate(GetNetwork(), black_to_move)));
+}
+
+// Walks the tree of legal moves, checking that the incrementally updated
+// evaluation matches the one computed from scratch. Interior nodes are only
+// evaluated if `evaluate_interior` is set, which exercises the lazy updates
+// across several plies.
+void ExpectIncrementalMatchesFull(Evaluator& evaluator, Game& game, int depth,
+                                  bool evaluate_interior) {
+  const Position& position = game.GetPosition();
+  if (depth == 0 || evaluate_interior) {
+    ASSERT_THAT(evaluator.Evaluate(position),
+                Eq(Evaluate(GetNetwork(), position)))
+        << std::format("{}", position);
+  }
+  if (depth == 0) {
+    return;
+  }
+
+  for (Move move : GenerateMoves(position)) {
+    evaluator.Push(position, move);
+    game.Do(move);
+    if (!position.GetCheckers(~position.SideToMove())) {
+      ExpectIncrementalMatchesFull(evaluator, game, depth - 1,
+                                   evaluate_interior);
+    }
+    game.Undo();
+    evaluator.Pop();
+  }
+}
+
+TEST(Evaluator, IncrementalMatchesFull) {
+  for (std::string_view fen : {
+           // Castling on both sides:
+           "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 "
+           "1",
+           // En passant captures:
+           "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+           // Promotions, with and without captures:
+           "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+       }) {
+    SCOPED_TRACE(fen);
+    const Position position = FromFen(fen);
+
+    Game game(position);
+    Evaluator evaluator(GetNetwork());
+    evaluator.Reset(position);
+    ExpectIncrementalMatchesFull(evaluator, game, /*depth=*/2,
+                                 /*evaluate_interior=*/true);
+    ExpectIncrementalMatchesFull(evaluator, game, /*depth=*/3,
+                                 /*evaluate_interior=*/false);
+  }
+}
+
+}  // namespace
+}  // namespace follychess::nnue
@@ -0,0 +1,64 @@
+#ifndef FOLLYCHESS_SEARCH_OPENING_BOOK_H_
+#define FOLLYCHESS_SEARCH_OPENING_BOOK_H_
+
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "engine/move.h"
+#include "engine/position.h"
+#include "search/mapped_file.h"
+
+namespace follychess {
+
+// Returns the key of `position` in Polyglot books. The key XORs one random
+// number per piece, castling right, capturable en passant file and white to
+// move, laid out as in the Polyglot book format. The numbers are Polyglot's
+// Random64 table, so the keys match books made by other tools.
+[[nodiscard]] std::uint64_t GetPolyglotKey(const Position &position);
+
+struct BookEntry {
+  std::uint64_t key;
+  Move move;
+
+  // The relative frequency with which the move is played.
+  std::uint16_t weight;
+};
+
+// Returns `entries` in the Polyglot binary format: 16-byte big-endian records
+// of key, move, weight and learn data, sorted by key.
+[[nodiscard]] std::string SerializeBook(std::vector<BookEntry> entries);
+
+// An opening book in the Polyglot binary format. The file is memory mapped,
+// and lookups binary search its sorted records.
+class OpeningBook {
+ public:
+  static std::expected<std::unique_ptr<OpeningBook>, std::string> Open(
+      const std::string &path);
+
+  [[nodiscard]] std::size_t GetNumEntries() const;
+
+  // Returns the book moves for `position` in the order of the file. Moves that
+  // are not legal in the position are skipped.
+  [[nodiscard]] std::vector<BookEntry> GetMoves(
+      const Position &position) const;
+
+  // Picks one of the book moves for `position` with a probability proportional
+  // to its weight. `random` selects the move and is typically drawn from a
+  // uniform distribution.
+  [[nodiscard]] std::optional<Move> ChooseMove(const Position &position,
+                                               std::uint64_t random) const;
+
+ private:
+  explicit OpeningBook(MappedFile file) : file_(std::move(file)) {}
+
+  MappedFile file_;
+};
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_SEARCH_OPENING_BOOK_H_
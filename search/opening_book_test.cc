@@ -0,0 +1,195 @@
+#include "search/opening_book.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "engine/move.h"
+#include "engine/position.h"
+
+namespace follychess {
+namespace {
+
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::FieldsAre;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::Ne;
+using ::testing::Optional;
+
+constexpr std::string_view kStartFen =
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+Position FromFen(std::string_view fen) {
+  auto position = Position::FromFen(fen);
+  CHECK(position.has_value()) << position.error();
+  return *position;
+}
+
+std::unique_ptr<OpeningBook> WriteBook(const std::string &name,
+                                       std::vector<BookEntry> entries) {
+  const std::string path = testing::TempDir() + name;
+  std::ofstream(path, std::ios::binary) << SerializeBook(std::move(entries));
+
+  auto book = OpeningBook::Open(path);
+  CHECK(book.has_value()) << book.error();
+  return std::move(book.value());
+}
+
+// The test vectors from the Polyglot book format specification.
+TEST(GetPolyglotKey, MatchesSpecification) {
+  constexpr struct {
+    std::string_view fen;
+    std::uint64_t key;
+  } kTestCases[] = {
+      {kStartFen, 0x463b96181691fc9c},
+      {"rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1",
+       0x823c9b50fd114196},
+      {"rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 2",
+       0x0756b94461c50fb0},
+      {"rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 2",
+       0x662fafb965db29d4},
+      {"rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+       0x22a48b5a8e47ff78},
+      {"rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR b kq - 0 3",
+       0x652a607ca3f242c1},
+      {"rnbq1bnr/ppp1pkpp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR w - - 0 4",
+       0x00fdd303c946bdd9},
+      {"rnbqkbnr/p1pppppp/8/8/PpP4P/8/1P1PPPP1/RNBQKBNR b KQkq c3 0 3",
+       0x3c8123ea7b067637},
+      {"rnbqkbnr/p1pppppp/8/8/P6P/R1p5/1P1PPPP1/1NBQKBNR b Kkq - 0 4",
+       0x5c3f9b829b279560},
+  };
+
+  for (const auto &[fen, key] : kTestCases) {
+    EXPECT_THAT(GetPolyglotKey(FromFen(fen)), Eq(key)) << fen;
+  }
+}
+
+TEST(GetPolyglotKey, Transpositions) {
+  const Position start = FromFen(kStartFen);
+  Position position = start;
+  position.Do(Move(G1, F3));
+  EXPECT_THAT(GetPolyglotKey(position), Ne(GetPolyglotKey(start)));
+
+  position.Do(Move(G8, F6));
+  position.Do(Move(F3, G1));
+  position.Do(Move(F6, G8));
+  EXPECT_THAT(GetPolyglotKey(position), Eq(GetPolyglotKey(start)));
+
+  EXPECT_THAT(GetPolyglotKey(FromFen(
+                  "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR b KQkq - 0 1")),
+              Ne(GetPolyglotKey(start)));
+  EXPECT_THAT(GetPolyglotKey(FromFen(
+                  "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w Kkq - 0 1")),
+              Ne(GetPolyglotKey(start)));
+}
+
+TEST(GetPolyglotKey, OnlyCapturableEnPassantTargets) {
+  // No black pawn can capture on e3.
+  EXPECT_THAT(
+      GetPolyglotKey(FromFen(
+          "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1")),
+      Eq(GetPolyglotKey(FromFen(
+          "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1"))));
+
+  // The pawn on d4 can.
+  EXPECT_THAT(
+      GetPolyglotKey(FromFen(
+          "rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1")),
+      Ne(GetPolyglotKey(FromFen(
+          "rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1"))));
+}
+
+TEST(OpeningBook, GetMoves) {
+  const Position start = FromFen(kStartFen);
+  const std::uint64_t key = GetPolyglotKey(start);
+  const std::unique_ptr<OpeningBook> book = WriteBook(
+      "opening_book_test_moves",
+      {
+          {.key = key + 1, .move = Move(A2, A3), .weight = 1},
+          {.key = key, .move = Move(E2, E4), .weight = 3},
+          {.key = key - 1, .move = Move(A2, A3), .weight = 1},
+          {.key = key, .move = Move(D2, D4), .weight = 1},
+          // The move is not legal, so it is skipped.
+          {.key = key, .move = Move(E2, E5), .weight = 10},
+      });
+  EXPECT_THAT(book->GetNumEntries(), Eq(5));
+
+  EXPECT_THAT(
+      book->GetMoves(start),
+      ElementsAre(FieldsAre(key, Move(E2, E4, Move::kDoublePawnPush), 3),
+                  FieldsAre(key, Move(D2, D4, Move::kDoublePawnPush), 1)));
+  EXPECT_THAT(book->GetMoves(FromFen(
+                  "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1")),
+              IsEmpty());
+}
+
+TEST(OpeningBook, ChooseMoveByWeight) {
+  const Position start = FromFen(kStartFen);
+  const std::uint64_t key = GetPolyglotKey(start);
+  const std::unique_ptr<OpeningBook> book =
+      WriteBook("opening_book_test_weights",
+                {
+                    {.key = key, .move = Move(E2, E4), .weight = 3},
+                    {.key = key, .move = Move(D2, D4), .weight = 1},
+                });
+
+  const Move e4(E2, E4, Move::kDoublePawnPush);
+  const Move d4(D2, D4, Move::kDoublePawnPush);
+  EXPECT_THAT(book->ChooseMove(start, 0), Optional(e4));
+  EXPECT_THAT(book->ChooseMove(start, 2), Optional(e4));
+  EXPECT_THAT(book->ChooseMove(start, 3), Optional(d4));
+  EXPECT_THAT(book->ChooseMove(start, 7), Optional(d4));
+
+  const Position other = FromFen("4k3/8/8/8/8/8/8/4K3 w - - 0 1");
+  EXPECT_THAT(book->ChooseMove(other, 0), Eq(std::nullopt));
+}
+
+TEST(OpeningBook, SpecialMoves) {
+  const Position castling =
+      FromFen("r3k2r/pppqbppp/8/8/8/8/PPPQBPPP/R3K2R w KQkq - 0 1");
+  const Position promotion = FromFen("8/4P3/8/8/8/8/k7/4K3 w - - 0 1");
+  const std::unique_ptr<OpeningBook> book = WriteBook(
+      "opening_book_test_special",
+      {
+          {.key = GetPolyglotKey(castling),
+           .move = Move(E1, G1, Move::kKingCastle),
+           .weight = 1},
+          {.key = GetPolyglotKey(castling),
+           .move = Move(E1, C1, Move::kQueenCastle),
+           .weight = 1},
+          {.key = GetPolyglotKey(promotion),
+           .move = Move(E7, E8, Move::kKnightPromotion),
+           .weight = 1},
+      });
+
+  EXPECT_THAT(book->GetMoves(castling),
+              ElementsAre(FieldsAre(_, Move(E1, G1, Move::kKingCastle), 1),
+                          FieldsAre(_, Move(E1, C1, Move::kQueenCastle), 1)));
+  EXPECT_THAT(book->GetMoves(promotion),
+              ElementsAre(FieldsAre(_, Move(E7, E8, Move::kKnightPromotion), 1)));
+}
+
+TEST(OpeningBook, OpenErrors) {
+  EXPECT_THAT(OpeningBook::Open("/does/not/exist").error_or(""),
+              HasSubstr("Unable to open file: "));
+
+  const std::string path = testing::TempDir() + "opening_book_test_invalid";
+  std::ofstream(path, std::ios::binary) << "not a book";
+  EXPECT_THAT(OpeningBook::Open(path).error_or(""),
+              Eq("Invalid book file: " + path));
+}
+
+}  // namespace
+}  // namespace follychess
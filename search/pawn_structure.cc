@@ -0,0 +1,138 @@
+#include "search/pawn_structure.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "absl/log/check.h"
+#include "engine/bitboard.h"
+#include "engine/position.h"
+#include "engine/types.h"
+
+namespace follychess {
+namespace {
+
+constexpr int kDoubledPawnPenalty = 15;
+constexpr int kIsolatedPawnPenalty = 12;
+constexpr int kBackwardPawnPenalty = 8;
+
+// Passed pawn bonuses indexed by the pawn's rank relative to its side, where
+// index 0 is the side's back rank.
+constexpr std::array<int, kRanks> kPassedPawnBonus = {
+    0, 5, 10, 20, 35, 60, 100, 0,
+};
+
+template <Side Side>
+[[nodiscard]] constexpr Bitboard FillForward(Bitboard pawns) {
+  if constexpr (Side == kWhite) {
+    pawns |= pawns >> 8;
+    pawns |= pawns >> 16;
+    pawns |= pawns >> 32;
+  } else {
+    pawns |= pawns << 8;
+    pawns |= pawns << 16;
+    pawns |= pawns << 32;
+  }
+  return pawns;
+}
+
+template <Side Side>
+[[nodiscard]] constexpr Bitboard GetPawnAttackSet(Bitboard pawns) {
+  if constexpr (Side == kWhite) {
+    return pawns.Shift<kNorthEast>() | pawns.Shift<kNorthWest>();
+  } else {
+    return pawns.Shift<kSouthEast>() | pawns.Shift<kSouthWest>();
+  }
+}
+
+template <Side Side>
+[[nodiscard]] constexpr int GetRelativeRank(Square square) {
+  if constexpr (Side == kWhite) {
+    return kRanks - 1 - GetRank(square);
+  } else {
+    return GetRank(square);
+  }
+}
+
+template <Side Side>
+[[nodiscard]] int EvaluatePawns(const Position& position, Bitboard& passed) {
+  constexpr Direction kForward = Side == kWhite ? kNorth : kSouth;
+  constexpr Direction kBackward = Side == kWhite ? kSouth : kNorth;
+
+  const Bitboard own = position.GetPieces(Side, kPawn);
+  const Bitboard enemy = position.GetPieces(~Side, kPawn);
+
+  const Bitboard files = FillForward<kWhite>(own) | FillForward<kBlack>(own);
+  const Bitboard adjacent_files = files.Shift<kEast>() | files.Shift<kWest>();
+
+  // The frontmost pawn of each file is not counted as doubled; all the ones
+  // behind it are.
+  const Bitboard doubled = own & FillForward<~Side>(own.Shift<kBackward>());
+
+  const Bitboard isolated = own & ~adjacent_files;
+
+  // A pawn is backward if it cannot safely advance because an enemy pawn
+  // controls its stop square, and no friendly pawn can ever come to its
+  // support.
+  const Bitboard stops = own.Shift<kForward>();
+  const Bitboard supported = FillForward<Side>(GetPawnAttackSet<Side>(own));
+  const Bitboard unsafe_stops =
+      stops & GetPawnAttackSet<~Side>(enemy) & ~supported;
+  const Bitboard backward =
+      unsafe_stops.Shift<kBackward>() & own & ~isolated;
+
+  // A pawn is passed if no enemy pawn stands in front of it on its own file or
+  // on the adjacent files.
+  Bitboard enemy_span = FillForward<~Side>(enemy.Shift<kBackward>());
+  enemy_span |= enemy_span.Shift<kEast>() | enemy_span.Shift<kWest>();
+  passed = own & ~enemy_span & ~doubled;
+
+  int score = -kDoubledPawnPenalty * doubled.GetCount() -
+              kIsolatedPawnPenalty * isolated.GetCount() -
+              kBackwardPawnPenalty * backward.GetCount();
+
+  Bitboard passed_pawns = passed;
+  while (passed_pawns) {
+    const Square square = passed_pawns.PopLeastSignificantBit();
+    score += kPassedPawnBonus[GetRelativeRank<Side>(square)];
+  }
+
+  return score;
+}
+
+}  // namespace
+
+PawnStructure EvaluatePawnStructure(const Position& position) {
+  PawnStructure result;
+  result.score = EvaluatePawns<kWhite>(position, result.passed[kWhite]) -
+                 EvaluatePawns<kBlack>(position, result.passed[kBlack]);
+  return result;
+}
+
+PawnTable::PawnTable(std::size_t entries)
+    : entries_(entries), mask_(entries - 1), probes_(0), hits_(0) {
+  CHECK(std::has_single_bit(entries))
+      << "The number of pawn table entries must be a power of two: "
+      << entries;
+}
+
+void PawnTable::Clear() { std::ranges::fill(entries_, Entry()); }
+
+const PawnStructure& PawnTable::Probe(const Position& position) {
+  ++probes_;
+
+  const std::uint64_t key = position.GetPawnKey();
+  Entry& entry = entries_[key & mask_];
+  if (entry.valid && entry.key == key) {
+    ++hits_;
+    return entry.pawn_structure;
+  }
+
+  entry = {
+      .key = key,
+      .valid = true,
+      .pawn_structure = EvaluatePawnStructure(position),
+  };
+  return entry.pawn_structure;
+}
+
+}  // namespace follychess
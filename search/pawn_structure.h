@@ -0,0 +1,66 @@
+#ifndef FOLLYCHESS_SEARCH_PAWN_STRUCTURE_H_
+#define FOLLYCHESS_SEARCH_PAWN_STRUCTURE_H_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "engine/bitboard.h"
+#include "engine/position.h"
+#include "engine/types.h"
+
+namespace follychess {
+
+// The pawn-only evaluation terms of a position. Since these depend on nothing
+// but the pawns, they can be cached by the position's pawn key.
+struct PawnStructure {
+  // The pawn-structure score from white's perspective.
+  int score = 0;
+
+  // The passed pawns of each side.
+  std::array<Bitboard, kNumSides> passed;
+};
+
+// Evaluates doubled, isolated, backward, and passed pawns from scratch.
+[[nodiscard]] PawnStructure EvaluatePawnStructure(const Position& position);
+
+// A fixed-size cache of `PawnStructure` values keyed by `Position::GetPawnKey`.
+//
+// Pawn structures change rarely between neighboring nodes of the search tree,
+// so the hit rate is typically very high. The table is not thread-safe: each
+// search thread is expected to own its own table.
+class PawnTable {
+ public:
+  // The number of entries must be a power of two.
+  explicit PawnTable(std::size_t entries = kDefaultEntries);
+
+  // Returns the pawn structure for the position, computing and storing it on a
+  // miss.
+  [[nodiscard]] const PawnStructure& Probe(const Position& position);
+
+  // Removes all entries.
+  void Clear();
+
+  [[nodiscard]] std::int64_t GetProbes() const { return probes_; }
+
+  [[nodiscard]] std::int64_t GetHits() const { return hits_; }
+
+ private:
+  static constexpr std::size_t kDefaultEntries = 1 << 14;
+
+  struct Entry {
+    std::uint64_t key{0};
+    bool valid{false};
+    PawnStructure pawn_structure;
+  };
+
+  std::vector<Entry> entries_;
+  std::uint64_t mask_;
+
+  std::int64_t probes_;
+  std::int64_t hits_;
+};
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_SEARCH_PAWN_STRUCTURE_H_
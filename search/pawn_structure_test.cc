@@ -0,0 +1,129 @@
+#include "search/pawn_structure.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "engine/position.h"
+#include "engine/scoped_move.h"
+#include "engine/testing.h"
+
+namespace follychess {
+namespace {
+
+using ::testing::Eq;
+
+TEST(EvaluatePawnStructure, Starting) {
+  PawnStructure pawn_structure = EvaluatePawnStructure(Position::Starting());
+  EXPECT_THAT(pawn_structure.score, Eq(0));
+  EXPECT_THAT(pawn_structure.passed[kWhite], EqualsBitboard(kEmptyBoard));
+  EXPECT_THAT(pawn_structure.passed[kBlack], EqualsBitboard(kEmptyBoard));
+}
+
+TEST(EvaluatePawnStructure, DoubledAndIsolated) {
+  PawnStructure pawn_structure =
+      EvaluatePawnStructure(MakePosition("8: . . . . k . . ."
+                                         "7: . . . . . p p ."
+                                         "6: . . . . . . . ."
+                                         "5: . . . . . . . ."
+                                         "4: . . . . . . . ."
+                                         "3: . . P . . . . ."
+                                         "2: . . P . . . . ."
+                                         "1: . . . . K . . ."
+                                         "   a b c d e f g h"
+                                         //
+                                         "   w - - 0 1"));
+
+  // White: c2 is doubled, and both c-pawns are isolated. Only c3 is passed.
+  //
+  // Black: f7 and g7 are passed on their second rank.
+  EXPECT_THAT(pawn_structure.score, Eq((-15 - 2 * 12 + 10) - (5 + 5)));
+  EXPECT_THAT(pawn_structure.passed[kWhite], EqualsBitboard(Bitboard(C3)));
+  EXPECT_THAT(pawn_structure.passed[kBlack],
+              EqualsBitboard(Bitboard(F7) | Bitboard(G7)));
+}
+
+TEST(EvaluatePawnStructure, Passed) {
+  PawnStructure pawn_structure =
+      EvaluatePawnStructure(MakePosition("8: . . . . k . . ."
+                                         "7: p . . . . . . ."
+                                         "6: . . . . . . . ."
+                                         "5: . . . . P . . ."
+                                         "4: . . . . . . . ."
+                                         "3: . . . . . . . ."
+                                         "2: . . . . . . . ."
+                                         "1: . . . . K . . ."
+                                         "   a b c d e f g h"
+                                         //
+                                         "   w - - 0 1"));
+
+  EXPECT_THAT(pawn_structure.score, Eq((35 - 12) - (5 - 12)));
+  EXPECT_THAT(pawn_structure.passed[kWhite], EqualsBitboard(Bitboard(E5)));
+  EXPECT_THAT(pawn_structure.passed[kBlack], EqualsBitboard(Bitboard(A7)));
+}
+
+TEST(EvaluatePawnStructure, Backward) {
+  PawnStructure pawn_structure =
+      EvaluatePawnStructure(MakePosition("8: . . . . k . . ."
+                                         "7: . . . . . . . ."
+                                         "6: . . . . . . . ."
+                                         "5: . . . . p . . ."
+                                         "4: . . P . . . . ."
+                                         "3: . . . P . . . ."
+                                         "2: . . . . . . . ."
+                                         "1: . . . . K . . ."
+                                         "   a b c d e f g h"
+                                         //
+                                         "   w - - 0 1"));
+
+  // White: d3 is backward because e5 controls d4, and c4 is passed.
+  //
+  // Black: e5 is isolated. It is not also counted as backward.
+  EXPECT_THAT(pawn_structure.score, Eq((-8 + 20) - (-12)));
+  EXPECT_THAT(pawn_structure.passed[kWhite], EqualsBitboard(Bitboard(C4)));
+  EXPECT_THAT(pawn_structure.passed[kBlack], EqualsBitboard(kEmptyBoard));
+}
+
+TEST(EvaluatePawnStructure, Symmetric) {
+  PawnStructure pawn_structure =
+      EvaluatePawnStructure(MakePosition("8: . . . . k . . ."
+                                         "7: p . . p . . p ."
+                                         "6: . . . p . . . ."
+                                         "5: . . . . . . . ."
+                                         "4: . . . . . . . ."
+                                         "3: . . . P . . . ."
+                                         "2: P . . P . . P ."
+                                         "1: . . . . K . . ."
+                                         "   a b c d e f g h"
+                                         //
+                                         "   w - - 0 1"));
+
+  EXPECT_THAT(pawn_structure.score, Eq(0));
+}
+
+TEST(PawnTable, Probe) {
+  PawnTable pawn_table(/*entries=*/16);
+  Position position = Position::Starting();
+
+  EXPECT_THAT(pawn_table.Probe(position).score, Eq(0));
+  EXPECT_THAT(pawn_table.GetProbes(), Eq(1));
+  EXPECT_THAT(pawn_table.GetHits(), Eq(0));
+
+  {
+    // A knight move keeps the pawn structure intact.
+    ScopedMove move(Move(G1, F3), position);
+    EXPECT_THAT(pawn_table.Probe(position).score, Eq(0));
+    EXPECT_THAT(pawn_table.GetProbes(), Eq(2));
+    EXPECT_THAT(pawn_table.GetHits(), Eq(1));
+  }
+
+  {
+    ScopedMove move(Move(E2, E4, Move::Flags::kDoublePawnPush), position);
+    EXPECT_THAT(pawn_table.Probe(position).score,
+                Eq(EvaluatePawnStructure(position).score));
+    EXPECT_THAT(pawn_table.GetProbes(), Eq(3));
+    EXPECT_THAT(pawn_table.GetHits(), Eq(1));
+  }
+}
+
+}  // namespace
+}  // namespace follychess
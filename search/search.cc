@@ -1,85 +1,343 @@
 #include "search/search.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <format>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/log/check.h"
+#include "absl/log/log.h"
 #include "engine/move.h"
 #include "engine/move_generator.h"
+#include "engine/move_list.h"
 #include "engine/position.h"
-#include "engine/scoped_move.h"
 #include "engine/types.h"
+#include "search/eval_cache.h"
 #include "search/evaluation.h"
 #include "search/move_ordering.h"
-#include "transposition.h"
+#include "search/nnue.h"
+#include "search/pawn_structure.h"
+#include "search/search_stats.h"
+#include "search/transposition.h"
 
 namespace follychess {
 namespace {
 
+// Makes a move on the game for the duration of the scope. If an NNUE
+// evaluator is used, its accumulator stack is kept in sync with the game.
+class ScopedSearchMove {
+ public:
+  ScopedSearchMove(Move move, Game &game, nnue::Evaluator *evaluator)
+      : ScopedSearchMove(game.GetPosition().ExtendMove(move), game,
+                         evaluator) {}
+
+  ScopedSearchMove(ExtendedMove move, Game &game, nnue::Evaluator *evaluator)
+      : game_(game), evaluator_(evaluator) {
+    if (evaluator_) {
+      evaluator_->Push(game_.GetPosition(), move.GetMove());
+    }
+    game_.Do(move);
+  }
+
+  ~ScopedSearchMove() {
+    game_.Undo();
+    if (evaluator_) {
+      evaluator_->Pop();
+    }
+  }
+
+  ScopedSearchMove(const ScopedSearchMove &) = delete;
+
+  ScopedSearchMove &operator=(const ScopedSearchMove &) = delete;
+
+ private:
+  Game &game_;
+  nnue::Evaluator *evaluator_;
+};
+
+// Scores beyond this bound are mate scores.
+constexpr int kMateThreshold = kCheckMateScore - SearchStats::kMaxPly;
+
+// Mate scores are relative to the root of the search. The transposition table
+// stores them relative to the position instead, so that they can be reused at
+// other plies and by later searches.
+[[nodiscard]] constexpr int ToTranspositionScore(int score, int ply) {
+  if (score > kMateThreshold) {
+    return score + ply;
+  }
+  if (score < -kMateThreshold) {
+    return score - ply;
+  }
+  return score;
+}
+
+[[nodiscard]] constexpr int FromTranspositionScore(int score, int ply) {
+  if (score > kMateThreshold) {
+    return score - ply;
+  }
+  if (score < -kMateThreshold) {
+    return score + ply;
+  }
+  return score;
+}
+
 class AlphaBetaSearcher {
  public:
-  AlphaBetaSearcher(const Game& game, const SearchOptions& options)
+  AlphaBetaSearcher(Game& game, const SearchOptions& options,
+                    TranspositionTable& transpositions, PawnTable& pawn_table,
+                    EvalCache& eval_cache, nnue::Evaluator* nnue_evaluator)
       : game_{game},
         position_{game_.GetPosition()},
-        requested_search_depth_{options.depth},
+        max_depth_{std::clamp(options.depth, 1, kMaxSearchDepth)},
+        max_nodes_{options.nodes},
+        move_time_{options.move_time},
+        control_{options.control},
+        mate_{options.mate},
+        multi_pv_{std::max(options.multi_pv, 1)},
         log_every_n_{options.log_every_n},
-        nodes_{0},
-        transpositions_{position_} {}
+        dump_stats_{options.dump_stats},
+        on_iteration_{options.on_iteration},
+        transpositions_{transpositions},
+        pawn_table_{pawn_table},
+        eval_cache_{eval_cache},
+        nnue_evaluator_{nnue_evaluator} {}
+
+  [[nodiscard]] SearchResult Run() {
+    start_time_ = std::chrono::steady_clock::now();
+    pondering_ = control_ && control_->IsPondering();
+    if (!pondering_) {
+      StartClock(start_time_);
+    }
 
-  [[nodiscard]] Move GetBestMove() {
-    if (best_move_) {
-      return *best_move_;
+    const int num_lines = std::min(multi_pv_, CountLegalMoves());
+    if (num_lines == 0) {
+      // The side to move is checkmated or stalemated, so there is no move to
+      // search.
+      SearchResult result;
+      result.score = CurrentSideInCheck() ? -kCheckMateScore : 0;
+      result.elapsed = GetElapsed();
+      result.stats = stats_;
+      return result;
     }
 
-    start_time_ = std::chrono::system_clock::now();
+    // The lines are allocated up front, so that the iterations do not
+    // allocate.
+    for (std::vector<SearchLine>* lines : {&lines_, &completed_lines_}) {
+      lines->resize(num_lines);
+      for (SearchLine& line : *lines) {
+        line.pv.reserve(SearchStats::kMaxPly);
+      }
+    }
+    excluded_root_moves_.reserve(num_lines);
+
+    SearchResult result;
+    result.pv.reserve(SearchStats::kMaxPly);
+    for (int depth = 1; depth <= max_depth_; ++depth) {
+      search_depth_ = depth;
 
-    constexpr static int kAlpha = -100'000;
-    constexpr static int kBeta = 100'000;
-    Search(kAlpha, kBeta, 0);
-    DCHECK(best_move_.has_value());
+      const std::int64_t start_nodes = stats_.GetNodes();
+      if (!SearchLines(num_lines)) {
+        break;
+      }
+      stats_.CompleteIteration(depth, stats_.GetNodes() - start_nodes);
+      std::swap(lines_, completed_lines_);
+
+      const SearchLine& best_line = completed_lines_.front();
+      result.best_move = best_line.pv.front();
+      result.score = best_line.score;
+      result.pv.assign(best_line.pv.begin(), best_line.pv.end());
+      result.depth = depth;
+      LogIteration(depth, completed_lines_);
+      if (on_iteration_) {
+        result.elapsed = GetElapsed();
+        result.stats = stats_;
+        on_iteration_(result);
+      }
+
+      if (mate_ > 0) {
+        std::optional<int> mate_distance = GetMateDistance(result.score);
+        if (mate_distance && *mate_distance > 0 && *mate_distance <= mate_) {
+          break;
+        }
+      }
+
+      // The next iteration is unlikely to complete in the remaining time.
+      if (!IsPondering() && soft_deadline_ &&
+          std::chrono::steady_clock::now() >= *soft_deadline_) {
+        break;
+      }
+    }
+
+    if (result.depth > 0) {
+      result.lines = completed_lines_;
+    } else {
+      // The search was aborted before the first iteration completed.
+      result.best_move = best_move_ ? *best_move_ : GetFirstLegalMove();
+    }
 
-    return *best_move_;
+    stats_.tt_probes = transpositions_.GetProbes();
+    stats_.tt_hits = transpositions_.GetHits();
+    stats_.tt_collisions = transpositions_.GetCollisions();
+    stats_.tt_overwrites = transpositions_.GetOverwrites();
+    stats_.hashfull = transpositions_.GetHashFull();
+    if (dump_stats_) {
+      std::println(std::cout, "{}", stats_);
+    }
+
+    result.elapsed = GetElapsed();
+    result.stats = stats_;
+    return result;
   }
 
  private:
+  // Searches the root for the `num_lines` best moves, one at a time, into
+  // `lines_`. Each search excludes the root moves found by the earlier ones.
+  // The lines of the previous iteration determine which move each search tries
+  // first. The lines are sorted from best to worst. Returns false if the
+  // search was aborted.
+  [[nodiscard]] bool SearchLines(int num_lines) {
+    excluded_root_moves_.clear();
+
+    for (int i = 0; i < num_lines; ++i) {
+      best_move_.reset();
+      previous_best_move_.reset();
+      if (search_depth_ > 1) {
+        previous_best_move_ = completed_lines_[i].pv.front();
+      }
+
+      constexpr static int kAlpha = -100'000;
+      constexpr static int kBeta = 100'000;
+      const int score = Search(kAlpha, kBeta, 0);
+      if (aborted_) {
+        return false;
+      }
+      DCHECK(best_move_.has_value());
+
+      SearchLine& line = lines_[i];
+      line.score = score;
+      line.pv.assign(pv_[0].begin(), pv_[0].begin() + pv_length_[0]);
+      excluded_root_moves_.push_back(*best_move_);
+
+      // Insert the line after the ones that score at least as well, which
+      // keeps the sort stable without allocating.
+      const auto it =
+          std::ranges::upper_bound(lines_.begin(), lines_.begin() + i, score,
+                                   std::ranges::greater(), &SearchLine::score);
+      std::rotate(it, lines_.begin() + i, lines_.begin() + i + 1);
+    }
+    return true;
+  }
+
   // NOLINTNEXTLINE(misc-no-recursion)
-  int Search(int alpha, const int beta, const int depth) {
+  int Search(int alpha, int beta, const int depth) {
     using enum TranspositionTable::BoundType;
 
-    ++nodes_;
+    if (CheckLimits()) {
+      return 0;
+    }
+    ++stats_.main_nodes;
+    stats_.CountNode(depth);
     MaybeLog(depth);
+    pv_length_[depth] = 0;
 
-    if (game_.GetRepetitionCount() >= 3) {
-      // TODO(aryann): Figure out what when draws can be offered due to the
-      // three repetition rule.
-      return 0;
+    // The root must always be searched, so that a best move is found.
+    const bool is_root = depth == 0;
+
+    if (!is_root) {
+      if (game_.IsRepetition(depth)) {
+        return 0;
+      }
+
+      // If the side to move can repeat an earlier position, the position is
+      // at least a draw.
+      if (alpha < 0 && game_.HasUpcomingRepetition(depth)) {
+        alpha = 0;
+        if (alpha >= beta) {
+          return alpha;
+        }
+      }
+
+      // Mate distance pruning: even mating on the next move cannot beat a
+      // mate that was already found closer to the root.
+      alpha = std::max(alpha, -kCheckMateScore + depth);
+      beta = std::min(beta, kCheckMateScore - depth - 1);
+      if (alpha >= beta) {
+        return alpha;
+      }
     }
 
-    if (std::optional<int> score = transpositions_.Probe(alpha, beta, depth)) {
-      return *score;
+    const std::uint64_t key = position_.GetKey();
+    const int remaining_depth = search_depth_ - depth;
+    if (std::optional<int> score = transpositions_.Probe(
+            key, ToTranspositionScore(alpha, depth),
+            ToTranspositionScore(beta, depth), remaining_depth);
+        score && !is_root) {
+      return FromTranspositionScore(*score, depth);
     }
 
-    if (depth == requested_search_depth_) {
-      int score = QuiescentSearch(alpha, beta, 1);
-      transpositions_.Record(score, depth, Exact);
+    if (remaining_depth == 0) {
+      const int score = QuiescentSearch(alpha, beta, 1);
+      if (aborted_) {
+        return 0;
+      }
+      const TranspositionTable::BoundType type = score <= alpha  ? UpperBound
+                                                 : score >= beta ? LowerBound
+                                                                 : Exact;
+      transpositions_.Record(key, ToTranspositionScore(score, depth), 0, type);
       return score;
     }
 
-    bool has_legal_moves = false;
-    std::vector<Move> moves = GenerateMoves(position_);
-    OrderMoves(position_, moves);
+    int legal_moves = 0;
+    ExtendedMoveList moves;
+    GenerateMoves(position_, moves);
+    OrderMoves(moves);
+    if (is_root && previous_best_move_) {
+      // Search the best move of the previous iteration first.
+      if (auto it = std::ranges::find(moves, *previous_best_move_,
+                                      &ExtendedMove::GetMove);
+          it != moves.end()) {
+        std::rotate(moves.begin(), it, it + 1);
+      }
+    }
+
+    // A root search that excludes some moves does not produce the score of
+    // the position, so it must not be stored.
+    const bool record = !is_root || excluded_root_moves_.empty();
 
     TranspositionTable::BoundType transposition_type = UpperBound;
-    for (Move move : moves) {
-      ScopedMove2 scoped_move(move, game_);
+    for (ExtendedMove extended_move : moves) {
+      const Move move = extended_move.GetMove();
+      if (is_root && IsExcludedRootMove(move)) {
+        continue;
+      }
+      ScopedSearchMove scoped_move(extended_move, game_, nnue_evaluator_);
       if (!IsLastMoveLegal()) {
         continue;
       }
-      has_legal_moves = true;
+      ++legal_moves;
 
       const int score = -Search(-beta, -alpha, depth + 1);
+      if (aborted_) {
+        return 0;
+      }
 
       if (score >= beta) {
-        transpositions_.Record(score, depth, LowerBound);
+        ++stats_.beta_cutoffs;
+        if (legal_moves == 1) {
+          ++stats_.first_move_cutoffs;
+        }
+        if (record) {
+          transpositions_.Record(key, ToTranspositionScore(score, depth),
+                                 remaining_depth, LowerBound);
+        }
 
         return beta;
       }
@@ -87,7 +345,8 @@ class AlphaBetaSearcher {
       if (score > alpha) {
         alpha = score;
         transposition_type = Exact;
-        if (depth == 0) {
+        UpdatePrincipalVariation(move, depth);
+        if (is_root) {
           // Store this move as the best move if and only if this is a root
           // node.
           best_move_ = move;
@@ -95,16 +354,17 @@ class AlphaBetaSearcher {
       }
     }
 
-    if (has_legal_moves) {
-      transpositions_.Record(alpha, depth, transposition_type);
+    if (legal_moves > 0) {
+      if (record) {
+        transpositions_.Record(key, ToTranspositionScore(alpha, depth),
+                               remaining_depth, transposition_type);
+      }
       return alpha;
     }
 
     if (CurrentSideInCheck()) {
-      constexpr int kBaseCheckMateScore = -20'000;
-
       // Favor checkmates closer to the root of the tree.
-      return kBaseCheckMateScore + depth;
+      return -kCheckMateScore + depth;
     }
 
     constexpr int kStalemateScore = 0;
@@ -114,8 +374,16 @@ class AlphaBetaSearcher {
   // NOLINTNEXTLINE(misc-no-recursion)
   [[nodiscard]] int QuiescentSearch(int alpha, const int beta,
                                     const int depth) {
-    ++nodes_;
-    MaybeLog(requested_search_depth_, depth);
+    // The first quiescent search node is the horizon node of the main search,
+    // which has already been counted.
+    if (depth > 1) {
+      if (CheckLimits()) {
+        return 0;
+      }
+      ++stats_.quiescent_nodes;
+      stats_.CountNode(search_depth_ + depth - 1);
+    }
+    MaybeLog(search_depth_, depth);
 
     int score = GetScore();
     if (score >= beta) {
@@ -123,16 +391,20 @@ class AlphaBetaSearcher {
     }
     alpha = std::max(alpha, score);
 
-    std::vector<Move> moves = GenerateMoves<kCapture>(position_);
-    OrderMoves(position_, moves);
-    for (Move move : moves) {
-      ScopedMove2 scoped_move(move, game_);
+    ExtendedMoveList moves;
+    GenerateMoves<kCapture>(position_, moves);
+    OrderMoves(moves);
+    for (ExtendedMove move : moves) {
+      ScopedSearchMove scoped_move(move, game_, nnue_evaluator_);
       const bool is_legal = !position_.GetCheckers(~position_.SideToMove());
       if (!is_legal) {
         continue;
       }
 
       score = -QuiescentSearch(-beta, -alpha, depth + 1);
+      if (aborted_) {
+        return 0;
+      }
 
       if (score >= beta) {
         return beta;
@@ -143,11 +415,103 @@ class AlphaBetaSearcher {
     return alpha;
   }
 
-  [[nodiscard]] int GetScore() const {
-    const int score = Evaluate(position_);
+  // Returns true if the search must stop because a limit is reached or the
+  // search was stopped. The clock and the control are only polled every
+  // kPollEveryN nodes.
+  [[nodiscard]] bool CheckLimits() {
+    constexpr static std::int64_t kPollEveryN = 1 << 11;
+
+    if (aborted_) {
+      return true;
+    }
+    const std::int64_t nodes = stats_.GetNodes();
+    if (nodes >= max_nodes_) {
+      aborted_ = true;
+    } else if (nodes % kPollEveryN == 0) {
+      aborted_ = (control_ && control_->IsStopped()) ||
+                 (!IsPondering() && deadline_ &&
+                  std::chrono::steady_clock::now() >= *deadline_);
+    }
+    return aborted_;
+  }
+
+  // Returns true while the search ponders. When pondering ends, the clock
+  // starts.
+  [[nodiscard]] bool IsPondering() {
+    if (pondering_ && !control_->IsPondering()) {
+      pondering_ = false;
+      StartClock(std::chrono::steady_clock::now());
+    }
+    return pondering_;
+  }
+
+  void StartClock(std::chrono::steady_clock::time_point start) {
+    if (move_time_) {
+      deadline_ = start + *move_time_;
+      soft_deadline_ = start + *move_time_ / 2;
+    }
+  }
+
+  [[nodiscard]] bool IsExcludedRootMove(Move move) const {
+    return std::ranges::find(excluded_root_moves_, move) !=
+           excluded_root_moves_.end();
+  }
+
+  [[nodiscard]] int CountLegalMoves() {
+    MoveList moves;
+    GenerateMoves(position_, moves);
+    int count = 0;
+    for (Move move : moves) {
+      ScopedSearchMove scoped_move(move, game_, nnue_evaluator_);
+      count += IsLastMoveLegal();
+    }
+    return count;
+  }
+
+  [[nodiscard]] Move GetFirstLegalMove() {
+    MoveList moves;
+    GenerateMoves(position_, moves);
+    for (Move move : moves) {
+      ScopedSearchMove scoped_move(move, game_, nnue_evaluator_);
+      if (IsLastMoveLegal()) {
+        return move;
+      }
+    }
+    LOG(FATAL) << "The position has no legal moves.";
+  }
+
+  [[nodiscard]] std::chrono::milliseconds GetElapsed() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_time_);
+  }
+
+  // Makes `move` followed by the principal variation of the child node the
+  // principal variation at `ply`.
+  void UpdatePrincipalVariation(Move move, int ply) {
+    pv_[ply][0] = move;
+    const int child_length = pv_length_[ply + 1];
+    std::copy_n(pv_[ply + 1].begin(), child_length, pv_[ply].begin() + 1);
+    pv_length_[ply] = child_length + 1;
+  }
+
+  [[nodiscard]] int GetScore() {
+    const int score = GetStaticEvaluation();
     return position_.SideToMove() == kWhite ? score : -score;
   }
 
+  // Returns the static evaluation from white's perspective.
+  [[nodiscard]] int GetStaticEvaluation() {
+    const std::uint64_t key = position_.GetKey();
+    if (std::optional<int> score = eval_cache_.Probe(key)) {
+      return *score;
+    }
+
+    const int score = nnue_evaluator_ ? nnue_evaluator_->Evaluate(position_)
+                                      : Evaluate(position_, pawn_table_);
+    eval_cache_.Store(key, score);
+    return score;
+  }
+
   [[nodiscard]] constexpr bool IsLastMoveLegal() const {
     return !position_.GetCheckers(~position_.SideToMove());
   }
@@ -158,41 +522,169 @@ class AlphaBetaSearcher {
 
   constexpr void MaybeLog(const int depth,
                           const int additional_depth = 0) const {
-    if (nodes_ % log_every_n_ != 0) {
+    const std::int64_t nodes = stats_.GetNodes();
+    if (nodes % log_every_n_ != 0) {
       return;
     }
 
-    const auto now = std::chrono::system_clock::now();
+    const auto now = std::chrono::steady_clock::now();
     const std::chrono::duration<double> elapsed = now - start_time_;
     const double elapsed_seconds = elapsed.count();
-    auto nodes_per_second = static_cast<std::int64_t>(nodes_ / elapsed_seconds);
+    auto nodes_per_second = static_cast<std::int64_t>(nodes / elapsed_seconds);
 
     const int selective_depth = depth + additional_depth;
 
     std::println(
-        std::cout, "info depth {} seldepth {} nodes {} nps {} tbhits {}", depth,
-        selective_depth, nodes_, nodes_per_second, transpositions_.GetHits());
+        std::cout, "info depth {} seldepth {} nodes {} nps {} hashfull {}",
+        depth, selective_depth, nodes, nodes_per_second,
+        transpositions_.GetHashFull());
+  }
+
+  void LogIteration(int depth, const std::vector<SearchLine>& lines) const {
+    if (log_every_n_ == std::numeric_limits<std::int64_t>::max()) {
+      return;
+    }
+
+    const std::int64_t nodes = stats_.GetNodes();
+    const std::chrono::milliseconds elapsed = GetElapsed();
+    const std::int64_t nodes_per_second =
+        nodes * 1000 / std::max<std::int64_t>(1, elapsed.count());
+
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+      const SearchLine& line = lines[i];
+      std::string pv;
+      for (Move move : line.pv) {
+        std::format_to(std::back_inserter(pv), " {}", move);
+      }
+
+      std::println(std::cout,
+                   "info depth {} multipv {} score {} nodes {} nps {} "
+                   "hashfull {} time {} pv{}",
+                   depth, i + 1, FormatUciScore(line.score), nodes,
+                   nodes_per_second, transpositions_.GetHashFull(),
+                   elapsed.count(), pv);
+    }
   }
 
-  Game game_;
+  Game& game_;
   const Position& position_;
 
-  const int requested_search_depth_;
+  const int max_depth_;
+  const std::int64_t max_nodes_;
+  const std::optional<std::chrono::milliseconds> move_time_;
+  const SearchControl* control_;
+  const int mate_;
+  const int multi_pv_;
   const std::int64_t log_every_n_;
+  const bool dump_stats_;
+  const std::function<void(const SearchResult&)>& on_iteration_;
 
+  // The depth of the current iteration.
+  int search_depth_ = 0;
+  bool aborted_ = false;
+
+  // The best move found by the current iteration so far.
   std::optional<Move> best_move_;
 
-  std::chrono::system_clock::time_point start_time_;
-  std::int64_t nodes_;
+  // The best move of the previous iteration, which is searched first.
+  std::optional<Move> previous_best_move_;
+
+  // The root moves of the lines already found by this iteration.
+  std::vector<Move> excluded_root_moves_;
 
-  TranspositionTable transpositions_;
+  // The lines of the current iteration and of the last completed one.
+  std::vector<SearchLine> lines_;
+  std::vector<SearchLine> completed_lines_;
+
+  // A triangular table of principal variations: pv_[ply] holds the principal
+  // variation of the node being searched at `ply`.
+  std::array<std::array<Move, SearchStats::kMaxPly>, SearchStats::kMaxPly>
+      pv_;
+  std::array<int, SearchStats::kMaxPly> pv_length_{};
+
+  std::chrono::steady_clock::time_point start_time_;
+  SearchStats stats_;
+
+  // Whether the search ponders, in which case the clock has not started yet.
+  bool pondering_ = false;
+
+  // The times after which no new iteration is started and after which the
+  // search is aborted, if the move time is limited.
+  std::optional<std::chrono::steady_clock::time_point> soft_deadline_;
+  std::optional<std::chrono::steady_clock::time_point> deadline_;
+
+  TranspositionTable& transpositions_;
+  PawnTable& pawn_table_;
+  EvalCache& eval_cache_;
+  nnue::Evaluator* nnue_evaluator_;
 };
 
 }  // namespace
 
-Move Search(const Game& game, const SearchOptions& options) {
-  AlphaBetaSearcher searcher(game, options);
-  return searcher.GetBestMove();
+std::optional<int> GetMateDistance(int score) {
+  if (score > kMateThreshold) {
+    // The number of plies to mate is odd when the side to move mates.
+    return (kCheckMateScore - score + 1) / 2;
+  }
+  if (score < -kMateThreshold) {
+    return -(kCheckMateScore + score) / 2;
+  }
+  return std::nullopt;
+}
+
+std::string FormatUciScore(int score) {
+  if (std::optional<int> mate_distance = GetMateDistance(score)) {
+    return std::format("mate {}", *mate_distance);
+  }
+  return std::format("cp {}", score);
+}
+
+Searcher::Searcher(std::size_t hash_size_mb)
+    : hash_size_mb_(hash_size_mb), transpositions_(hash_size_mb) {}
+
+SearchResult Searcher::Search(const Game& game, const SearchOptions& options) {
+  // Assigning to the member reuses the memory of its move history.
+  game_ = game;
+  // The quiescence search can go past the maximum ply of the main search.
+  game_.Reserve(game.GetNumMoves() + 2 * SearchStats::kMaxPly);
+  transpositions_.ResetCounters();
+
+  if (options.network != network_) {
+    eval_cache_.Clear();
+    nnue_evaluator_.reset();
+    network_ = options.network;
+  }
+  if (network_) {
+    if (!nnue_evaluator_) {
+      nnue_evaluator_.emplace(*network_);
+    }
+    nnue_evaluator_->Reset(game_.GetPosition());
+  }
+
+  AlphaBetaSearcher searcher(game_, options, transpositions_, pawn_table_,
+                             eval_cache_,
+                             nnue_evaluator_ ? &*nnue_evaluator_ : nullptr);
+  return searcher.Run();
+}
+
+void Searcher::SetHashSizeMb(std::size_t hash_size_mb) {
+  if (hash_size_mb != hash_size_mb_) {
+    transpositions_.Resize(hash_size_mb);
+    hash_size_mb_ = hash_size_mb;
+  }
+}
+
+void Searcher::Clear() {
+  transpositions_.Clear();
+  pawn_table_.Clear();
+  eval_cache_.Clear();
+  nnue_evaluator_.reset();
+  network_ = nullptr;
+}
+
+SearchResult Search(const Game& game, const SearchOptions& options) {
+  Searcher searcher(options.hash_size_mb);
+  return searcher.Search(game, options);
 }
 
 }  // namespace follychess
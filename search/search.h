@@ -1,29 +1,265 @@
 #ifndef FOLLYCHESS_SEARCH_SEARCH_H_
 #define FOLLYCHESS_SEARCH_SEARCH_H_
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "engine/game.h"
 #include "engine/move.h"
 #include "engine/position.h"
+#include "search/eval_cache.h"
+#include "search/nnue.h"
+#include "search/pawn_structure.h"
+#include "search/search_stats.h"
+#include "search/transposition.h"
 
 namespace follychess {
 
+// The score of being checkmated at the root. Checkmates further from the root
+// score closer to zero by one point per ply.
+inline constexpr int kCheckMateScore = 20'000;
+
+// The deepest search that can be requested.
+inline constexpr int kMaxSearchDepth = 64;
+
+// Returns the number of moves (not plies) until checkmate if `score` is a mate
+// score: positive if the side to move delivers the mate, and negative if it is
+// mated.
+[[nodiscard]] std::optional<int> GetMateDistance(int score);
+
+// Formats `score` for the UCI `info` command, e.g., as "cp 35" or "mate -2".
+[[nodiscard]] std::string FormatUciScore(int score);
+
+// Controls a running search from another thread. The search polls the control
+// every few thousand nodes.
+class SearchControl {
+ public:
+  // Prepares the control for a new search. While `ponder` is true, the search
+  // ignores its time limit.
+  void Reset(bool ponder) {
+    stopped_ = false;
+    pondering_ = ponder;
+  }
+
+  // Ends the search as soon as possible. The search returns the result of its
+  // last completed iteration.
+  void Stop() {
+    stopped_ = true;
+    EndPondering();
+  }
+
+  // Turns a pondering search into a regular one: its time limit starts
+  // counting down now, and the search continues from where it is.
+  void PonderHit() { EndPondering(); }
+
+  [[nodiscard]] bool IsStopped() const {
+    return stopped_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] bool IsPondering() const {
+    return pondering_.load(std::memory_order_relaxed);
+  }
+
+  // Blocks until the search stops pondering. A pondering search must not
+  // report its best move before then, even if it completes.
+  void WaitWhilePondering() const { pondering_.wait(true); }
+
+ private:
+  void EndPondering() {
+    pondering_ = false;
+    pondering_.notify_all();
+  }
+
+  std::atomic<bool> stopped_ = false;
+  std::atomic<bool> pondering_ = false;
+};
+
+struct SearchResult;
+
 struct SearchOptions {
   SearchOptions& SetDepth(int depth) {
     this->depth = depth;
     return *this;
   }
 
+  // The maximum depth. The search deepens iteratively up to this depth.
   int depth = 5;
 
+  SearchOptions& SetNodes(std::int64_t nodes) {
+    this->nodes = nodes;
+    return *this;
+  }
+
+  // The maximum number of nodes to search. If the limit is reached, the result
+  // of the last completed iteration is returned.
+  std::int64_t nodes = std::numeric_limits<std::int64_t>::max();
+
+  SearchOptions& SetMoveTime(std::chrono::milliseconds move_time) {
+    this->move_time = move_time;
+    return *this;
+  }
+
+  // The time to spend on the search, if limited. No new iteration is started
+  // after half of the time has passed, and the search is aborted once all of
+  // it has passed. The result of the last completed iteration is returned.
+  std::optional<std::chrono::milliseconds> move_time;
+
+  SearchOptions& SetControl(const SearchControl* control) {
+    this->control = control;
+    return *this;
+  }
+
+  // If set, the search can be stopped, or its pondering ended, from another
+  // thread. The move time only starts counting down once the search stops
+  // pondering.
+  const SearchControl* control = nullptr;
+
+  SearchOptions& SetMate(int mate) {
+    this->mate = mate;
+    return *this;
+  }
+
+  // If positive, the search stops as soon as it proves a mate in at most this
+  // many moves.
+  int mate = 0;
+
+  SearchOptions& SetMultiPv(int multi_pv) {
+    this->multi_pv = multi_pv;
+    return *this;
+  }
+
+  // The number of best lines to search for. Each line starts with a different
+  // root move.
+  int multi_pv = 1;
+
   SearchOptions& SetLogEveryN(std::int64_t log_every_n) {
     this->log_every_n = log_every_n;
     return *this;
   }
 
+  // If set to less than the maximum, an `info` line is also printed after
+  // every completed iteration.
   std::int64_t log_every_n = std::numeric_limits<std::int64_t>::max();
+
+  SearchOptions& SetNetwork(const nnue::Network* network) {
+    this->network = network;
+    return *this;
+  }
+
+  // The network used to evaluate positions. If null, the handcrafted
+  // evaluation is used instead.
+  const nnue::Network* network = nullptr;
+
+  SearchOptions& SetHashSizeMb(std::size_t hash_size_mb) {
+    this->hash_size_mb = hash_size_mb;
+    return *this;
+  }
+
+  // The size of the transposition table in megabytes. This is only used by the
+  // free Search() function; a Searcher's table is sized by the Searcher.
+  std::size_t hash_size_mb = TranspositionTable::kDefaultSizeMb;
+
+  SearchOptions& SetDumpStats(bool dump_stats) {
+    this->dump_stats = dump_stats;
+    return *this;
+  }
+
+  // If set, the search statistics are printed as `info string` lines when the
+  // search completes.
+  bool dump_stats = false;
+
+  SearchOptions& SetOnIteration(
+      std::function<void(const SearchResult&)> on_iteration) {
+    this->on_iteration = std::move(on_iteration);
+    return *this;
+  }
+
+  // If set, called with the result so far after every completed iteration,
+  // e.g., to track when the best move last changed. The result's `lines` are
+  // only set once the search completes.
+  std::function<void(const SearchResult&)> on_iteration;
+};
+
+struct SearchLine {
+  // The score in centipawns, from the perspective of the side to move.
+  int score = 0;
+
+  // The principal variation. It may be cut short by transposition table hits.
+  std::vector<Move> pv;
+};
+
+struct SearchResult {
+  // The best move, or a null move if the side to move has no legal moves.
+  Move best_move;
+
+  // The score of the best move in centipawns, from the perspective of the side
+  // to move.
+  int score = 0;
+
+  // The principal variation, starting with the best move. It may be cut short
+  // by transposition table hits.
+  std::vector<Move> pv;
+
+  // The best lines, from best to worst, as requested by
+  // SearchOptions::multi_pv. The first line is the principal variation above.
+  std::vector<SearchLine> lines;
+
+  // The depth of the last completed iteration.
+  int depth = 0;
+
+  std::chrono::milliseconds elapsed{0};
+
+  SearchStats stats;
+};
+
+// A searcher that is meant to be reused across many searches. It keeps its
+// transposition table, pawn table, evaluation cache and NNUE accumulators
+// allocated between searches, and entries from earlier searches are reused by
+// later ones.
+class Searcher {
+ public:
+  explicit Searcher(
+      std::size_t hash_size_mb = TranspositionTable::kDefaultSizeMb);
+
+  SearchResult Search(const Game& game,
+                      const SearchOptions& options = SearchOptions());
+
+  // Resizes the transposition table if `hash_size_mb` differs from its current
+  // size. Resizing clears the table.
+  void SetHashSizeMb(std::size_t hash_size_mb);
+
+  // Clears all tables, so that the next search does not depend on the earlier
+  // ones. This must also be called before the network of an earlier search is
+  // destroyed: networks are told apart by their address, which a new network
+  // may reuse.
+  void Clear();
+
+ private:
+  Game game_;
+  std::size_t hash_size_mb_;
+
+  TranspositionTable transpositions_;
+  PawnTable pawn_table_;
+  EvalCache eval_cache_;
+
+  // The network that the evaluation cache and the NNUE evaluator were filled
+  // with, or null if they were filled by the handcrafted evaluation or are
+  // empty.
+  const nnue::Network* network_ = nullptr;
+  std::optional<nnue::Evaluator> nnue_evaluator_;
 };
 
-Move Search(const Game& game, const SearchOptions& options = SearchOptions());
+// Runs a single search with a new Searcher.
+SearchResult Search(const Game& game,
+                    const SearchOptions& options = SearchOptions());
 
 }  // namespace follychess
 
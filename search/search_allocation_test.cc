@@ -0,0 +1,106 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "engine/game.h"
+#include "engine/position.h"
+#include "search/search.h"
+
+namespace {
+
+std::atomic<bool> counting = false;
+std::atomic<std::int64_t> allocations = 0;
+
+}  // namespace
+
+// Counts the allocations of the whole binary while `counting` is set. The
+// array and non-throwing forms forward to these by default.
+void *operator new(std::size_t size) {
+  if (counting.load(std::memory_order_relaxed)) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+// Over-aligned types, such as cache line aligned tables, use this form.
+void *operator new(std::size_t size, std::align_val_t alignment) {
+  if (counting.load(std::memory_order_relaxed)) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+  }
+  // The size must be a multiple of the alignment.
+  const auto align = static_cast<std::size_t>(alignment);
+  const std::size_t aligned_size =
+      (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+  if (void *ptr = std::aligned_alloc(align, aligned_size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::align_val_t) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+namespace follychess {
+namespace {
+
+using ::testing::Eq;
+using ::testing::Gt;
+
+// Returns the number of allocations that a search of `game` to `depth`
+// makes.
+std::int64_t CountAllocations(Searcher &searcher, const Game &game,
+                              int depth) {
+  allocations = 0;
+  counting = true;
+  const SearchResult result =
+      searcher.Search(game, SearchOptions().SetDepth(depth));
+  counting = false;
+  EXPECT_THAT(result.depth, Eq(depth));
+  return allocations;
+}
+
+TEST(Game, ConstructionDoesNotAllocate) {
+  const Position position = Position::Starting();
+  allocations = 0;
+  counting = true;
+  const Game game(position);
+  counting = false;
+  EXPECT_THAT(allocations, Eq(0));
+  EXPECT_THAT(game.GetNumMoves(), Eq(0));
+}
+
+TEST(Search, NodesDoNotAllocate) {
+  const Game game(
+      Position::FromFen(
+          "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4")
+          .value());
+  Searcher searcher;
+
+  // The first search sets up the searcher's history. Every search then
+  // allocates its result, and nothing else: a deep search makes as many
+  // allocations as a search of a single ply.
+  CountAllocations(searcher, game, 6);
+  const std::int64_t setup = CountAllocations(searcher, game, 1);
+  EXPECT_THAT(setup, Gt(0));
+  searcher.Clear();
+  EXPECT_THAT(CountAllocations(searcher, game, 6) - setup, Eq(0));
+}
+
+}  // namespace
+}  // namespace follychess
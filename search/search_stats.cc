@@ -0,0 +1,36 @@
+#include "search/search_stats.h"
+
+namespace follychess {
+
+int SearchStats::GetMaxPly() const {
+  int max_ply = kMaxPly;
+  while (max_ply > 0 && nodes_per_ply[max_ply - 1] == 0) {
+    --max_ply;
+  }
+  return max_ply;
+}
+
+int SearchStats::GetMaxDepth() const {
+  int max_depth = kMaxPly - 1;
+  while (max_depth > 0 && nodes_per_iteration[max_depth] == 0) {
+    --max_depth;
+  }
+  return max_depth;
+}
+
+double SearchStats::GetBranchingFactor(int depth) const {
+  if (depth <= 1 || depth >= kMaxPly || nodes_per_iteration[depth - 1] == 0) {
+    return 0.0;
+  }
+  return static_cast<double>(nodes_per_iteration[depth]) /
+         nodes_per_iteration[depth - 1];
+}
+
+double SearchStats::GetFirstMoveCutoffRate() const {
+  if (beta_cutoffs == 0) {
+    return 0.0;
+  }
+  return 100.0 * first_move_cutoffs / beta_cutoffs;
+}
+
+}  // namespace follychess
@@ -0,0 +1,100 @@
+#ifndef FOLLYCHESS_SEARCH_SEARCH_STATS_H_
+#define FOLLYCHESS_SEARCH_SEARCH_STATS_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <format>
+#include <string>
+
+namespace follychess {
+
+// Counters collected during a single search. Each searcher owns its own
+// instance, so the counters are plain integers that are never shared between
+// threads.
+struct SearchStats {
+  static constexpr int kMaxPly = 128;
+
+  constexpr void CountNode(int ply) {
+    ++nodes_per_ply[std::min(ply, kMaxPly - 1)];
+  }
+
+  [[nodiscard]] constexpr std::int64_t GetNodes() const {
+    return main_nodes + quiescent_nodes;
+  }
+
+  // Records that the iteration at `depth` completed after searching `nodes`
+  // nodes of its own.
+  constexpr void CompleteIteration(int depth, std::int64_t nodes) {
+    nodes_per_iteration[std::min(depth, kMaxPly - 1)] = nodes;
+  }
+
+  // Returns the number of plies with at least one node.
+  [[nodiscard]] int GetMaxPly() const;
+
+  // Returns the depth of the last completed iteration.
+  [[nodiscard]] int GetMaxDepth() const;
+
+  // Returns the effective branching factor of the iteration at `depth`, i.e.,
+  // the ratio of its nodes to the nodes of the iteration at `depth - 1`.
+  [[nodiscard]] double GetBranchingFactor(int depth) const;
+
+  // Returns the percentage of beta cutoffs that were caused by the first move
+  // searched.
+  [[nodiscard]] double GetFirstMoveCutoffRate() const;
+
+  std::array<std::int64_t, kMaxPly> nodes_per_ply{};
+
+  // The nodes searched by each completed iteration, indexed by its depth.
+  std::array<std::int64_t, kMaxPly> nodes_per_iteration{};
+
+  std::int64_t main_nodes = 0;
+  std::int64_t quiescent_nodes = 0;
+
+  std::int64_t beta_cutoffs = 0;
+  std::int64_t first_move_cutoffs = 0;
+
+  std::int64_t tt_probes = 0;
+  std::int64_t tt_hits = 0;
+  std::int64_t tt_collisions = 0;
+  std::int64_t tt_overwrites = 0;
+
+  // The per mille of the transposition table that is in use.
+  int hashfull = 0;
+};
+
+}  // namespace follychess
+
+// Formats the statistics as UCI `info string` lines, one per group of
+// counters.
+template <>
+struct std::formatter<follychess::SearchStats> : std::formatter<std::string> {
+  auto format(const follychess::SearchStats &stats,
+              std::format_context &context) const {
+    auto out = std::format_to(
+        context.out(), "info string nodes {} main {} qsearch {}\n",
+        stats.GetNodes(), stats.main_nodes, stats.quiescent_nodes);
+
+    for (int ply = 0; ply < stats.GetMaxPly(); ++ply) {
+      out = std::format_to(out, "info string ply {} nodes {}\n", ply,
+                           stats.nodes_per_ply[ply]);
+    }
+    for (int depth = 1; depth <= stats.GetMaxDepth(); ++depth) {
+      out = std::format_to(out, "info string depth {} nodes {} ebf {:.2f}\n",
+                           depth, stats.nodes_per_iteration[depth],
+                           stats.GetBranchingFactor(depth));
+    }
+
+    out = std::format_to(out,
+                         "info string cutoffs {} firstmove {:.1f}%\n",
+                         stats.beta_cutoffs, stats.GetFirstMoveCutoffRate());
+    return std::format_to(
+        out,
+        "info string tt probes {} hits {} collisions {} overwrites {} "
+        "hashfull {}",
+        stats.tt_probes, stats.tt_hits, stats.tt_collisions,
+        stats.tt_overwrites, stats.hashfull);
+  }
+};
+
+#endif  // FOLLYCHESS_SEARCH_SEARCH_STATS_H_
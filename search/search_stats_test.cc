@@ -0,0 +1,80 @@
+#include "search/search_stats.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <format>
+
+namespace follychess {
+namespace {
+
+using ::testing::DoubleEq;
+using ::testing::Eq;
+using ::testing::HasSubstr;
+
+TEST(SearchStats, CountNode) {
+  SearchStats stats;
+  stats.CountNode(0);
+  stats.CountNode(1);
+  stats.CountNode(1);
+  stats.CountNode(SearchStats::kMaxPly + 10);
+
+  EXPECT_THAT(stats.nodes_per_ply[0], Eq(1));
+  EXPECT_THAT(stats.nodes_per_ply[1], Eq(2));
+  EXPECT_THAT(stats.nodes_per_ply[SearchStats::kMaxPly - 1], Eq(1));
+  EXPECT_THAT(stats.GetMaxPly(), Eq(SearchStats::kMaxPly));
+}
+
+TEST(SearchStats, BranchingFactor) {
+  SearchStats stats;
+  EXPECT_THAT(stats.GetMaxDepth(), Eq(0));
+
+  stats.CompleteIteration(1, 21);
+  stats.CompleteIteration(2, 84);
+  stats.CompleteIteration(3, 420);
+
+  EXPECT_THAT(stats.GetMaxDepth(), Eq(3));
+  EXPECT_THAT(stats.GetBranchingFactor(1), DoubleEq(0.0));
+  EXPECT_THAT(stats.GetBranchingFactor(2), DoubleEq(4.0));
+  EXPECT_THAT(stats.GetBranchingFactor(3), DoubleEq(5.0));
+  EXPECT_THAT(stats.GetBranchingFactor(4), DoubleEq(0.0));
+}
+
+TEST(SearchStats, FirstMoveCutoffRate) {
+  SearchStats stats;
+  EXPECT_THAT(stats.GetFirstMoveCutoffRate(), DoubleEq(0.0));
+
+  stats.beta_cutoffs = 8;
+  stats.first_move_cutoffs = 6;
+  EXPECT_THAT(stats.GetFirstMoveCutoffRate(), DoubleEq(75.0));
+}
+
+TEST(SearchStats, Format) {
+  SearchStats stats;
+  stats.main_nodes = 21;
+  stats.quiescent_nodes = 4;
+  stats.nodes_per_ply[0] = 1;
+  stats.nodes_per_ply[1] = 20;
+  stats.nodes_per_ply[2] = 4;
+  stats.CompleteIteration(1, 21);
+  stats.CompleteIteration(2, 42);
+  stats.beta_cutoffs = 4;
+  stats.first_move_cutoffs = 3;
+  stats.tt_probes = 21;
+  stats.tt_hits = 2;
+  stats.hashfull = 5;
+
+  EXPECT_THAT(std::format("{}", stats),
+              Eq("info string nodes 25 main 21 qsearch 4\n"
+                 "info string ply 0 nodes 1\n"
+                 "info string ply 1 nodes 20\n"
+                 "info string ply 2 nodes 4\n"
+                 "info string depth 1 nodes 21 ebf 0.00\n"
+                 "info string depth 2 nodes 42 ebf 2.00\n"
+                 "info string cutoffs 4 firstmove 75.0%\n"
+                 "info string tt probes 21 hits 2 collisions 0 overwrites 0 "
+                 "hashfull 5"));
+}
+
+}  // namespace
+}  // namespace follychess
@@ -3,16 +3,34 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <future>
+#include <memory>
+#include <set>
+
+#include "absl/log/check.h"
 #include "engine/move.h"
 #include "engine/move_generator.h"
 #include "engine/position.h"
 #include "engine/scoped_move.h"
 #include "engine/testing.h"
+#include "search/nnue.h"
 
 namespace follychess {
 namespace {
 
+using ::testing::AllOf;
+using ::testing::Contains;
 using ::testing::ElementsAreArray;
+using ::testing::Eq;
+using ::testing::Ge;
+using ::testing::Gt;
+using ::testing::IsEmpty;
+using ::testing::Le;
+using ::testing::Lt;
+using ::testing::Not;
+using ::testing::Optional;
+using ::testing::SizeIs;
 
 constexpr int kMaxMovesAllowed = 10;
 
@@ -31,7 +49,7 @@ std::vector<Move> Play(Game& game) {
   std::vector<Move> moves;
 
   while (!GameOver(game.GetPosition())) {
-    Move move = Search(game, SearchOptions().SetDepth(6));
+    Move move = Search(game, SearchOptions().SetDepth(6)).best_move;
     game.Do(move);
     moves.push_back(move);
 
@@ -80,5 +98,301 @@ TEST(Search, SimpleEndGames) {
   }
 }
 
+TEST(Search, Stats) {
+  Game game(Position::Starting());
+  const SearchStats stats = Search(game, SearchOptions().SetDepth(3)).stats;
+
+  // The search deepens iteratively, so the root is visited once per iteration.
+  EXPECT_THAT(stats.nodes_per_ply[0], Eq(3));
+  EXPECT_THAT(stats.nodes_per_ply[1], Ge(20));
+
+  std::int64_t nodes = 0;
+  for (std::int64_t ply_nodes : stats.nodes_per_ply) {
+    nodes += ply_nodes;
+  }
+  EXPECT_THAT(nodes, Eq(stats.GetNodes()));
+  EXPECT_THAT(stats.quiescent_nodes, Gt(0));
+
+  // Every iteration completed, so together they searched all of the nodes.
+  EXPECT_THAT(stats.GetMaxDepth(), Eq(3));
+  std::int64_t iteration_nodes = 0;
+  for (int depth = 1; depth <= 3; ++depth) {
+    EXPECT_THAT(stats.nodes_per_iteration[depth], Gt(0));
+    iteration_nodes += stats.nodes_per_iteration[depth];
+  }
+  EXPECT_THAT(iteration_nodes, Eq(stats.GetNodes()));
+  EXPECT_THAT(stats.nodes_per_iteration[1], Eq(21));
+  EXPECT_THAT(stats.GetBranchingFactor(2),
+              Eq(static_cast<double>(stats.nodes_per_iteration[2]) / 21));
+
+  EXPECT_THAT(stats.beta_cutoffs, Gt(0));
+  EXPECT_THAT(stats.first_move_cutoffs, Le(stats.beta_cutoffs));
+
+  EXPECT_THAT(stats.tt_probes, Eq(stats.main_nodes));
+  EXPECT_THAT(stats.tt_hits, Le(stats.tt_probes));
+  EXPECT_THAT(stats.hashfull, AllOf(Ge(0), Le(1000)));
+}
+
+TEST(Search, PrincipalVariation) {
+  Game game(Position::Starting());
+  const SearchResult result = Search(game, SearchOptions().SetDepth(4));
+
+  ASSERT_THAT(result.pv, Not(IsEmpty()));
+  EXPECT_THAT(result.pv.front(), Eq(result.best_move));
+  EXPECT_THAT(result.pv, SizeIs(Le(4)));
+  EXPECT_THAT(result.depth, Eq(4));
+
+  // Every move of the principal variation must be legal in turn.
+  for (Move move : result.pv) {
+    const std::vector<Move> moves = GenerateMoves(game.GetPosition());
+    ASSERT_THAT(moves, Contains(move));
+    game.Do(move);
+    ASSERT_FALSE(game.GetPosition().GetCheckers(
+        ~game.GetPosition().SideToMove()));
+  }
+}
+
+TEST(Search, OnIteration) {
+  Game game(Position::Starting());
+  std::vector<int> depths;
+  std::int64_t last_nodes = 0;
+  const SearchResult result = Search(
+      game, SearchOptions().SetDepth(4).SetOnIteration(
+                [&](const SearchResult& iteration) {
+                  depths.push_back(iteration.depth);
+                  EXPECT_THAT(iteration.pv.front(), Eq(iteration.best_move));
+                  EXPECT_THAT(iteration.stats.GetNodes(), Gt(last_nodes));
+                  last_nodes = iteration.stats.GetNodes();
+                }));
+
+  EXPECT_THAT(depths, ElementsAreArray({1, 2, 3, 4}));
+  EXPECT_THAT(last_nodes, Eq(result.stats.GetNodes()));
+}
+
+TEST(Search, NodeLimit) {
+  const Game game(Position::Starting());
+  const SearchResult result =
+      Search(game, SearchOptions().SetDepth(kMaxSearchDepth).SetNodes(10'000));
+
+  EXPECT_THAT(result.stats.GetNodes(), Le(10'000));
+  EXPECT_THAT(result.depth, AllOf(Gt(0), Lt(kMaxSearchDepth)));
+  EXPECT_THAT(result.pv.front(), Eq(result.best_move));
+
+  // The node count is deterministic, so the limit gives reproducible results.
+  const SearchResult repeated =
+      Search(game, SearchOptions().SetDepth(kMaxSearchDepth).SetNodes(10'000));
+  EXPECT_THAT(repeated.best_move, Eq(result.best_move));
+  EXPECT_THAT(repeated.stats.GetNodes(), Eq(result.stats.GetNodes()));
+}
+
+TEST(Search, NoLegalMoves) {
+  const Game checkmated(
+      Position::FromFen("R5k1/5ppp/8/8/8/8/8/6K1 b - - 1 1").value());
+  const SearchResult result =
+      Search(checkmated, SearchOptions().SetDepth(3).SetMultiPv(2));
+  EXPECT_THAT(result.best_move, Eq(Move()));
+  EXPECT_THAT(result.score, Eq(-kCheckMateScore));
+  EXPECT_THAT(result.pv, IsEmpty());
+  EXPECT_THAT(result.lines, IsEmpty());
+
+  const Game stalemated(
+      Position::FromFen("k7/8/1Q6/8/8/8/8/6K1 b - - 0 1").value());
+  EXPECT_THAT(Search(stalemated).best_move, Eq(Move()));
+  EXPECT_THAT(Search(stalemated).score, Eq(0));
+}
+
+TEST(Search, TinyNodeLimitStillReturnsMove) {
+  const Game game(Position::Starting());
+  const SearchResult result = Search(game, SearchOptions().SetNodes(1));
+
+  EXPECT_THAT(result.depth, Eq(0));
+  EXPECT_THAT(GenerateMoves(game.GetPosition()), Contains(result.best_move));
+}
+
+TEST(Searcher, AbortedSearchesDoNotStoreScores) {
+  // exd4 wins the queen, and the quiescence search of the recapture can be
+  // aborted.
+  const Game game(
+      Position::FromFen(
+          "rnb1kbnr/pppp1ppp/8/4p3/3q4/4P3/PPPP1PPP/RNBQKBNR w KQkq - 0 1")
+          .value());
+  const SearchOptions options = SearchOptions().SetDepth(1);
+  const SearchResult fresh = Search(game, options);
+
+  // Each search is aborted at a different node. The next search must not
+  // find the score of the aborted node in the transposition table.
+  for (std::int64_t nodes = 1; nodes <= 100; ++nodes) {
+    Searcher searcher(1);
+    searcher.Search(game,
+                    SearchOptions().SetDepth(kMaxSearchDepth).SetNodes(nodes));
+    const SearchResult result = searcher.Search(game, options);
+    EXPECT_THAT(result.best_move, Eq(fresh.best_move)) << nodes;
+    EXPECT_THAT(result.score, Eq(fresh.score)) << nodes;
+  }
+}
+
+TEST(Search, MoveTime) {
+  const Game game(Position::Starting());
+  const SearchResult result =
+      Search(game, SearchOptions()
+                       .SetDepth(kMaxSearchDepth)
+                       .SetMoveTime(std::chrono::milliseconds(100)));
+
+  EXPECT_THAT(result.depth, AllOf(Gt(0), Lt(kMaxSearchDepth)));
+  EXPECT_THAT(result.elapsed, Lt(std::chrono::seconds(2)));
+  EXPECT_THAT(result.pv.front(), Eq(result.best_move));
+}
+
+TEST(Search, StoppedSearchStillReturnsMove) {
+  SearchControl control;
+  control.Reset(/*ponder=*/false);
+  control.Stop();
+
+  const Game game(Position::Starting());
+  const SearchResult result =
+      Search(game, SearchOptions().SetDepth(kMaxSearchDepth).SetControl(
+                       &control));
+  EXPECT_THAT(GenerateMoves(game.GetPosition()), Contains(result.best_move));
+}
+
+TEST(Search, PonderHitStartsTheClock) {
+  SearchControl control;
+  control.Reset(/*ponder=*/true);
+
+  const Game game(Position::Starting());
+  std::future<SearchResult> result = std::async(std::launch::async, [&] {
+    return Search(game, SearchOptions()
+                            .SetDepth(kMaxSearchDepth)
+                            .SetMoveTime(std::chrono::milliseconds(50))
+                            .SetControl(&control));
+  });
+
+  // The move time does not apply while pondering.
+  EXPECT_THAT(result.wait_for(std::chrono::milliseconds(200)),
+              Eq(std::future_status::timeout));
+
+  control.PonderHit();
+  EXPECT_THAT(result.wait_for(std::chrono::seconds(2)),
+              Eq(std::future_status::ready));
+  EXPECT_THAT(result.get().depth, Gt(0));
+}
+
+TEST(Search, Mate) {
+  // 1. Ra8# is a back rank mate.
+  const Game game(
+      MakePosition("8: . . . . . . k ."
+                   "7: . . . . . p p p"
+                   "6: . . . . . . . ."
+                   "5: . . . . . . . ."
+                   "4: . . . . . . . ."
+                   "3: . . . . . . . ."
+                   "2: . . . . . . . ."
+                   "1: R . . . . . K ."
+                   "   a b c d e f g h"
+                   //
+                   "   w - - 0 1"));
+
+  const SearchResult result =
+      Search(game, SearchOptions().SetDepth(10).SetMate(1));
+  EXPECT_THAT(result.best_move, Eq(Move(A1, A8)));
+  EXPECT_THAT(GetMateDistance(result.score), Optional(1));
+
+  // The search stops as soon as the mate is proven.
+  EXPECT_THAT(result.depth, Eq(2));
+}
+
+TEST(GetMateDistance, Scores) {
+  EXPECT_THAT(GetMateDistance(0), Eq(std::nullopt));
+  EXPECT_THAT(GetMateDistance(150), Eq(std::nullopt));
+  EXPECT_THAT(GetMateDistance(kCheckMateScore - 1), Optional(1));
+  EXPECT_THAT(GetMateDistance(kCheckMateScore - 3), Optional(2));
+  EXPECT_THAT(GetMateDistance(-kCheckMateScore + 2), Optional(-1));
+  EXPECT_THAT(GetMateDistance(-kCheckMateScore + 4), Optional(-2));
+
+  EXPECT_THAT(FormatUciScore(35), Eq("cp 35"));
+  EXPECT_THAT(FormatUciScore(kCheckMateScore - 3), Eq("mate 2"));
+}
+
+TEST(Search, MultiPv) {
+  const Game game(Position::Starting());
+  const SearchResult single = Search(game, SearchOptions().SetDepth(3));
+  const SearchResult result =
+      Search(game, SearchOptions().SetDepth(3).SetMultiPv(3));
+
+  ASSERT_THAT(result.lines, SizeIs(3));
+  EXPECT_THAT(result.best_move, Eq(result.lines[0].pv.front()));
+  EXPECT_THAT(result.score, Eq(result.lines[0].score));
+  EXPECT_THAT(result.score, Eq(single.score));
+
+  std::set<Move> root_moves;
+  for (int i = 0; i < result.lines.size(); ++i) {
+    root_moves.insert(result.lines[i].pv.front());
+    if (i > 0) {
+      EXPECT_THAT(result.lines[i].score, Le(result.lines[i - 1].score));
+    }
+  }
+  EXPECT_THAT(root_moves, SizeIs(3));
+}
+
+TEST(Search, MultiPvIsLimitedByLegalMoves) {
+  // Only the king can move, to a7, b7 or b8.
+  const Game game(
+      MakePosition("8: K . . . . . . ."
+                   "7: . . . . . . . ."
+                   "6: . . . . . . . ."
+                   "5: . . . . . . . ."
+                   "4: . . . . . . . ."
+                   "3: . . . . . . . ."
+                   "2: . . . . . . . ."
+                   "1: . . . . . . . k"
+                   "   a b c d e f g h"
+                   //
+                   "   w - - 0 1"));
+  const SearchResult result =
+      Search(game, SearchOptions().SetDepth(2).SetMultiPv(5));
+  EXPECT_THAT(result.lines, SizeIs(3));
+}
+
+TEST(Searcher, ReusesTables) {
+  const Game game(Position::Starting());
+  const SearchOptions options = SearchOptions().SetDepth(4);
+  const SearchResult fresh = Search(game, options);
+
+  Searcher searcher;
+  const SearchResult first = searcher.Search(game, options);
+  EXPECT_THAT(first.best_move, Eq(fresh.best_move));
+  EXPECT_THAT(first.stats.GetNodes(), Eq(fresh.stats.GetNodes()));
+
+  // The second search is answered from the transposition table.
+  const SearchResult second = searcher.Search(game, options);
+  EXPECT_THAT(second.best_move, Eq(fresh.best_move));
+  EXPECT_THAT(second.stats.GetNodes(), Lt(first.stats.GetNodes()));
+
+  searcher.Clear();
+  EXPECT_THAT(searcher.Search(game, options).stats.GetNodes(),
+              Eq(fresh.stats.GetNodes()));
+}
+
+TEST(Searcher, ClearForgetsNetwork) {
+  const Game game(Position::Starting());
+  const std::unique_ptr<nnue::Network> network = nnue::Network::Random(1);
+  const SearchOptions options =
+      SearchOptions().SetDepth(3).SetNetwork(network.get());
+
+  Searcher searcher;
+  searcher.Search(game, options);
+
+  // A different network at the same address, as when a new network reuses the
+  // memory of a destroyed one.
+  *network = *nnue::Network::Random(2);
+  const SearchResult fresh = Search(game, options);
+
+  searcher.Clear();
+  const SearchResult result = searcher.Search(game, options);
+  EXPECT_THAT(result.best_move, Eq(fresh.best_move));
+  EXPECT_THAT(result.score, Eq(fresh.score));
+  EXPECT_THAT(result.stats.GetNodes(), Eq(fresh.stats.GetNodes()));
+}
+
 }  // namespace
 }  // namespace follychess
\ No newline at end of file
@@ -1,14 +1,22 @@
 #ifndef FOLLYCHESS_SEARCH_TRANSPOSITION_H_
 #define FOLLYCHESS_SEARCH_TRANSPOSITION_H_
 
-#include <array>
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
-
-#include "absl/container/flat_hash_map.h"
-#include "engine/position.h"
+#include <vector>
 
 namespace follychess {
 
+// A fixed-size transposition table keyed by position keys. The number of
+// entries is the largest power of two that fits in the requested size, so that
+// the entry for a position can be found by masking its key. Entries are always
+// replaced.
+//
+// Depths are the remaining search depths, so entries stay valid across
+// searches from different roots.
 class TranspositionTable {
  public:
   enum class BoundType : std::int8_t {
@@ -17,68 +25,145 @@ class TranspositionTable {
     LowerBound,
   };
 
-  explicit TranspositionTable(const Position& position)
-      : position_{position}, hits_{0} {}
+  static constexpr std::size_t kDefaultSizeMb = 16;
+
+  explicit TranspositionTable(std::size_t size_mb = kDefaultSizeMb)
+      : entries_(GetNumEntries(size_mb)),
+        mask_{entries_.size() - 1},
+        probes_{0},
+        hits_{0},
+        collisions_{0},
+        overwrites_{0} {}
 
-  [[nodiscard]] constexpr std::optional<int> Probe(int alpha, int beta,
+  [[nodiscard]] constexpr std::optional<int> Probe(std::uint64_t key,
+                                                   int alpha, int beta,
                                                    int depth);
 
-  constexpr void Record(int score, int depth, BoundType type);
+  constexpr void Record(std::uint64_t key, int score, int depth,
+                        BoundType type);
+
+  // Reallocates the table with the given size. All entries are cleared.
+  void Resize(std::size_t size_mb) {
+    entries_.assign(GetNumEntries(size_mb), Entry());
+    mask_ = entries_.size() - 1;
+  }
+
+  // Clears all entries while keeping the table allocated.
+  void Clear() { std::ranges::fill(entries_, Entry()); }
+
+  // Resets the probe, hit, collision and overwrite counters.
+  constexpr void ResetCounters() {
+    probes_ = 0;
+    hits_ = 0;
+    collisions_ = 0;
+    overwrites_ = 0;
+  }
 
+  [[nodiscard]] constexpr std::int64_t GetProbes() const { return probes_; }
+
+  // Returns the number of probes that found an entry for the position.
   [[nodiscard]] constexpr std::int64_t GetHits() const { return hits_; };
 
- private:
-  static constexpr auto KEntries = 1 << 24;
+  // Returns the number of probes that found an entry for a different position.
+  [[nodiscard]] constexpr std::int64_t GetCollisions() const {
+    return collisions_;
+  }
+
+  // Returns the number of records that replaced an entry for a different
+  // position.
+  [[nodiscard]] constexpr std::int64_t GetOverwrites() const {
+    return overwrites_;
+  }
+
+  // Returns the per mille of occupied entries, estimated from a sample of the
+  // table as in the UCI `hashfull` output.
+  [[nodiscard]] constexpr int GetHashFull() const {
+    const std::size_t sample = std::min<std::size_t>(1000, entries_.size());
+    std::size_t occupied = 0;
+    for (std::size_t i = 0; i < sample; ++i) {
+      occupied += entries_[i].valid;
+    }
+    return static_cast<int>(occupied * 1000 / sample);
+  }
+
+  [[nodiscard]] constexpr std::size_t GetSize() const {
+    return entries_.size();
+  }
 
+ private:
   struct Entry {
-    int depth{0};
-    int score{0};
+    std::uint64_t key{0};
+    std::int32_t score{0};
+    std::int16_t depth{0};
     BoundType type{BoundType::Exact};
+    bool valid{false};
   };
 
-  const Position& position_;
+  static_assert(sizeof(Entry) == 16);
+
+  [[nodiscard]] static constexpr std::size_t GetNumEntries(
+      std::size_t size_mb) {
+    return std::bit_floor(
+        std::max<std::size_t>(1, size_mb * 1024 * 1024 / sizeof(Entry)));
+  }
+
+  std::vector<Entry> entries_;
+  std::size_t mask_;
 
-  absl::flat_hash_map<std::uint64_t, Entry> table_;
+  std::int64_t probes_;
   std::int64_t hits_;
+  std::int64_t collisions_;
+  std::int64_t overwrites_;
 };
 
 [[nodiscard]] constexpr std::optional<int> TranspositionTable::Probe(
-    int alpha, int beta, int depth) {
-  auto it = table_.find(position_.GetKey());
-  if (it == table_.end()) {
+    std::uint64_t key, int alpha, int beta, int depth) {
+  ++probes_;
+
+  const Entry& entry = entries_[key & mask_];
+  if (!entry.valid) {
+    return std::nullopt;
+  }
+  if (entry.key != key) {
+    ++collisions_;
     return std::nullopt;
   }
+  ++hits_;
 
-  const Entry& entry = it->second;
   if (entry.depth < depth) {
     return std::nullopt;
   }
 
   switch (entry.type) {
     case BoundType::Exact:
-      ++hits_;
       return entry.score;
     case BoundType::UpperBound:
       if (entry.score <= alpha) {
-        ++hits_;
         return alpha;
       }
+      return std::nullopt;
     case BoundType::LowerBound:
       if (entry.score >= beta) {
-        ++hits_;
         return beta;
       }
+      return std::nullopt;
     default:
       return std::nullopt;
   }
 }
 
-constexpr void TranspositionTable::Record(int score, int depth,
-                                          BoundType type) {
-  table_[position_.GetKey()] = {
+constexpr void TranspositionTable::Record(std::uint64_t key, int score,
+                                          int depth, BoundType type) {
+  Entry& entry = entries_[key & mask_];
+  if (entry.valid && entry.key != key) {
+    ++overwrites_;
+  }
+  entry = {
+      .key = key,
       .score = score,
-      .depth = depth,
+      .depth = static_cast<std::int16_t>(depth),
       .type = type,
+      .valid = true,
   };
 }
 
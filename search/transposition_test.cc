@@ -0,0 +1,88 @@
+#include "search/transposition.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace follychess {
+namespace {
+
+using ::testing::Eq;
+using ::testing::Optional;
+
+using enum TranspositionTable::BoundType;
+
+TEST(TranspositionTable, Size) {
+  EXPECT_THAT(TranspositionTable(1).GetSize(), Eq(1 << 16));
+  EXPECT_THAT(TranspositionTable(3).GetSize(), Eq(1 << 17));
+  EXPECT_THAT(TranspositionTable(0).GetSize(), Eq(1));
+
+  TranspositionTable table(1);
+  table.Resize(2);
+  EXPECT_THAT(table.GetSize(), Eq(1 << 17));
+}
+
+TEST(TranspositionTable, ProbeAndRecord) {
+  TranspositionTable table(1);
+
+  EXPECT_THAT(table.Probe(1, -100, 100, 0), Eq(std::nullopt));
+  table.Record(1, 42, 0, Exact);
+  EXPECT_THAT(table.Probe(1, -100, 100, 0), Optional(42));
+  EXPECT_THAT(table.Probe(1, -100, 100, 1), Eq(std::nullopt));
+
+  table.Record(1, 200, 0, LowerBound);
+  EXPECT_THAT(table.Probe(1, -100, 100, 0), Optional(100));
+  EXPECT_THAT(table.Probe(1, -100, 300, 0), Eq(std::nullopt));
+
+  EXPECT_THAT(table.GetProbes(), Eq(5));
+  EXPECT_THAT(table.GetHits(), Eq(4));
+  EXPECT_THAT(table.GetCollisions(), Eq(0));
+  EXPECT_THAT(table.GetOverwrites(), Eq(0));
+}
+
+TEST(TranspositionTable, Bounds) {
+  TranspositionTable table(1);
+
+  table.Record(1, -200, 0, UpperBound);
+  EXPECT_THAT(table.Probe(1, -100, 100, 0), Optional(-100));
+  EXPECT_THAT(table.Probe(1, -300, -250, 0), Eq(std::nullopt));
+
+  table.Record(1, 200, 0, LowerBound);
+  EXPECT_THAT(table.Probe(1, -100, 100, 0), Optional(100));
+  EXPECT_THAT(table.Probe(1, 250, 300, 0), Eq(std::nullopt));
+}
+
+TEST(TranspositionTable, CollisionsAndOverwrites) {
+  // A table with a single entry, so that every key maps to it.
+  TranspositionTable table(0);
+  table.Record(1, 1, 0, Exact);
+
+  EXPECT_THAT(table.Probe(2, -100, 100, 0), Eq(std::nullopt));
+  EXPECT_THAT(table.GetCollisions(), Eq(1));
+
+  table.Record(2, 2, 0, Exact);
+  EXPECT_THAT(table.GetOverwrites(), Eq(1));
+  EXPECT_THAT(table.Probe(2, -100, 100, 0), Optional(2));
+
+  EXPECT_THAT(table.Probe(1, -100, 100, 0), Eq(std::nullopt));
+  EXPECT_THAT(table.GetCollisions(), Eq(2));
+  EXPECT_THAT(table.GetHits(), Eq(1));
+
+  table.ResetCounters();
+  EXPECT_THAT(table.GetProbes(), Eq(0));
+  EXPECT_THAT(table.GetCollisions(), Eq(0));
+}
+
+TEST(TranspositionTable, HashFull) {
+  TranspositionTable table(1);
+  EXPECT_THAT(table.GetHashFull(), Eq(0));
+
+  TranspositionTable single_entry_table(0);
+  single_entry_table.Record(1, 0, 0, Exact);
+  EXPECT_THAT(single_entry_table.GetHashFull(), Eq(1000));
+
+  single_entry_table.Clear();
+  EXPECT_THAT(single_entry_table.GetHashFull(), Eq(0));
+}
+
+}  // namespace
+}  // namespace follychess
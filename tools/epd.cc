@@ -0,0 +1,285 @@
+#include "tools/epd.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <iterator>
+#include <istream>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "engine/game.h"
+#include "engine/move.h"
+#include "engine/position.h"
+#include "engine/san.h"
+#include "search/search.h"
+
+namespace follychess {
+namespace {
+
+bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+// Removes and returns the next whitespace-separated token of `input`. A token
+// that starts with a quote runs until the closing quote, which is dropped.
+std::string_view NextToken(std::string_view &input) {
+  while (!input.empty() && IsSpace(input.front())) {
+    input.remove_prefix(1);
+  }
+
+  std::size_t end = 0;
+  std::string_view token;
+  if (input.starts_with('"')) {
+    end = std::min(input.find('"', 1), input.size());
+    token = input.substr(1, end - 1);
+    end = std::min(end + 1, input.size());
+  } else {
+    while (end < input.size() && !IsSpace(input[end])) {
+      ++end;
+    }
+    token = input.substr(0, end);
+  }
+  input.remove_prefix(end);
+  return token;
+}
+
+// Removes and returns the next operation of `input`, which ends at a semicolon
+// outside of quotes.
+std::string_view NextOperation(std::string_view &input) {
+  bool quoted = false;
+  std::size_t end = 0;
+  while (end < input.size() && (quoted || input[end] != ';')) {
+    quoted ^= input[end] == '"';
+    ++end;
+  }
+  const std::string_view operation = input.substr(0, end);
+  input.remove_prefix(std::min(end + 1, input.size()));
+  return operation;
+}
+
+std::expected<std::vector<Move>, std::string> ParseMoves(
+    const Position &position, std::string_view operands) {
+  std::vector<Move> moves;
+  for (std::string_view san = NextToken(operands); !san.empty();
+       san = NextToken(operands)) {
+    auto move = ParseSan(position, san);
+    if (!move) {
+      return std::unexpected(move.error());
+    }
+    moves.push_back(*move);
+  }
+  return moves;
+}
+
+bool IsSolution(const EpdRecord &record, Move move) {
+  if (std::ranges::find(record.avoid_moves, move) !=
+      record.avoid_moves.end()) {
+    return false;
+  }
+  return record.best_moves.empty() ||
+         std::ranges::find(record.best_moves, move) != record.best_moves.end();
+}
+
+std::string EscapeJson(std::string_view input) {
+  std::string output;
+  for (char c : input) {
+    if (c == '"' || c == '\\') {
+      output.push_back('\\');
+      output.push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      std::format_to(std::back_inserter(output), "\\u{:04x}", c);
+    } else {
+      output.push_back(c);
+    }
+  }
+  return output;
+}
+
+std::string FormatOptional(std::optional<std::int64_t> value,
+                           std::string_view missing) {
+  return value ? std::format("{}", *value) : std::string(missing);
+}
+
+std::optional<std::int64_t> GetTimeToSolution(const EpdResult &result) {
+  if (!result.time_to_solution) {
+    return std::nullopt;
+  }
+  return result.time_to_solution->count();
+}
+
+}  // namespace
+
+std::expected<EpdRecord, std::string> ParseEpd(std::string_view line) {
+  // The first four fields are those of a FEN string, without the move
+  // counters.
+  std::vector<std::string_view> fen_parts;
+  for (int i = 0; i < 4; ++i) {
+    fen_parts.push_back(NextToken(line));
+  }
+  fen_parts.push_back("0");
+  fen_parts.push_back("1");
+
+  auto position = Position::FromFen(fen_parts);
+  if (!position) {
+    return std::unexpected(position.error());
+  }
+
+  EpdRecord record{.position = *position};
+  while (!line.empty()) {
+    std::string_view operands = NextOperation(line);
+    const std::string_view opcode = NextToken(operands);
+    if (opcode == "id") {
+      record.id = NextToken(operands);
+    } else if (opcode == "bm" || opcode == "am") {
+      auto moves = ParseMoves(record.position, operands);
+      if (!moves) {
+        return std::unexpected(moves.error());
+      }
+      (opcode == "bm" ? record.best_moves : record.avoid_moves) = *moves;
+    }
+  }
+
+  if (record.best_moves.empty() && record.avoid_moves.empty()) {
+    return std::unexpected("EPD record has neither a bm nor an am opcode");
+  }
+  return record;
+}
+
+EpdResult SolveEpd(Searcher &searcher, const EpdRecord &record,
+                   const SearchOptions &options) {
+  EpdResult result{.id = record.id};
+
+  // The solution is the iteration after which the best move stopped changing
+  // to non-solving moves.
+  SearchOptions solve_options = options;
+  solve_options.SetOnIteration([&](const SearchResult &iteration) {
+    if (!IsSolution(record, iteration.best_move)) {
+      result.time_to_solution.reset();
+      result.nodes_to_solution.reset();
+    } else if (!result.time_to_solution) {
+      result.time_to_solution = iteration.elapsed;
+      result.nodes_to_solution = iteration.stats.GetNodes();
+    }
+  });
+
+  searcher.Clear();
+  const SearchResult search_result =
+      searcher.Search(Game(record.position), solve_options);
+
+  result.solved = IsSolution(record, search_result.best_move);
+  if (!result.solved) {
+    result.time_to_solution.reset();
+    result.nodes_to_solution.reset();
+  }
+  result.best_move = search_result.best_move;
+  result.score = search_result.score;
+  result.depth = search_result.depth;
+  result.nodes = search_result.stats.GetNodes();
+  result.elapsed = search_result.elapsed;
+  return result;
+}
+
+std::expected<std::vector<EpdResult>, std::string> RunEpdSuite(
+    std::istream &input, const EpdOptions &options) {
+  std::mutex mutex;
+  std::size_t line_number = 0;
+  std::optional<std::string> error;
+  std::vector<EpdResult> results;
+
+  // Returns the next record and its line number, or nothing once the input is
+  // exhausted or a line failed to parse.
+  using NumberedRecord = std::pair<std::size_t, EpdRecord>;
+  auto next_record = [&]() -> std::optional<NumberedRecord> {
+    std::lock_guard lock(mutex);
+    std::string line;
+    while (!error && std::getline(input, line)) {
+      ++line_number;
+      const std::size_t start = line.find_first_not_of(" \t\r");
+      if (start == std::string::npos || line[start] == '#') {
+        continue;
+      }
+      auto record = ParseEpd(line);
+      if (!record) {
+        error = std::format("Line {}: {}", line_number, record.error());
+        break;
+      }
+      return std::make_pair(line_number, *std::move(record));
+    }
+    return std::nullopt;
+  };
+
+  auto worker = [&] {
+    Searcher searcher(options.hash_size_mb);
+    while (auto next = next_record()) {
+      EpdResult result = SolveEpd(searcher, next->second, options.search);
+      result.line = next->first;
+
+      std::lock_guard lock(mutex);
+      results.push_back(std::move(result));
+    }
+  };
+
+  {
+    std::vector<std::jthread> threads;
+    for (int i = 1; i < options.threads; ++i) {
+      threads.emplace_back(worker);
+    }
+    worker();
+  }
+
+  if (error) {
+    return std::unexpected(*error);
+  }
+  std::ranges::sort(results, {}, &EpdResult::line);
+  return results;
+}
+
+std::string FormatCsv(std::span<const EpdResult> results) {
+  std::string output =
+      "line,id,solved,best_move,score,depth,nodes,time_ms,"
+      "time_to_solution_ms,nodes_to_solution\n";
+  for (const EpdResult &result : results) {
+    std::string id = result.id;
+    std::ranges::replace(id, '"', '\'');
+    std::format_to(std::back_inserter(output),
+                   "{},\"{}\",{},{},{},{},{},{},{},{}\n", result.line, id,
+                   result.solved, result.best_move, result.score, result.depth,
+                   result.nodes, result.elapsed.count(),
+                   FormatOptional(GetTimeToSolution(result), ""),
+                   FormatOptional(result.nodes_to_solution, ""));
+  }
+  return output;
+}
+
+std::string FormatJson(std::span<const EpdResult> results) {
+  const auto solved = std::ranges::count(results, true, &EpdResult::solved);
+  std::string output = std::format(
+      "{{\n  \"positions\": {},\n  \"solved\": {},\n  \"results\": [",
+      results.size(), solved);
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const EpdResult &result = results[i];
+    std::format_to(
+        std::back_inserter(output),
+        "{}\n    {{\"line\": {}, \"id\": \"{}\", \"solved\": {}, "
+        "\"best_move\": \"{}\", \"score\": {}, \"depth\": {}, \"nodes\": {}, "
+        "\"time_ms\": {}, \"time_to_solution_ms\": {}, "
+        "\"nodes_to_solution\": {}}}",
+        i == 0 ? "" : ",", result.line, EscapeJson(result.id), result.solved,
+        result.best_move, result.score, result.depth, result.nodes,
+        result.elapsed.count(),
+        FormatOptional(GetTimeToSolution(result), "null"),
+        FormatOptional(result.nodes_to_solution, "null"));
+  }
+  output += "\n  ]\n}\n";
+  return output;
+}
+
+}  // namespace follychess
@@ -0,0 +1,95 @@
+#ifndef FOLLYCHESS_TOOLS_EPD_H_
+#define FOLLYCHESS_TOOLS_EPD_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <istream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "engine/move.h"
+#include "engine/position.h"
+#include "search/search.h"
+#include "search/transposition.h"
+
+namespace follychess {
+
+// A test position in Extended Position Description (EPD) format, e.g.:
+//
+//   2rr3k/pp3pp1/1nnqbN1p/3pN3/2pP4/2P3Q1/PPB4P/R4RK1 w - - bm Qg6; id "WAC.001";
+//
+// Only the `bm` (best move), `am` (avoid move) and `id` opcodes are used; the
+// others are skipped.
+struct EpdRecord {
+  Position position;
+  std::string id;
+
+  // The moves that solve the position. If empty, any move solves it that is
+  // not one of the moves to avoid.
+  std::vector<Move> best_moves;
+  std::vector<Move> avoid_moves;
+};
+
+// Parses one line of an EPD file. The moves of the `bm` and `am` opcodes are
+// in Standard Algebraic Notation.
+std::expected<EpdRecord, std::string> ParseEpd(std::string_view line);
+
+struct EpdResult {
+  // The line of the position in the EPD file, starting at 1.
+  std::size_t line = 0;
+  std::string id;
+
+  bool solved = false;
+  Move best_move;
+  int score = 0;
+  int depth = 0;
+  std::int64_t nodes = 0;
+  std::chrono::milliseconds elapsed{0};
+
+  // If solved, the time and node count at the end of the iteration from which
+  // on the search kept a solving move as its best move.
+  std::optional<std::chrono::milliseconds> time_to_solution;
+  std::optional<std::int64_t> nodes_to_solution;
+};
+
+struct EpdOptions {
+  // The number of positions that are solved concurrently. Each worker has its
+  // own searcher, and each position is searched by a single thread.
+  int threads = 1;
+
+  // The size of the transposition table of each worker, in megabytes.
+  std::size_t hash_size_mb = TranspositionTable::kDefaultSizeMb;
+
+  // The limits of the search of each position, e.g., a move time or a node
+  // count.
+  SearchOptions search = SearchOptions().SetDepth(kMaxSearchDepth);
+};
+
+// Searches `record`'s position with a cleared `searcher`.
+EpdResult SolveEpd(Searcher &searcher, const EpdRecord &record,
+                   const SearchOptions &options);
+
+// Solves the positions read from `input`, which is streamed: each worker reads
+// the next line when it is done with its position. Empty lines and lines that
+// start with '#' are skipped.
+//
+// Returns the results in the order of the lines, or the first line that fails
+// to parse.
+std::expected<std::vector<EpdResult>, std::string> RunEpdSuite(
+    std::istream &input, const EpdOptions &options = EpdOptions());
+
+// Formats the results with a header row.
+std::string FormatCsv(std::span<const EpdResult> results);
+
+// Formats the results as a JSON object with the totals and one object per
+// position.
+std::string FormatJson(std::span<const EpdResult> results);
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_TOOLS_EPD_H_
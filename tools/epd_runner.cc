@@ -0,0 +1,65 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <print>
+#include <ranges>
+#include <string>
+#include <string_view>
+
+#include "tools/epd.h"
+
+// Usage: epd_runner <file> <movetime|nodes> <limit> [threads] [csv|json]
+//
+// Searches each position of the EPD file for `limit` milliseconds or nodes,
+// and prints the results to stdout. The number of solved positions is also
+// printed to stderr, so that it shows when the results are redirected.
+int main(int argc, char **argv) {
+  if (argc < 4) {
+    std::println(std::cerr,
+                 "Usage: {} <file> <movetime|nodes> <limit> [threads] "
+                 "[csv|json]",
+                 argv[0]);
+    return 1;
+  }
+
+  follychess::EpdOptions options;
+  const std::string_view limit_type = argv[2];
+  const long long limit = std::stoll(argv[3]);
+  if (limit_type == "movetime") {
+    options.search.SetMoveTime(std::chrono::milliseconds(limit));
+  } else if (limit_type == "nodes") {
+    options.search.SetNodes(limit);
+  } else {
+    std::println(std::cerr, "Invalid limit type: {}", limit_type);
+    return 1;
+  }
+  if (argc > 4) {
+    options.threads = std::stoi(argv[4]);
+  }
+  const std::string_view format = argc > 5 ? argv[5] : "csv";
+  if (format != "csv" && format != "json") {
+    std::println(std::cerr, "Invalid format: {}", format);
+    return 1;
+  }
+
+  std::ifstream input(argv[1]);
+  if (!input) {
+    std::println(std::cerr, "Unable to open file: {}", argv[1]);
+    return 1;
+  }
+
+  const auto results = follychess::RunEpdSuite(input, options);
+  if (!results) {
+    std::println(std::cerr, "{}", results.error());
+    return 1;
+  }
+
+  std::print("{}", format == "csv" ? follychess::FormatCsv(*results)
+                                   : follychess::FormatJson(*results));
+  std::println(std::cerr, "Solved {} of {} positions",
+               std::ranges::count(*results, true,
+                                  &follychess::EpdResult::solved),
+               results->size());
+  return 0;
+}
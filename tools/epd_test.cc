@@ -0,0 +1,170 @@
+#include "tools/epd.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <sstream>
+#include <vector>
+
+#include "engine/move.h"
+#include "engine/position.h"
+#include "search/search.h"
+
+namespace follychess {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::IsEmpty;
+using ::testing::Le;
+using ::testing::Optional;
+
+TEST(ParseEpd, BestMove) {
+  auto record = ParseEpd(
+      "2rr3k/pp3pp1/1nnqbN1p/3pN3/2pP4/2P3Q1/PPB4P/R4RK1 w - - bm Qg6; "
+      "id \"WAC.001\";");
+  ASSERT_TRUE(record.has_value()) << record.error();
+
+  EXPECT_THAT(
+      record->position,
+      Eq(Position::FromFen(
+             "2rr3k/pp3pp1/1nnqbN1p/3pN3/2pP4/2P3Q1/PPB4P/R4RK1 w - - 0 1")
+             .value()));
+  EXPECT_THAT(record->id, Eq("WAC.001"));
+  EXPECT_THAT(record->best_moves, ElementsAre(Move(G3, G6)));
+  EXPECT_THAT(record->avoid_moves, IsEmpty());
+}
+
+TEST(ParseEpd, AvoidMovesAndOtherOpcodes) {
+  auto record = ParseEpd(
+      "6k1/5ppp/8/8/8/8/8/R5K1 w - - hmvc 0; am Ra2 Ra3; c0 \"a; b\"; "
+      "id \"back rank\"");
+  ASSERT_TRUE(record.has_value()) << record.error();
+
+  EXPECT_THAT(record->id, Eq("back rank"));
+  EXPECT_THAT(record->best_moves, IsEmpty());
+  EXPECT_THAT(record->avoid_moves, ElementsAre(Move(A1, A2), Move(A1, A3)));
+}
+
+TEST(ParseEpd, Errors) {
+  EXPECT_FALSE(ParseEpd("4k3/8/8/8/8/8/8/4K3 x - - bm Ke2;").has_value());
+  EXPECT_THAT(
+      ParseEpd("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - bm e5;")
+          .error_or(""),
+      Eq("Illegal SAN move: e5"));
+  EXPECT_THAT(
+      ParseEpd("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - id \"x\";")
+          .error_or(""),
+      Eq("EPD record has neither a bm nor an am opcode"));
+}
+
+TEST(SolveEpd, Solved) {
+  auto record = ParseEpd("k7/8/1K6/8/8/8/7Q/8 w - - bm Qh8# Qb8+; id \"m1\";");
+  ASSERT_TRUE(record.has_value()) << record.error();
+
+  Searcher searcher;
+  const EpdResult result =
+      SolveEpd(searcher, *record, SearchOptions().SetDepth(3));
+  EXPECT_TRUE(result.solved);
+  EXPECT_THAT(result.id, Eq("m1"));
+  EXPECT_THAT(result.depth, Eq(3));
+  EXPECT_THAT(result.time_to_solution, Optional(Le(result.elapsed)));
+  EXPECT_THAT(result.nodes_to_solution, Optional(Le(result.nodes)));
+}
+
+TEST(SolveEpd, NotSolved) {
+  auto record =
+      ParseEpd("6k1/5ppp/8/8/8/8/8/R5K1 w - - am Ra8#; id \"avoid mate\";");
+  ASSERT_TRUE(record.has_value()) << record.error();
+
+  Searcher searcher;
+  const EpdResult result =
+      SolveEpd(searcher, *record, SearchOptions().SetDepth(3));
+  EXPECT_FALSE(result.solved);
+  EXPECT_THAT(result.best_move, Eq(Move(A1, A8)));
+  EXPECT_THAT(result.time_to_solution, Eq(std::nullopt));
+  EXPECT_THAT(result.nodes_to_solution, Eq(std::nullopt));
+}
+
+TEST(RunEpdSuite, SolvesInParallel) {
+  std::istringstream input(
+      "# Mates in one.\n"
+      "6k1/5ppp/8/8/8/8/8/R5K1 w - - bm Ra8#; id \"a\";\n"
+      "\n"
+      "k7/8/1K6/8/8/8/7Q/8 w - - bm Qh8#; id \"b\";\n"
+      "6k1/5ppp/8/8/8/8/8/R5K1 w - - am Ra2; id \"c\";\n"
+      "r6k/8/8/8/8/8/5PPP/6K1 b - - bm Ra1#; id \"d\";\n");
+  auto results = RunEpdSuite(input, {.threads = 3,
+                                     .search = SearchOptions().SetDepth(3)});
+  ASSERT_TRUE(results.has_value()) << results.error();
+
+  EXPECT_THAT(*results, ElementsAre(Field(&EpdResult::line, 2),
+                                    Field(&EpdResult::line, 4),
+                                    Field(&EpdResult::line, 5),
+                                    Field(&EpdResult::line, 6)));
+  for (const EpdResult &result : *results) {
+    EXPECT_TRUE(result.solved) << result.id;
+  }
+}
+
+TEST(RunEpdSuite, ParseError) {
+  std::istringstream input(
+      "6k1/5ppp/8/8/8/8/8/R5K1 w - - bm Ra8#; id \"a\";\n"
+      "6k1/5ppp/8/8/8/8/8/R5K1 w - - bm Rb8; id \"b\";\n");
+  EXPECT_THAT(RunEpdSuite(input, {.search = SearchOptions().SetDepth(1)})
+                  .error_or(""),
+              Eq("Line 2: Illegal SAN move: Rb8"));
+}
+
+TEST(FormatResults, CsvAndJson) {
+  const std::vector<EpdResult> results = {
+      {
+          .line = 1,
+          .id = "WAC \"1\"",
+          .solved = true,
+          .best_move = Move(G3, G6),
+          .score = 300,
+          .depth = 7,
+          .nodes = 1000,
+          .elapsed = std::chrono::milliseconds(20),
+          .time_to_solution = std::chrono::milliseconds(5),
+          .nodes_to_solution = 200,
+      },
+      {
+          .line = 3,
+          .id = "WAC.002",
+          .best_move = Move(E2, E4),
+          .score = -15,
+          .depth = 6,
+          .nodes = 2000,
+          .elapsed = std::chrono::milliseconds(30),
+      },
+  };
+
+  EXPECT_THAT(FormatCsv(results),
+              Eq("line,id,solved,best_move,score,depth,nodes,time_ms,"
+                 "time_to_solution_ms,nodes_to_solution\n"
+                 "1,\"WAC '1'\",true,g3g6,300,7,1000,20,5,200\n"
+                 "3,\"WAC.002\",false,e2e4,-15,6,2000,30,,\n"));
+  EXPECT_THAT(
+      FormatJson(results),
+      Eq("{\n"
+         "  \"positions\": 2,\n"
+         "  \"solved\": 1,\n"
+         "  \"results\": [\n"
+         "    {\"line\": 1, \"id\": \"WAC \\\"1\\\"\", \"solved\": true, "
+         "\"best_move\": \"g3g6\", \"score\": 300, \"depth\": 7, "
+         "\"nodes\": 1000, \"time_ms\": 20, \"time_to_solution_ms\": 5, "
+         "\"nodes_to_solution\": 200},\n"
+         "    {\"line\": 3, \"id\": \"WAC.002\", \"solved\": false, "
+         "\"best_move\": \"e2e4\", \"score\": -15, \"depth\": 6, "
+         "\"nodes\": 2000, \"time_ms\": 30, \"time_to_solution_ms\": null, "
+         "\"nodes_to_solution\": null}\n"
+         "  ]\n"
+         "}\n"));
+}
+
+}  // namespace
+}  // namespace follychess
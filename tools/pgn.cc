@@ -0,0 +1,306 @@
+#include "tools/pgn.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <expected>
+#include <format>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "engine/move.h"
+#include "engine/position.h"
+#include "engine/san.h"
+#include "search/mapped_file.h"
+
+namespace follychess {
+namespace {
+
+bool IsSpace(char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// Returns true for the characters that end a movetext token.
+bool IsDelimiter(char c) {
+  return IsSpace(c) || c == '{' || c == '}' || c == '(' || c == ')' ||
+         c == '[' || c == ';' || c == '$';
+}
+
+bool IsResult(std::string_view token) {
+  return token == "1-0" || token == "0-1" || token == "1/2-1/2" ||
+         token == "*";
+}
+
+// Returns the offset just past the end of the line at `offset`.
+std::size_t SkipLine(std::string_view text, std::size_t offset) {
+  const std::size_t end = text.find('\n', offset);
+  return end == std::string_view::npos ? text.size() : end + 1;
+}
+
+// Returns the offset just past the comment that starts at `offset`.
+std::size_t SkipComment(std::string_view text, std::size_t offset) {
+  if (text[offset] == ';') {
+    return SkipLine(text, offset);
+  }
+  const std::size_t end = text.find('}', offset);
+  return end == std::string_view::npos ? text.size() : end + 1;
+}
+
+// Returns the offset just past the variation that starts at `offset`,
+// including any variations and comments nested in it.
+std::size_t SkipVariation(std::string_view text, std::size_t offset) {
+  int depth = 0;
+  while (offset < text.size()) {
+    const char c = text[offset];
+    if (c == '{' || c == ';') {
+      offset = SkipComment(text, offset);
+      continue;
+    }
+    ++offset;
+    if (c == '(') {
+      ++depth;
+    } else if (c == ')' && --depth == 0) {
+      break;
+    }
+  }
+  return offset;
+}
+
+// Removes the move number, e.g., "12." or "12...", from the front of `token`.
+std::string_view StripMoveNumber(std::string_view token) {
+  const std::size_t digits = token.find_first_not_of("0123456789");
+  if (digits == 0 || digits == std::string_view::npos ||
+      token[digits] != '.') {
+    return token;
+  }
+  const std::size_t end = token.find_first_not_of('.', digits);
+  return end == std::string_view::npos ? std::string_view()
+                                       : token.substr(end);
+}
+
+// Returns true if a tag section starts at `offset` and only whitespace
+// precedes it on its line and the line before, as at the start of a game.
+bool IsGameStart(std::string_view text, std::size_t offset) {
+  int newlines = 0;
+  while (offset > 0 && newlines < 2) {
+    const char c = text[--offset];
+    if (c == '\n') {
+      ++newlines;
+    } else if (!IsSpace(c)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+std::optional<std::string_view> PgnGame::GetTag(std::string_view name) const {
+  for (const PgnTag &tag : tags) {
+    if (tag.name == name) {
+      return tag.value;
+    }
+  }
+  return std::nullopt;
+}
+
+std::expected<bool, std::string> PgnReader::ReadGame(PgnGame &game) {
+  game.tags.clear();
+  game.moves.clear();
+  game.result = {};
+  game.start = Position::Starting();
+
+  const auto skip_space = [&] {
+    while (offset_ < text_.size() && IsSpace(text_[offset_])) {
+      ++offset_;
+    }
+  };
+
+  skip_space();
+  if (offset_ == text_.size()) {
+    return false;
+  }
+  game_offset_ = offset_;
+
+  std::optional<std::string> error;
+  while (offset_ < text_.size() && text_[offset_] == '[') {
+    const std::size_t end = SkipLine(text_, offset_);
+    const std::string_view line = text_.substr(offset_, end - offset_);
+    offset_ = end;
+    skip_space();
+
+    const std::size_t name_end = line.find_first_of(" \"", 1);
+    const std::size_t value_start = line.find('"');
+    const std::size_t value_end = line.rfind('"');
+    if (name_end == std::string_view::npos || value_start == value_end) {
+      error = std::format("Invalid tag: {}", line);
+      continue;
+    }
+    game.tags.push_back({
+        .name = line.substr(1, name_end - 1),
+        .value = line.substr(value_start + 1, value_end - value_start - 1),
+    });
+  }
+
+  if (std::optional<std::string_view> fen = game.GetTag("FEN");
+      fen && !error) {
+    auto start = Position::FromFen(*fen);
+    if (start) {
+      game.start = *start;
+    } else {
+      error = start.error();
+    }
+  }
+
+  Position position = game.start;
+  while (true) {
+    skip_space();
+    if (offset_ == text_.size()) {
+      break;
+    }
+
+    const char c = text_[offset_];
+    if (c == '[') {
+      // The next game starts, and this one lacks a termination marker.
+      break;
+    }
+    if (c == '{' || c == ';') {
+      offset_ = SkipComment(text_, offset_);
+      continue;
+    }
+    if (c == '%' && (offset_ == 0 || text_[offset_ - 1] == '\n')) {
+      offset_ = SkipLine(text_, offset_);
+      continue;
+    }
+    if (c == '(') {
+      offset_ = SkipVariation(text_, offset_);
+      continue;
+    }
+    if (c == ')' || c == '}') {
+      ++offset_;
+      continue;
+    }
+
+    // A NAG is a dollar sign followed by digits, and is delimited like a move.
+    std::size_t end = offset_ + 1;
+    while (end < text_.size() && !IsDelimiter(text_[end])) {
+      ++end;
+    }
+    const std::string_view token = text_.substr(offset_, end - offset_);
+    offset_ = end;
+    if (c == '$') {
+      continue;
+    }
+    if (IsResult(token)) {
+      game.result = token;
+      break;
+    }
+
+    const std::string_view san = StripMoveNumber(token);
+    if (san.empty() || error) {
+      continue;
+    }
+    auto move = ParseSan(position, san);
+    if (!move) {
+      error = move.error();
+      continue;
+    }
+    position.Do(*move);
+    game.moves.push_back(*move);
+  }
+
+  if (error) {
+    return std::unexpected(*error);
+  }
+  return true;
+}
+
+std::vector<std::string_view> SplitPgn(std::string_view text,
+                                       std::size_t count) {
+  std::vector<std::string_view> chunks;
+  std::size_t begin = 0;
+  for (std::size_t i = 1; i <= count && begin < text.size(); ++i) {
+    std::size_t end = std::max(begin + 1, text.size() * i / count);
+    while (end < text.size() &&
+           (text[end] != '[' || !IsGameStart(text, end))) {
+      end = text.find("\n[", end);
+      end = end == std::string_view::npos ? text.size() : end + 1;
+    }
+    chunks.push_back(text.substr(begin, end - begin));
+    begin = end;
+  }
+  return chunks;
+}
+
+PgnStats ReadPgnGames(std::string_view text, int threads,
+                      const std::function<void(const PgnGame &)> &visitor) {
+  const std::vector<std::string_view> chunks =
+      SplitPgn(text, std::max(threads, 1));
+
+  std::mutex mutex;
+  PgnStats total;
+  const auto worker = [&](std::string_view chunk) {
+    PgnStats stats;
+    PgnReader reader(chunk);
+    PgnGame game;
+    while (true) {
+      const std::expected<bool, std::string> read = reader.ReadGame(game);
+      if (!read) {
+        ++stats.errors;
+        if (stats.error.empty()) {
+          stats.error = std::format(
+              "Offset {}: {}",
+              chunk.data() - text.data() + reader.GetGameOffset(),
+              read.error());
+        }
+        continue;
+      }
+      if (!*read) {
+        break;
+      }
+      ++stats.games;
+      stats.plies += static_cast<std::int64_t>(game.moves.size());
+      if (visitor) {
+        visitor(game);
+      }
+    }
+
+    std::lock_guard lock(mutex);
+    total.games += stats.games;
+    total.plies += stats.plies;
+    total.errors += stats.errors;
+    if (total.error.empty()) {
+      total.error = std::move(stats.error);
+    }
+  };
+
+  {
+    std::vector<std::jthread> workers;
+    for (std::size_t i = 1; i < chunks.size(); ++i) {
+      workers.emplace_back(worker, chunks[i]);
+    }
+    if (!chunks.empty()) {
+      worker(chunks.front());
+    }
+  }
+  return total;
+}
+
+std::expected<PgnStats, std::string> ReadPgnFile(
+    const std::string &path, int threads,
+    const std::function<void(const PgnGame &)> &visitor) {
+  auto file = MappedFile::Open(path);
+  if (!file) {
+    return std::unexpected(file.error());
+  }
+  const std::string_view text(
+      reinterpret_cast<const char *>(file->GetData().data()), file->GetSize());
+  return ReadPgnGames(text, threads, visitor);
+}
+
+}  // namespace follychess
@@ -0,0 +1,93 @@
+#ifndef FOLLYCHESS_TOOLS_PGN_H_
+#define FOLLYCHESS_TOOLS_PGN_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "engine/move.h"
+#include "engine/position.h"
+
+namespace follychess {
+
+// A tag pair, such as [White "Carlsen, Magnus"]. The views point into the PGN
+// text, and escaped characters in the value are left as they are.
+struct PgnTag {
+  std::string_view name;
+  std::string_view value;
+};
+
+// A game of the main line of a PGN file. Comments, variations and numeric
+// annotation glyphs (NAGs) are skipped.
+struct PgnGame {
+  std::vector<PgnTag> tags;
+
+  // The position set by the FEN tag, or the starting position.
+  Position start = Position::Starting();
+  std::vector<Move> moves;
+
+  // The game termination marker, e.g., "1-0" or "*". It is empty if the
+  // movetext lacks one.
+  std::string_view result;
+
+  // Returns the value of the tag called `name`, if any.
+  [[nodiscard]] std::optional<std::string_view> GetTag(
+      std::string_view name) const;
+};
+
+// Reads the games of a PGN text one at a time, without copying the text.
+class PgnReader {
+ public:
+  explicit PgnReader(std::string_view text) : text_(text) {}
+
+  // Reads the next game into `game`, reusing its storage. Returns false once
+  // there are no more games.
+  //
+  // Returns an error if the game is malformed or has an illegal move. The
+  // reader then continues with the next game.
+  std::expected<bool, std::string> ReadGame(PgnGame &game);
+
+  // Returns the offset in the text of the game that was read last.
+  [[nodiscard]] std::size_t GetGameOffset() const { return game_offset_; }
+
+ private:
+  std::string_view text_;
+  std::size_t offset_ = 0;
+  std::size_t game_offset_ = 0;
+};
+
+// Splits `text` at game boundaries into at most `count` chunks of about the
+// same size.
+std::vector<std::string_view> SplitPgn(std::string_view text,
+                                       std::size_t count);
+
+struct PgnStats {
+  std::int64_t games = 0;
+  std::int64_t plies = 0;
+
+  // The number of games that failed to read, and the error of one of them.
+  std::int64_t errors = 0;
+  std::string error;
+};
+
+// Reads the games of `text` on `threads` threads, each reading its own chunk
+// of whole games. `visitor`, if set, is called with every game that was read,
+// from the thread that read it.
+PgnStats ReadPgnGames(
+    std::string_view text, int threads,
+    const std::function<void(const PgnGame &)> &visitor = nullptr);
+
+// Like ReadPgnGames(), for a file that is memory-mapped rather than read.
+// Returns an error if the file cannot be mapped.
+std::expected<PgnStats, std::string> ReadPgnFile(
+    const std::string &path, int threads,
+    const std::function<void(const PgnGame &)> &visitor = nullptr);
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_TOOLS_PGN_H_
@@ -0,0 +1,170 @@
+#include "tools/pgn.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <format>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "engine/move.h"
+#include "engine/position.h"
+
+namespace follychess {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::FieldsAre;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::Le;
+using ::testing::Not;
+using ::testing::Optional;
+using ::testing::SizeIs;
+
+constexpr std::string_view kGames =
+    "[Event \"Casual game\"]\n"
+    "[White \"Anderssen\"]\n"
+    "[Black \"Kieseritzky\"]\n"
+    "[Result \"1-0\"]\n"
+    "\n"
+    "1. e4 {The King's Gambit.} e5 2. f4 exf4 3. Bc4 Qh4+ $6 4. Kf1 b5!?\n"
+    "(4... Nf6 5. Nc3 (5. e5 d5) c6) ; Bryan's Counter-Gambit.\n"
+    "5.Bxb5 1-0\n"
+    "\n"
+    "[Event \"Endgame\"]\n"
+    "[SetUp \"1\"]\n"
+    "[FEN \"4k3/8/8/8/8/8/4P3/4K3 w - - 0 1\"]\n"
+    "\n"
+    "1. e4 Kd7 2. e5 Ke6 *\n";
+
+TEST(PgnReader, ReadsGames) {
+  PgnReader reader(kGames);
+  PgnGame game;
+
+  ASSERT_THAT(reader.ReadGame(game), Optional(true));
+  EXPECT_THAT(game.tags,
+              ElementsAre(FieldsAre("Event", "Casual game"),
+                          FieldsAre("White", "Anderssen"),
+                          FieldsAre("Black", "Kieseritzky"),
+                          FieldsAre("Result", "1-0")));
+  EXPECT_THAT(game.GetTag("White"), Optional(Eq("Anderssen")));
+  EXPECT_THAT(game.GetTag("Site"), Eq(std::nullopt));
+  EXPECT_THAT(game.start, Eq(Position::Starting()));
+  EXPECT_THAT(game.moves,
+              ElementsAre(Move(E2, E4, Move::kDoublePawnPush),
+                          Move(E7, E5, Move::kDoublePawnPush),
+                          Move(F2, F4, Move::kDoublePawnPush),
+                          Move(E5, F4, Move::kCapture), Move(F1, C4),
+                          Move(D8, H4), Move(E1, F1),
+                          Move(B7, B5, Move::kDoublePawnPush),
+                          Move(C4, B5, Move::kCapture)));
+  EXPECT_THAT(game.result, Eq("1-0"));
+  EXPECT_THAT(reader.GetGameOffset(), Eq(0));
+
+  ASSERT_THAT(reader.ReadGame(game), Optional(true));
+  EXPECT_THAT(game.tags, SizeIs(3));
+  EXPECT_THAT(game.start,
+              Eq(Position::FromFen("4k3/8/8/8/8/8/4P3/4K3 w - - 0 1").value()));
+  EXPECT_THAT(game.moves, ElementsAre(Move(E2, E4, Move::kDoublePawnPush),
+                                      Move(E8, D7), Move(E4, E5),
+                                      Move(D7, E6)));
+  EXPECT_THAT(game.result, Eq("*"));
+  EXPECT_THAT(reader.GetGameOffset(), Eq(kGames.find("[Event \"Endgame")));
+
+  EXPECT_THAT(reader.ReadGame(game), Optional(false));
+  EXPECT_THAT(reader.ReadGame(game), Optional(false));
+}
+
+TEST(PgnReader, MissingTagsAndResult) {
+  PgnReader reader("1. d4 d5\n\n[Event \"Next\"]\n\n1. c4 1/2-1/2\n");
+  PgnGame game;
+
+  ASSERT_THAT(reader.ReadGame(game), Optional(true));
+  EXPECT_THAT(game.tags, IsEmpty());
+  EXPECT_THAT(game.moves, SizeIs(2));
+  EXPECT_THAT(game.result, IsEmpty());
+
+  ASSERT_THAT(reader.ReadGame(game), Optional(true));
+  EXPECT_THAT(game.moves, ElementsAre(Move(C2, C4, Move::kDoublePawnPush)));
+  EXPECT_THAT(game.result, Eq("1/2-1/2"));
+}
+
+TEST(PgnReader, ContinuesAfterErrors) {
+  PgnReader reader(
+      "[Event \"Illegal\"]\n\n1. e4 e4 2. d4 0-1\n\n"
+      "[Event \"Bad FEN\"]\n"
+      "[FEN \"4k3/8/8/8/8/8/8/4K3 x - - 0 1\"]\n\n1. e4 *\n\n"
+      "[Event \"Legal\"]\n\n1. Nf3 *\n");
+  PgnGame game;
+
+  EXPECT_THAT(reader.ReadGame(game).error_or(""),
+              Eq("Illegal SAN move: e4"));
+  EXPECT_THAT(reader.ReadGame(game).error_or(""), Not(IsEmpty()));
+  ASSERT_THAT(reader.ReadGame(game), Optional(true));
+  EXPECT_THAT(game.GetTag("Event"), Optional(Eq("Legal")));
+  EXPECT_THAT(game.moves, ElementsAre(Move(G1, F3)));
+}
+
+TEST(SplitPgn, SplitsAtGameBoundaries) {
+  std::string text;
+  for (int i = 0; i < 10; ++i) {
+    text += std::format("[Event \"{}\"]\n[Round \"{}\"]\n\n1. e4 e5 *\n\n", i,
+                        i);
+  }
+
+  for (std::size_t count : {1, 2, 3, 7, 10, 50}) {
+    const std::vector<std::string_view> chunks = SplitPgn(text, count);
+    EXPECT_THAT(chunks.size(), Le(count));
+
+    std::string joined;
+    for (std::string_view chunk : chunks) {
+      EXPECT_TRUE(chunk.starts_with("[Event")) << chunk;
+      joined += chunk;
+    }
+    EXPECT_THAT(joined, Eq(text));
+  }
+}
+
+TEST(ReadPgnGames, CountsGamesAndPlies) {
+  std::string text;
+  for (int i = 0; i < 100; ++i) {
+    text += kGames;
+    text += "\n";
+  }
+  text += "[Event \"Illegal\"]\n\n1. e5 *\n";
+
+  std::atomic<int> visited = 0;
+  for (int threads : {1, 4}) {
+    visited = 0;
+    const PgnStats stats =
+        ReadPgnGames(text, threads, [&](const PgnGame &) { ++visited; });
+    EXPECT_THAT(stats.games, Eq(200));
+    EXPECT_THAT(stats.plies, Eq(100 * (9 + 4)));
+    EXPECT_THAT(stats.errors, Eq(1));
+    EXPECT_THAT(stats.error,
+                Eq(std::format("Offset {}: Illegal SAN move: e5",
+                               text.find("[Event \"Illegal"))));
+    EXPECT_THAT(visited.load(), Eq(200));
+  }
+}
+
+TEST(ReadPgnFile, MapsFile) {
+  const std::string path = testing::TempDir() + "pgn_test.pgn";
+  std::ofstream(path) << kGames;
+
+  auto stats = ReadPgnFile(path, 2);
+  ASSERT_TRUE(stats.has_value()) << stats.error();
+  EXPECT_THAT(stats->games, Eq(2));
+  EXPECT_THAT(stats->plies, Eq(13));
+
+  EXPECT_THAT(ReadPgnFile("/does/not/exist", 1).error_or(""),
+              HasSubstr("Unable to open file: "));
+}
+
+}  // namespace
+}  // namespace follychess